@@ -0,0 +1,111 @@
+#include "audio/AudioOutput.h"
+#include "audio/ClipAudio.h"
+#include "utils/Clock.h"
+#include <SDL.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+AudioOutput::AudioOutput()
+    : device(0), sampleRate(kSampleRate), bufferFrames(kBufferFrames), latencyNs(0), callbacks(0), clipsPlayed(0),
+      totalUnderruns(0), totalResyncs(0), maxOffsetUs(0) {
+}
+
+AudioOutput::~AudioOutput() {
+    close();
+}
+
+bool AudioOutput::open(const std::string& driver, double offsetMs) {
+    if (!ClipAudio::isAvailable()) {
+        std::cout << "⚠️  Built without libav: clip audio is off" << std::endl;
+        return false;
+    }
+    if (!driver.empty()) {
+        setenv("SDL_AUDIODRIVER", driver.c_str(), 1);
+    }
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) != 0) {
+        std::cerr << "❌ Cannot start SDL audio: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    SDL_AudioSpec want{};
+    want.freq = kSampleRate;
+    want.format = AUDIO_F32SYS;
+    want.channels = kChannels;
+    want.samples = kBufferFrames;
+    want.callback = &AudioOutput::callback;
+    want.userdata = this;
+
+    // SDL converts the format if it must; rate and buffer size we follow
+    SDL_AudioSpec have{};
+    device = SDL_OpenAudioDevice(nullptr, 0, &want, &have,
+                                 SDL_AUDIO_ALLOW_FREQUENCY_CHANGE | SDL_AUDIO_ALLOW_SAMPLES_CHANGE);
+    if (device == 0) {
+        std::cerr << "❌ Cannot open audio device: " << SDL_GetError() << std::endl;
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        return false;
+    }
+    sampleRate = have.freq;
+    bufferFrames = have.samples;
+
+    // The buffer being filled plays once the one in the device has
+    latencyNs = static_cast<int64_t>(2.0 * bufferFrames * 1e9 / sampleRate + offsetMs * 1e6);
+
+    SDL_PauseAudioDevice(device, 0);
+    std::cout << "🔊 Audio: " << SDL_GetCurrentAudioDriver() << ", " << sampleRate << " Hz, " << bufferFrames
+              << "-frame buffers (" << latencyNs / 1e6 << " ms to the speaker)" << std::endl;
+    return true;
+}
+
+void AudioOutput::close() {
+    if (device == 0) return;
+    SDL_CloseAudioDevice(device);
+    device = 0;
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+}
+
+void AudioOutput::add(ClipAudio* source) {
+    if (device == 0 || !source) return;
+    SDL_LockAudioDevice(device);
+    sources.push_back(source);
+    SDL_UnlockAudioDevice(device);
+}
+
+void AudioOutput::remove(ClipAudio* source) {
+    if (device == 0 || !source) return;
+    SDL_LockAudioDevice(device); // Waits out a callback in progress
+    auto it = std::find(sources.begin(), sources.end(), source);
+    if (it != sources.end()) {
+        sources.erase(it);
+        clipsPlayed++;
+        totalUnderruns += source->getUnderruns();
+        totalResyncs += source->getResyncs();
+        maxOffsetUs = std::max(maxOffsetUs, source->getMaxOffsetUs());
+    }
+    SDL_UnlockAudioDevice(device);
+}
+
+void AudioOutput::callback(void* userData, uint8_t* stream, int bytes) {
+    auto* output = static_cast<AudioOutput*>(userData);
+    float* samples = reinterpret_cast<float*>(stream);
+    int frames = bytes / static_cast<int>(sizeof(float) * kChannels);
+    std::fill(samples, samples + frames * kChannels, 0.0f);
+
+    uint64_t hearNs = static_cast<uint64_t>(static_cast<int64_t>(monotonicNs()) + output->latencyNs);
+    for (ClipAudio* source : output->sources) {
+        source->render(samples, frames, hearNs);
+    }
+    if (output->sources.size() > 1) {
+        for (int i = 0; i < frames * kChannels; i++) {
+            samples[i] = std::clamp(samples[i], -1.0f, 1.0f);
+        }
+    }
+    output->callbacks.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AudioOutput::printStats() const {
+    if (callbacks.load() == 0) return;
+    std::cout << "🔊 Audio: " << callbacks.load() << " buffers, " << clipsPlayed << " clips, " << totalUnderruns
+              << " underruns, " << totalResyncs << " resyncs, max A/V offset " << maxOffsetUs / 1000.0 << " ms"
+              << std::endl;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ClipAudio;
+
+// Mixes the audio of playing clips into one SDL audio device opened with
+// small buffers. The device callback pulls from each clip's decoded ring
+// (see ClipAudio), which keeps itself in step with the clip's video.
+class AudioOutput {
+public:
+    static constexpr int kSampleRate = 48000;
+    static constexpr int kChannels = 2;
+    static constexpr int kBufferFrames = 256; // 5.3 ms at 48 kHz
+
+    AudioOutput();
+    ~AudioOutput();
+
+    // driver: SDL audio driver, empty = SDL's choice; "dummy" needs no sound
+    // card. offsetMs delays audio further, for displays with their own lag.
+    bool open(const std::string& driver, double offsetMs);
+    void close();
+    bool isOpen() const { return device != 0; }
+    int getSampleRate() const { return sampleRate; }
+
+    void add(ClipAudio* source);
+    void remove(ClipAudio* source); // The callback no longer uses it once this returns
+
+    void printStats() const;
+
+private:
+    uint32_t device; // SDL_AudioDeviceID
+    int sampleRate;
+    int bufferFrames;
+    int64_t latencyNs; // From the callback writing a sample to it being heard, plus the offset
+    std::vector<ClipAudio*> sources; // Changed only with the device locked
+
+    // Callbacks run; totals of clips that have finished
+    std::atomic<uint64_t> callbacks;
+    uint64_t clipsPlayed;
+    uint64_t totalUnderruns;
+    uint64_t totalResyncs;
+    uint32_t maxOffsetUs;
+
+    static void callback(void* userData, uint8_t* stream, int bytes);
+};
@@ -0,0 +1,380 @@
+#include "audio/ClipAudio.h"
+#include "video/VideoClip.h"
+#include "utils/Log.h"
+#include "utils/Realtime.h"
+#include "utils/Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+
+#if VJ_HAVE_LIBAV
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/channel_layout.h>
+#include <libswresample/swresample.h>
+}
+#endif
+
+namespace {
+constexpr double kNudgeSeconds = 0.030;     // Below this, drift is corrected by rate
+constexpr double kReseekSeconds = 0.250;    // Above this, the decoder reseeks
+constexpr double kMaxRateCorrection = 0.005;
+constexpr double kCorrectionGain = 0.5;     // Rate change per second of offset
+constexpr double kSeekLeadSeconds = 0.100;  // Reseeks land this far ahead, for the decode to catch up
+constexpr double kGapSeconds = 0.001;       // Timestamp jitter tolerated between decoded blocks
+constexpr int kMaxEmptyPasses = 7;          // Unreadable passes before the back-off reaches its cap
+}
+
+#if VJ_HAVE_LIBAV
+struct ClipAudio::Decoder {
+    AVFormatContext* format = nullptr;
+    AVCodecContext* codec = nullptr;
+    SwrContext* resampler = nullptr;
+    AVPacket* packet = nullptr;
+    AVFrame* frame = nullptr;
+    int stream = -1;
+    double timeBase = 0.0;
+    double fileStart = 0.0; // Media time 0: the first video frame, near enough
+
+    ~Decoder() {
+        av_frame_free(&frame);
+        av_packet_free(&packet);
+        swr_free(&resampler);
+        avcodec_free_context(&codec);
+        avformat_close_input(&format);
+    }
+
+    bool open(const std::string& path, int sampleRate) {
+        if (avformat_open_input(&format, path.c_str(), nullptr, nullptr) < 0) return false;
+        if (avformat_find_stream_info(format, nullptr) < 0) return false;
+
+        const AVCodec* audioCodec = nullptr;
+        stream = av_find_best_stream(format, AVMEDIA_TYPE_AUDIO, -1, -1, &audioCodec, 0);
+        if (stream < 0 || !audioCodec) return false;
+        for (unsigned i = 0; i < format->nb_streams; i++) {
+            if (static_cast<int>(i) != stream) format->streams[i]->discard = AVDISCARD_ALL;
+        }
+
+        codec = avcodec_alloc_context3(audioCodec);
+        if (!codec || avcodec_parameters_to_context(codec, format->streams[stream]->codecpar) < 0 ||
+            avcodec_open2(codec, audioCodec, nullptr) < 0) {
+            return false;
+        }
+        timeBase = av_q2d(format->streams[stream]->time_base);
+        if (format->start_time != AV_NOPTS_VALUE) {
+            fileStart = static_cast<double>(format->start_time) / AV_TIME_BASE;
+        }
+
+        AVChannelLayout stereo = AV_CHANNEL_LAYOUT_STEREO;
+        if (swr_alloc_set_opts2(&resampler, &stereo, AV_SAMPLE_FMT_FLT, sampleRate, &codec->ch_layout,
+                                codec->sample_fmt, codec->sample_rate, 0, nullptr) < 0 ||
+            swr_init(resampler) < 0) {
+            return false;
+        }
+        packet = av_packet_alloc();
+        frame = av_frame_alloc();
+        return packet && frame;
+    }
+
+    void seek(double seconds) {
+        auto timestamp = static_cast<int64_t>((seconds + fileStart) / timeBase);
+        av_seek_frame(format, stream, timestamp, AVSEEK_FLAG_BACKWARD);
+        avcodec_flush_buffers(codec);
+        swr_close(resampler); // Drop samples buffered from before the seek
+        swr_init(resampler);
+    }
+
+    double seconds(const AVFrame* decoded) const {
+        if (decoded->best_effort_timestamp == AV_NOPTS_VALUE) return -1.0;
+        return decoded->best_effort_timestamp * timeBase - fileStart;
+    }
+};
+#else
+struct ClipAudio::Decoder {};
+#endif
+
+ClipAudio::ClipAudio(const std::string& path, int sampleRate, ClipStats* stats)
+    : path(path), sampleRate(sampleRate), stats(stats), decoder(std::make_unique<Decoder>()), stopping(false),
+      muted(false), startSeconds(0.0), loopSeconds(0.0), ring(static_cast<size_t>(kRingFrames) * 2, 0.0f),
+      writeIndex(0), readIndex(0), seekGeneration(0), readyGeneration(0), seekTarget(0.0), readBase(0),
+      readBaseSeconds(0.0), readFraction(0.0), clockSequence(0), clockSeconds(0.0), clockNs(0),
+      clockRunning(false), underruns(0), resyncs(0), maxOffsetUs(0) {
+}
+
+ClipAudio::~ClipAudio() {
+    stopping = true;
+    if (decodeThread.joinable()) {
+        decodeThread.join();
+    }
+}
+
+bool ClipAudio::isAvailable() {
+    return VJ_HAVE_LIBAV != 0;
+}
+
+void ClipAudio::start(double start, double loop) {
+    startSeconds = start;
+    loopSeconds = loop;
+    seekTarget.store(start, std::memory_order_relaxed);
+    seekGeneration.store(1, std::memory_order_release);
+
+    decodeThread = std::thread([this]() {
+        VJ_TRACE_THREAD_NAME("audio " + std::filesystem::path(path).filename().string());
+        Realtime::applyToCurrentThread(ThreadRole::Decode);
+        decodeLoop();
+    });
+}
+
+void ClipAudio::setVideoClock(double mediaSeconds, uint64_t presentNs, bool running) {
+    uint32_t sequence = clockSequence.load(std::memory_order_relaxed);
+    clockSequence.store(sequence + 1, std::memory_order_relaxed); // Odd: being written
+    std::atomic_thread_fence(std::memory_order_release);
+    clockSeconds.store(mediaSeconds, std::memory_order_relaxed);
+    clockNs.store(presentNs, std::memory_order_relaxed);
+    clockRunning.store(running, std::memory_order_relaxed);
+    clockSequence.store(sequence + 2, std::memory_order_release);
+}
+
+bool ClipAudio::readClock(double& seconds, uint64_t& ns, bool& running) const {
+    for (int attempt = 0; attempt < 4; attempt++) {
+        uint32_t before = clockSequence.load(std::memory_order_acquire);
+        if (before & 1) continue;
+        seconds = clockSeconds.load(std::memory_order_relaxed);
+        ns = clockNs.load(std::memory_order_relaxed);
+        running = clockRunning.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (clockSequence.load(std::memory_order_relaxed) == before) return before != 0; // 0: no frame yet
+    }
+    return false; // Being written; this buffer stays silent
+}
+
+void ClipAudio::requestSeek(double mediaSeconds) {
+    seekTarget.store(mediaSeconds, std::memory_order_relaxed);
+    seekGeneration.fetch_add(1, std::memory_order_release);
+    resyncs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ClipAudio::render(float* out, int frames, uint64_t hearNs) {
+    if (muted.load(std::memory_order_relaxed)) return;
+    uint32_t generation = seekGeneration.load(std::memory_order_relaxed);
+    if (readyGeneration.load(std::memory_order_acquire) != generation) return; // Decoder still seeking
+
+    double clockAt;
+    uint64_t clockAtNs;
+    bool running;
+    if (!readClock(clockAt, clockAtNs, running) || !running) return;
+
+    // Where the video will be when this buffer is heard
+    double videoSeconds = clockAt + static_cast<int64_t>(hearNs - clockAtNs) / 1e9;
+    if (videoSeconds < startSeconds) return; // First frame not due yet
+
+    uint64_t read = readIndex.load(std::memory_order_relaxed);
+    uint64_t write = writeIndex.load(std::memory_order_acquire);
+    double audioSeconds = readBaseSeconds + (static_cast<double>(read - readBase) + readFraction) / sampleRate;
+    double offset = audioSeconds - videoSeconds; // > 0: audio ahead
+
+    if (std::fabs(offset) > kReseekSeconds) {
+        requestSeek(videoSeconds + kSeekLeadSeconds); // Counted as a resync, not as an offset
+        return;
+    }
+    auto offsetUs = static_cast<uint32_t>(std::fabs(offset) * 1e6);
+    if (offsetUs > maxOffsetUs.load(std::memory_order_relaxed)) {
+        maxOffsetUs.store(offsetUs, std::memory_order_relaxed);
+    }
+    if (stats) {
+        stats->avOffsetUs.store(static_cast<int32_t>(offset * 1e6), std::memory_order_relaxed);
+    }
+
+    int first = 0;
+    double step = 1.0;
+    if (offset < -kNudgeSeconds) {
+        // Behind: drop the samples that should already have played
+        uint64_t skip = std::min<uint64_t>(write - read, static_cast<uint64_t>(-offset * sampleRate));
+        read += skip;
+        readFraction = 0.0;
+    } else if (offset > kNudgeSeconds) {
+        first = std::min(frames, static_cast<int>(offset * sampleRate)); // Ahead: start later in this buffer
+    } else {
+        step = 1.0 - std::clamp(offset * kCorrectionGain, -kMaxRateCorrection, kMaxRateCorrection);
+    }
+
+    // Linear interpolation at a rate within 0.5% of 1:1
+    const uint64_t mask = kRingFrames - 1;
+    uint64_t available = write - read;
+    double phase = readFraction;
+    for (int i = first; i < frames; i++) {
+        auto whole = static_cast<uint64_t>(phase);
+        if (whole + 1 >= available) {
+            underruns.fetch_add(1, std::memory_order_relaxed);
+            if (stats) stats->audioUnderruns.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        float t = static_cast<float>(phase - whole);
+        const float* a = &ring[((read + whole) & mask) * 2];
+        const float* b = &ring[((read + whole + 1) & mask) * 2];
+        out[i * 2] += a[0] + (b[0] - a[0]) * t;
+        out[i * 2 + 1] += a[1] + (b[1] - a[1]) * t;
+        phase += step;
+    }
+    auto advance = static_cast<uint64_t>(phase);
+    readFraction = phase - advance;
+    readIndex.store(read + std::min(advance, available), std::memory_order_release);
+}
+
+bool ClipAudio::writeSamples(const float* samples, size_t frames, uint32_t generation) {
+    const uint64_t mask = kRingFrames - 1;
+    while (frames > 0) {
+        if (stopping || seekGeneration.load(std::memory_order_acquire) != generation) return false;
+
+        uint64_t write = writeIndex.load(std::memory_order_relaxed);
+        uint64_t room = kRingFrames - (write - readIndex.load(std::memory_order_acquire));
+        if (room == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2)); // A few callbacks' worth
+            continue;
+        }
+        size_t count = static_cast<size_t>(std::min<uint64_t>(room, frames));
+        for (size_t i = 0; i < count; i++) {
+            float* slot = &ring[((write + i) & mask) * 2];
+            slot[0] = samples ? samples[i * 2] : 0.0f; // Null: silence
+            slot[1] = samples ? samples[i * 2 + 1] : 0.0f;
+        }
+        writeIndex.store(write + count, std::memory_order_release);
+        if (samples) samples += count * 2;
+        frames -= count;
+
+        if (readyGeneration.load(std::memory_order_relaxed) != generation) {
+            readyGeneration.store(generation, std::memory_order_release); // The callback may read again
+        }
+    }
+    return true;
+}
+
+void ClipAudio::decodeLoop() {
+#if VJ_HAVE_LIBAV
+    if (!decoder->open(path, sampleRate)) {
+        VJ_LOG_INFO("🔇 No audio track: {}", path);
+        return;
+    }
+
+    std::vector<float> converted;
+    uint32_t generation = 0;
+    double loopBase = 0.0;     // Media time of the file's start in the current loop
+    double writeSeconds = 0.0; // Media time of the next sample into the ring
+    bool aligned = false;      // Sample-exact trim pending after a seek or loop
+    bool readSincePass = false; // A packet came from the file since the last seek or loop
+    int emptyPasses = 0;
+
+    // Audio loops with the video: a short track is padded with silence, a
+    // long one cut at the video's end
+    auto wrap = [&]() {
+        if (loopSeconds > 0) {
+            double end = loopBase + loopSeconds;
+            auto pad = static_cast<size_t>(std::max(0.0, std::round((end - writeSeconds) * sampleRate)));
+            if (pad > 0 && !writeSamples(nullptr, pad, generation)) return;
+            loopBase = end;
+        } else {
+            loopBase = writeSeconds;
+        }
+        writeSeconds = loopBase;
+        decoder->seek(0.0);
+        aligned = false;
+        readSincePass = false;
+    };
+
+    // Sleeps until stopping or the next seek request, up to `ms`
+    auto idle = [&](int ms) {
+        for (int waited = 0; waited < ms && !stopping; waited += 10) {
+            if (seekGeneration.load(std::memory_order_acquire) != generation) return;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    };
+
+    while (!stopping) {
+        uint32_t requested = seekGeneration.load(std::memory_order_acquire);
+        if (requested != generation) {
+            // The callback has stopped reading: reset the ring at the target
+            VJ_TRACE_SCOPE("audio seek");
+            generation = requested;
+            double target = seekTarget.load(std::memory_order_relaxed);
+            loopBase = loopSeconds > 0 ? std::floor(target / loopSeconds) * loopSeconds : 0.0;
+            decoder->seek(target - loopBase);
+            writeSeconds = target;
+            aligned = false;
+            readSincePass = false;
+            emptyPasses = 0;
+            uint64_t write = writeIndex.load(std::memory_order_relaxed);
+            readIndex.store(write, std::memory_order_relaxed);
+            readBase = write;
+            readBaseSeconds = target;
+            readFraction = 0.0;
+        }
+
+        if (av_read_frame(decoder->format, decoder->packet) < 0) {
+            // End of file, or a read error: start over rather than stop. A
+            // pass with nothing read (e.g. the drive was pulled) backs off,
+            // up to one retry a second
+            if (!readSincePass) {
+                if (++emptyPasses == kMaxEmptyPasses) {
+                    VJ_LOG_WARN("⚠ Audio file cannot be read, retrying once a second: {}", path);
+                }
+                idle(std::min(10 << std::min(emptyPasses, kMaxEmptyPasses), 1000));
+            }
+            wrap();
+            continue;
+        }
+        readSincePass = true;
+        emptyPasses = 0;
+        if (decoder->packet->stream_index != decoder->stream) {
+            av_packet_unref(decoder->packet);
+            continue;
+        }
+        int sent = avcodec_send_packet(decoder->codec, decoder->packet);
+        av_packet_unref(decoder->packet);
+        if (sent < 0) continue;
+
+        bool looped = false;
+        while (!looped && avcodec_receive_frame(decoder->codec, decoder->frame) == 0) {
+            AVFrame* frame = decoder->frame;
+            double frameSeconds = decoder->seconds(frame);
+            frameSeconds = frameSeconds < 0 ? writeSeconds : loopBase + frameSeconds;
+
+            int capacity = swr_get_out_samples(decoder->resampler, frame->nb_samples);
+            converted.resize(static_cast<size_t>(std::max(capacity, 0)) * 2);
+            uint8_t* output = reinterpret_cast<uint8_t*>(converted.data());
+            int count = swr_convert(decoder->resampler, &output, capacity,
+                                    const_cast<const uint8_t**>(frame->extended_data), frame->nb_samples);
+            av_frame_unref(frame);
+            if (count <= 0) continue;
+
+            // Line the block up with the ring: exactly after a seek, otherwise
+            // only when timestamps jump (gaps, overlaps)
+            double drift = frameSeconds - writeSeconds;
+            size_t skip = 0;
+            if (!aligned || std::fabs(drift) > kGapSeconds) {
+                auto frames = static_cast<int64_t>(std::round(drift * sampleRate));
+                if (frames > 0 && !writeSamples(nullptr, static_cast<size_t>(frames), generation)) break;
+                if (frames > 0) writeSeconds += static_cast<double>(frames) / sampleRate;
+                if (frames < 0) skip = static_cast<size_t>(std::min<int64_t>(-frames, count));
+                aligned = true;
+            }
+
+            size_t keep = static_cast<size_t>(count) - skip;
+            if (loopSeconds > 0) {
+                double left = std::max(0.0, loopBase + loopSeconds - writeSeconds);
+                size_t room = static_cast<size_t>(std::round(left * sampleRate));
+                if (keep >= room) {
+                    keep = room;
+                    looped = true;
+                }
+            }
+            if (keep > 0 && !writeSamples(converted.data() + skip * 2, keep, generation)) break;
+            writeSeconds += static_cast<double>(keep) / sampleRate;
+        }
+        if (looped) {
+            wrap();
+        }
+    }
+#endif
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct ClipStats;
+
+// The audio track of one playing clip. A decode thread (libavformat and
+// libavcodec, resampled to the output format) fills a ring of about half a
+// second, which the audio callback reads in step with the clip's video.
+//
+// Both sides count "media seconds" from the start of the file, carried on
+// through loops. The playback loop publishes which media time its video
+// shows and when; the callback compares that with the media time of the
+// samples it is about to have heard:
+//  - within 30 ms, the read rate is nudged by up to 0.5% until they meet;
+//  - within 250 ms, samples are skipped or silence is inserted;
+//  - further out (a cue, a scratch, the end of varispeed) the decoder reseeks.
+// The clip is silent until its first frame is due on screen, and while the
+// video is not playing forward at 1x.
+class ClipAudio {
+public:
+    static constexpr int kRingFrames = 32768; // ~0.7 s at 48 kHz, power of two
+
+    // Cheap: the file is opened by the decode thread, so a launch is not held up
+    ClipAudio(const std::string& path, int sampleRate, ClipStats* stats);
+    ~ClipAudio();
+
+    static bool isAvailable(); // Built with libav
+
+    // Playback thread. loopSeconds is the video's length, which the audio
+    // loops with (0 = the audio's own length).
+    void start(double startSeconds, double loopSeconds);
+    void setVideoClock(double mediaSeconds, uint64_t presentNs, bool running);
+    void mute() { muted.store(true, std::memory_order_relaxed); } // Any thread, e.g. on stop
+
+    // Audio callback: adds this clip's samples for a buffer heard at hearNs
+    void render(float* out, int frames, uint64_t hearNs);
+
+    uint64_t getUnderruns() const { return underruns.load(std::memory_order_relaxed); }
+    uint64_t getResyncs() const { return resyncs.load(std::memory_order_relaxed); }
+    uint32_t getMaxOffsetUs() const { return maxOffsetUs.load(std::memory_order_relaxed); }
+
+private:
+    struct Decoder; // libav state, decode thread only
+
+    std::string path;
+    int sampleRate;
+    ClipStats* stats;
+    std::unique_ptr<Decoder> decoder;
+    std::thread decodeThread;
+    std::atomic<bool> stopping;
+    std::atomic<bool> muted;
+    double startSeconds;
+    double loopSeconds;
+
+    // Interleaved stereo. Single producer (decoder), single consumer
+    // (callback). A seek is requested by the callback and bumps
+    // seekGeneration; the callback keeps out of the ring until the decoder
+    // has reset and refilled it and reports that generation ready.
+    std::vector<float> ring;
+    std::atomic<uint64_t> writeIndex;
+    std::atomic<uint64_t> readIndex;
+    std::atomic<uint32_t> seekGeneration;
+    std::atomic<uint32_t> readyGeneration;
+    std::atomic<double> seekTarget;
+    uint64_t readBase;      // Ring index at readBaseSeconds, set by the decoder on reset
+    double readBaseSeconds;
+    double readFraction;    // Callback only: interpolation phase
+
+    // Video clock, a seqlock written only by the playback thread
+    std::atomic<uint32_t> clockSequence;
+    std::atomic<double> clockSeconds;
+    std::atomic<uint64_t> clockNs;
+    std::atomic<bool> clockRunning;
+
+    std::atomic<uint64_t> underruns;
+    std::atomic<uint64_t> resyncs;
+    std::atomic<uint32_t> maxOffsetUs;
+
+    void decodeLoop();
+    void requestSeek(double mediaSeconds);
+    bool readClock(double& seconds, uint64_t& ns, bool& running) const;
+    bool writeSamples(const float* samples, size_t frames, uint32_t generation);
+};
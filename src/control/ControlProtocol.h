@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+
+// Binary datagrams accepted on the control socket (--control-socket).
+// Shared between vj-app and local senders (see tools/control_client.cpp).
+// One message per datagram, host byte order (the socket is local only).
+namespace vjctl {
+
+constexpr uint32_t kMagic = 0x564A4354; // "VJCT"
+
+enum MessageType : uint8_t {
+    kTrigger = 1,    // Note on: channel, number = note, value = velocity (0 = 127)
+    kRelease = 2,    // Note off: channel, number = note
+    kStop = 3,       // Stop all clips, like MIDI CC123
+    kControl = 4,    // Control change: channel, number = controller, value
+    kTempo = 5,      // tempoMilliBpm
+    kSubscribe = 6,  // Sender (bound to its own socket path) is told about every dispatched message
+    kDispatched = 7  // Sent to subscribers: channel = MIDI status, number/value = data bytes
+};
+
+struct Message {
+    uint32_t magic;
+    uint8_t type;
+    uint8_t channel;
+    uint8_t number;
+    uint8_t value;
+    uint32_t sequence;      // Sender's own counter, echoed nowhere; useful in logs and captures
+    uint32_t tempoMilliBpm;
+    uint64_t sentNs;        // CLOCK_MONOTONIC when sent, 0 = unknown (Dispatched: when dispatched)
+};
+
+static_assert(sizeof(Message) == 24, "Control messages are 24 bytes on the wire");
+
+} // namespace vjctl
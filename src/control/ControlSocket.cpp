@@ -0,0 +1,352 @@
+#include "control/ControlSocket.h"
+#include "midi/MidiHandler.h"
+#include "utils/Clock.h"
+#include "utils/Log.h"
+#include "utils/Realtime.h"
+#include "utils/Trace.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t kMaxSubscribers = 8;
+
+// OSC strings are NUL-terminated and padded to a multiple of four bytes
+bool readOscString(const uint8_t* data, size_t size, size_t& offset, std::string& text) {
+    const uint8_t* end = static_cast<const uint8_t*>(std::memchr(data + offset, 0, size - offset));
+    if (!end) return false;
+    text.assign(reinterpret_cast<const char*>(data + offset), end - (data + offset));
+    offset += (text.size() + 4) & ~size_t(3);
+    return offset <= size;
+}
+
+// OSC numbers are big-endian; int and float arguments are both accepted
+bool readOscNumber(const uint8_t* data, size_t size, size_t& offset, char tag, float& value) {
+    if (offset + 4 > size) return false;
+    uint32_t bits;
+    std::memcpy(&bits, data + offset, 4);
+    bits = ntohl(bits);
+    offset += 4;
+    if (tag == 'i') {
+        value = static_cast<float>(static_cast<int32_t>(bits));
+    } else if (tag == 'f') {
+        std::memcpy(&value, &bits, 4);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+int toDataByte(float value) {
+    return std::clamp(static_cast<int>(value), 0, 127);
+}
+
+} // namespace
+
+ControlSocket::ControlSocket()
+    : handler(nullptr), socketFd(-1), oscFd(-1), epollFd(-1), stopFd(-1), startNs(0), subscriberCount(0),
+      messages(0), oscMessages(0), malformed(0), dispatched(0), timedMessages(0), transportTotalNs(0), transportMaxNs(0),
+      dispatchTotalNs(0), dispatchMaxNs(0) {
+}
+
+ControlSocket::~ControlSocket() {
+    stop();
+}
+
+bool ControlSocket::start(MidiHandler* midiHandler, const std::string& path, int oscPort) {
+    stop();
+    handler = midiHandler;
+    startNs = monotonicNs();
+
+    if (!path.empty()) {
+        sockaddr_un address{};
+        if (path.size() >= sizeof(address.sun_path)) {
+            std::cerr << "Control socket path too long: " << path << std::endl;
+            return false;
+        }
+        socketFd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        unlink(path.c_str()); // Left behind by a previous run that did not exit cleanly
+        if (socketFd < 0 || bind(socketFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            std::cerr << "Cannot bind control socket " << path << ": " << std::strerror(errno) << std::endl;
+            closeSockets();
+            return false;
+        }
+        socketPath = path;
+    }
+
+    if (oscPort > 0) {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(oscPort));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // Local senders only
+        oscFd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (oscFd < 0 || bind(oscFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            std::cerr << "Cannot bind OSC port " << oscPort << ": " << std::strerror(errno) << std::endl;
+            closeSockets();
+            return false;
+        }
+    }
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || stopFd < 0) {
+        std::cerr << "Cannot create control input poller: " << std::strerror(errno) << std::endl;
+        closeSockets();
+        return false;
+    }
+    for (int fd : {socketFd, oscFd, stopFd}) {
+        if (fd < 0) continue;
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    handler->setDispatchObserver([this](const std::vector<unsigned char>& message) {
+        notifySubscribers(message);
+    });
+    inputThread = std::thread([this]() {
+        VJ_TRACE_THREAD_NAME("control");
+        Realtime::applyToCurrentThread(ThreadRole::Midi); // Same priority as hardware input
+        inputLoop();
+    });
+
+    if (socketFd >= 0) {
+        std::cout << "✓ Control socket " << socketPath << std::endl;
+    }
+    if (oscFd >= 0) {
+        std::cout << "✓ OSC input on 127.0.0.1:" << oscPort << std::endl;
+    }
+    return true;
+}
+
+void ControlSocket::stop() {
+    if (inputThread.joinable()) {
+        handler->setDispatchObserver(nullptr); // No MIDI thread sends on the socket after this
+        uint64_t one = 1;
+        ssize_t written = write(stopFd, &one, sizeof(one));
+        (void)written; // Only fails if the counter would overflow
+        inputThread.join();
+    }
+    closeSockets();
+}
+
+void ControlSocket::closeSockets() {
+    for (int* fd : {&socketFd, &oscFd, &epollFd, &stopFd}) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+    if (!socketPath.empty()) {
+        unlink(socketPath.c_str());
+        socketPath.clear();
+    }
+}
+
+void ControlSocket::inputLoop() {
+    epoll_event events[4];
+    alignas(8) uint8_t buffer[2048];
+
+    while (true) {
+        int count = epoll_wait(epollFd, events, 4, -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            VJ_LOG_ERROR("Control input stopped: {}", std::strerror(errno));
+            return;
+        }
+
+        for (int i = 0; i < count; i++) {
+            int fd = events[i].data.fd;
+            if (fd == stopFd) return;
+
+            // Level-triggered: drain what is queued now, epoll reports the rest
+            while (true) {
+                sockaddr_storage from;
+                socklen_t fromLength = sizeof(from);
+                ssize_t size = recvfrom(fd, buffer, sizeof(buffer), 0, reinterpret_cast<sockaddr*>(&from), &fromLength);
+                if (size < 0) break;
+                uint64_t receivedNs = monotonicNs();
+
+                VJ_TRACE_SCOPE("control receive");
+                if (fd == socketFd) {
+                    handleBinary(buffer, static_cast<size_t>(size), from, fromLength, receivedNs);
+                } else {
+                    handleOsc(buffer, static_cast<size_t>(size), receivedNs);
+                }
+            }
+        }
+    }
+}
+
+void ControlSocket::handleBinary(const uint8_t* data, size_t size, const sockaddr_storage& from, socklen_t fromLength,
+                                 uint64_t receivedNs) {
+    vjctl::Message message;
+    if (size != sizeof(message)) {
+        malformed++;
+        return;
+    }
+    std::memcpy(&message, data, sizeof(message));
+    if (message.magic != vjctl::kMagic) {
+        malformed++;
+        return;
+    }
+    messages++;
+
+    unsigned char channel = message.channel & 0x0F;
+    unsigned char number = message.number & 0x7F;
+    unsigned char value = message.value & 0x7F;
+    switch (message.type) {
+        case vjctl::kTrigger:
+            dispatch({static_cast<unsigned char>(0x90 | channel), number, static_cast<unsigned char>(value ? value : 127)}, message.sentNs, receivedNs);
+            break;
+        case vjctl::kRelease:
+            dispatch({static_cast<unsigned char>(0x80 | channel), number, 0}, message.sentNs, receivedNs);
+            break;
+        case vjctl::kStop:
+            dispatch({0xB0, 123, 0}, message.sentNs, receivedNs);
+            break;
+        case vjctl::kControl:
+            dispatch({static_cast<unsigned char>(0xB0 | channel), number, value}, message.sentNs, receivedNs);
+            break;
+        case vjctl::kTempo:
+            handler->setTempo(message.tempoMilliBpm / 1000.0);
+            break;
+        case vjctl::kSubscribe: {
+            // An unbound sender has no address to answer
+            if (fromLength <= sizeof(sa_family_t)) {
+                VJ_LOG_WARN("⚠ Control subscribe from an unbound socket ignored");
+                break;
+            }
+            std::lock_guard<std::mutex> lock(subscriberMutex);
+            if (subscribers.size() < kMaxSubscribers) {
+                subscribers.push_back({from, fromLength});
+                subscriberCount.store(static_cast<int>(subscribers.size()), std::memory_order_release);
+            }
+            break;
+        }
+        default:
+            messages--;
+            malformed++;
+            break;
+    }
+}
+
+void ControlSocket::handleOsc(const uint8_t* data, size_t size, uint64_t receivedNs) {
+    // /vj/trigger note [velocity] [channel], /vj/release note [channel],
+    // /vj/cc controller value [channel], /vj/stop, /vj/tempo bpm.
+    // Bundles are not supported; senders can send plain messages.
+    size_t offset = 0;
+    std::string address, tags;
+    if (!readOscString(data, size, offset, address) || address.empty() || address[0] != '/') {
+        malformed++;
+        return;
+    }
+    if (offset < size && (!readOscString(data, size, offset, tags) || tags.empty() || tags[0] != ',')) {
+        malformed++;
+        return;
+    }
+
+    float args[3] = {0.0f, 0.0f, 0.0f};
+    int argCount = 0;
+    for (size_t i = 1; i < tags.size() && argCount < 3; i++) {
+        if (!readOscNumber(data, size, offset, tags[i], args[argCount++])) {
+            malformed++;
+            return;
+        }
+    }
+    oscMessages++;
+
+    if (address == "/vj/trigger" && argCount >= 1) {
+        int velocity = argCount >= 2 ? toDataByte(args[1]) : 127;
+        unsigned char channel = static_cast<unsigned char>(argCount >= 3 ? toDataByte(args[2]) & 0x0F : 0);
+        dispatch({static_cast<unsigned char>(0x90 | channel), static_cast<unsigned char>(toDataByte(args[0])),
+                  static_cast<unsigned char>(velocity ? velocity : 127)}, 0, receivedNs);
+    } else if (address == "/vj/release" && argCount >= 1) {
+        unsigned char channel = static_cast<unsigned char>(argCount >= 2 ? toDataByte(args[1]) & 0x0F : 0);
+        dispatch({static_cast<unsigned char>(0x80 | channel), static_cast<unsigned char>(toDataByte(args[0])), 0},
+                 0, receivedNs);
+    } else if (address == "/vj/cc" && argCount >= 2) {
+        unsigned char channel = static_cast<unsigned char>(argCount >= 3 ? toDataByte(args[2]) & 0x0F : 0);
+        dispatch({static_cast<unsigned char>(0xB0 | channel), static_cast<unsigned char>(toDataByte(args[0])),
+                  static_cast<unsigned char>(toDataByte(args[1]))}, 0, receivedNs);
+    } else if (address == "/vj/stop") {
+        dispatch({0xB0, 123, 0}, 0, receivedNs);
+    } else if (address == "/vj/tempo" && argCount >= 1) {
+        handler->setTempo(args[0]);
+    } else {
+        oscMessages--;
+        malformed++;
+    }
+}
+
+void ControlSocket::dispatch(const std::vector<unsigned char>& message, uint64_t sentNs, uint64_t receivedNs) {
+    // The sender's timestamp when it has one (same host, same clock), so a
+    // recorded session keeps the sequencer's timing rather than ours
+    bool timed = sentNs > startNs && sentNs <= receivedNs;
+    uint64_t eventNs = timed ? sentNs : receivedNs;
+    handler->injectMessage(message, eventNs);
+
+    uint64_t dispatchNs = monotonicNs() - receivedNs;
+    dispatched++;
+    dispatchTotalNs += dispatchNs;
+    dispatchMaxNs = std::max(dispatchMaxNs, dispatchNs);
+    if (timed) {
+        uint64_t transportNs = receivedNs - sentNs;
+        timedMessages++;
+        transportTotalNs += transportNs;
+        transportMaxNs = std::max(transportMaxNs, transportNs);
+    }
+}
+
+void ControlSocket::notifySubscribers(const std::vector<unsigned char>& message) {
+    // Runs on whichever thread dispatched (MIDI, control, replay)
+    if (subscriberCount.load(std::memory_order_acquire) == 0 || message.size() < 3 || socketFd < 0) return;
+
+    vjctl::Message echo{};
+    echo.magic = vjctl::kMagic;
+    echo.type = vjctl::kDispatched;
+    echo.channel = message[0];
+    echo.number = message[1];
+    echo.value = message[2];
+    echo.sentNs = monotonicNs();
+
+    std::lock_guard<std::mutex> lock(subscriberMutex);
+    for (auto it = subscribers.begin(); it != subscribers.end();) {
+        ssize_t sent = sendto(socketFd, &echo, sizeof(echo), MSG_DONTWAIT,
+                              reinterpret_cast<const sockaddr*>(&it->address), it->length);
+        if (sent < 0 && (errno == ECONNREFUSED || errno == ENOENT)) {
+            it = subscribers.erase(it); // Subscriber has gone away
+        } else {
+            ++it;
+        }
+    }
+    subscriberCount.store(static_cast<int>(subscribers.size()), std::memory_order_release);
+}
+
+void ControlSocket::printStats() const {
+    uint64_t total = messages + oscMessages;
+    if (total == 0 && malformed == 0) return;
+
+    std::cout << "🔌 Control input: " << messages << " messages, " << oscMessages << " OSC, "
+              << malformed << " malformed";
+    if (dispatched > 0) {
+        std::cout << ", dispatch avg " << (dispatchTotalNs / dispatched) / 1000.0 << " µs, max "
+                  << dispatchMaxNs / 1000.0 << " µs";
+    }
+    if (timedMessages > 0) {
+        std::cout << ", sender to receipt avg " << (transportTotalNs / timedMessages) / 1000.0 << " µs, max "
+                  << transportMaxNs / 1000.0 << " µs";
+    }
+    std::cout << std::endl;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include "control/ControlProtocol.h"
+
+class MidiHandler;
+
+// Trigger input for sequencers and scripts on the same machine: a UNIX
+// datagram socket taking vjctl::Message, and optionally OSC on a localhost
+// UDP port. Messages are turned into MIDI bytes and fed through
+// MidiHandler::injectMessage, so they take exactly the path a hardware note
+// takes. One epoll thread serves both sockets.
+class ControlSocket {
+public:
+    ControlSocket();
+    ~ControlSocket();
+
+    // Either may be disabled (empty path / port 0)
+    bool start(MidiHandler* handler, const std::string& socketPath, int oscPort);
+    void stop();
+
+    void printStats() const;
+
+private:
+    struct Subscriber {
+        sockaddr_storage address;
+        socklen_t length;
+    };
+
+    MidiHandler* handler;
+    std::string socketPath;
+    int socketFd;
+    int oscFd;
+    int epollFd;
+    int stopFd;
+    std::thread inputThread;
+    uint64_t startNs;
+
+    std::mutex subscriberMutex;
+    std::vector<Subscriber> subscribers;
+    std::atomic<int> subscriberCount;
+
+    // Input thread only
+    uint64_t messages;
+    uint64_t oscMessages;
+    uint64_t malformed;
+    uint64_t dispatched;       // Turned into MIDI (not tempo or subscribe)
+    uint64_t timedMessages;    // Those carrying a sender timestamp
+    uint64_t transportTotalNs; // Sender timestamp to receipt
+    uint64_t transportMaxNs;
+    uint64_t dispatchTotalNs;  // Receipt to the application callbacks returning
+    uint64_t dispatchMaxNs;
+
+    void inputLoop();
+    void handleBinary(const uint8_t* data, size_t size, const sockaddr_storage& from, socklen_t fromLength,
+                      uint64_t receivedNs);
+    void handleOsc(const uint8_t* data, size_t size, uint64_t receivedNs);
+    void dispatch(const std::vector<unsigned char>& message, uint64_t sentNs, uint64_t receivedNs);
+    void notifySubscribers(const std::vector<unsigned char>& message);
+    void closeSockets();
+};
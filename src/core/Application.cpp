@@ -1,16 +1,40 @@
 #include "core/Application.h"
 #include "utils/CsvParser.h"
 #include "video/VideoClip.h"
+#include "video/KeyframeIndex.h"
+#include "video/ImageSequence.h"
+#include "video/ClipReadahead.h"
+#include "audio/AudioOutput.h"
 #include "midi/MidiHandler.h"
 #include "video/VideoPlayer.h"
 #include "display/DisplayManager.h"
+#include "midi/ControlState.h"
+#include "output/SharedFrameRing.h"
+#include "display/PerformanceHud.h"
+#include "core/PerfCounters.h"
+#include "core/RunStats.h"
+#include "midi/MidiReplayer.h"
+#include "control/ControlSocket.h"
+#include "core/MetricsExporter.h"
+#include "utils/Clock.h"
+#include "utils/ProcessStats.h"
+#include "utils/Trace.h"
+#include "utils/Log.h"
+#include "utils/FrameArena.h"
 #include <iostream>
+#include <iomanip>
+#include <sstream>
 #include <thread>
+#include <filesystem>
 
-Application::Application() : running(false) {
+Application::Application()
+    : exitCode(0), hudRefreshNs(0), hudPrevFrames(0), hudPrevEncoded(0),
+      hudFrameTimes(PerfCounters::kHistorySize), running(false) {
     midiHandler = std::make_unique<MidiHandler>();
     videoPlayer = std::make_unique<VideoPlayer>();
     displayManager = std::make_unique<DisplayManager>();
+    hud = std::make_unique<PerformanceHud>();
+    runStats = std::make_unique<RunStats>();
 }
 
 Application::~Application() {
@@ -24,6 +48,11 @@ void Application::listMidiPorts() {
 bool Application::initialize(const AppConfig& appConfig) {
     config = appConfig;
     
+    Log::start(config.logLevel, config.logPath);
+    if (!config.tracePath.empty()) {
+        Tracer::start(config.tracePath);
+    }
+    
     // If just listing MIDI ports, do that and exit
     if (config.listMidiPorts) {
         listMidiPorts();
@@ -35,9 +64,18 @@ bool Application::initialize(const AppConfig& appConfig) {
     std::cout << "  CSV file: " << config.csvPath << std::endl;
     std::cout << "  Fullscreen: " << (config.fullscreen ? "Yes" : "No") << std::endl;
     std::cout << "  Display: " << (config.displayIndex >= 0 ? std::to_string(config.displayIndex) : "Auto") << std::endl;
+    std::cout << "  Outputs: " << (config.outputs.empty() ? 1 : config.outputs.size()) << std::endl;
     std::cout << "  MIDI port: " << (config.midiPort >= 0 ? std::to_string(config.midiPort) : "Auto") << std::endl;
+    std::cout << "  Realtime: " << (config.realtime ? "Yes" : "No") << std::endl;
     std::cout << std::endl;
     
+    // Before any clip or frame memory exists, so all of it is locked
+    if (config.realtime) {
+        Realtime::enable(config.realtimeConfig);
+    }
+    FrameArena::install(config.hugePages);
+    ClipReadahead::instance().start(config.readaheadMb << 20, config.pinClipsMb << 20, config.pinTotalMb << 20);
+    
     // Load clips configuration
     std::cout << "Loading clips from: " << config.csvPath << std::endl;
     if (!loadClipsFromCSV(config.csvPath)) {
@@ -46,20 +84,65 @@ bool Application::initialize(const AppConfig& appConfig) {
     }
     std::cout << "✓ Loaded " << videoClips.size() << " video clips" << std::endl;
     
+    loadEffectMappings(config.effectsPath);
+    
     // Initialize display manager
-    if (!displayManager->initialize(config.fullscreen, config.displayIndex)) {
+    std::vector<OutputConfig> outputs = config.outputs;
+    if (outputs.empty()) {
+        OutputConfig output;
+        output.displayIndex = config.displayIndex;
+        outputs.push_back(output);
+    }
+    if (!displayManager->initialize(config.fullscreen, outputs)) {
         std::cerr << "Failed to initialize display manager" << std::endl;
         return false;
     }
     std::cout << "✓ Display manager initialized" << std::endl;
     
-    // Initialize video player
-    if (!videoPlayer->initialize()) {
+    // Initialize video player with one render target per output
+    std::vector<cv::Size> outputSizes;
+    for (int i = 0; i < displayManager->getOutputCount(); i++) {
+        outputSizes.push_back(displayManager->getOutputSize(i));
+    }
+    videoPlayer->setFrameRateMode(config.frameRateMode);
+    videoPlayer->setStallBudget(config.stallBudgetMs);
+    
+    // Clip audio, mixed in an SDL callback and kept in step with each clip's video
+    if (config.audio) {
+        audioOutput = std::make_unique<AudioOutput>();
+        if (audioOutput->open(config.audioDriver, config.audioOffsetMs)) {
+            videoPlayer->setAudioOutput(audioOutput.get());
+        } else {
+            std::cerr << "⚠ Clip audio disabled" << std::endl;
+            audioOutput.reset();
+        }
+    }
+    if (!videoPlayer->initialize(outputSizes)) {
         std::cerr << "Failed to initialize video player" << std::endl;
         return false;
     }
     std::cout << "✓ Video player initialized" << std::endl;
     
+    // Optional zero-grab output for local recorders/streamers
+    if (!config.shmName.empty()) {
+        cv::Size size = displayManager->getOutputSize(0);
+        sharedFrameRing = std::make_unique<SharedFrameRing>();
+        if (!sharedFrameRing->open(config.shmName, size.width, size.height)) {
+            std::cerr << "⚠ Shared memory output disabled" << std::endl;
+            sharedFrameRing.reset();
+        }
+    }
+    
+    // Archival recording, encoded off the render thread
+    if (!config.recordPath.empty()) {
+        cv::Size size = displayManager->getOutputSize(0);
+        recorder = std::make_unique<FrameRecorder>();
+        if (!recorder->open(config.recordPath, size.width, size.height, config.outputHz, config.recordPolicy)) {
+            std::cerr << "⚠ Recording disabled" << std::endl;
+            recorder.reset();
+        }
+    }
+    
     // Initialize MIDI with specified port
     if (!midiHandler->initialize(config.midiPort)) {
         std::cerr << "⚠ Failed to initialize MIDI (continuing anyway)" << std::endl;
@@ -67,15 +150,47 @@ bool Application::initialize(const AppConfig& appConfig) {
         std::cout << "✓ MIDI handler initialized" << std::endl;
     }
     
+    if (!config.recordMidiPath.empty()) {
+        midiHandler->startRecording(config.recordMidiPath);
+    }
+    
+    if (!config.replayMidiPath.empty()) {
+        midiReplayer = std::make_unique<MidiReplayer>();
+        if (!midiReplayer->load(config.replayMidiPath)) {
+            return false;
+        }
+    }
+    
     // Set up MIDI callbacks
-    midiHandler->setNoteCallback([this](int note, bool isNoteOn) {
-        this->onMidiNote(note, isNoteOn);
+    midiHandler->setNoteCallback([this](int note, bool isNoteOn, int velocity) {
+        this->onMidiNote(note, isNoteOn, velocity);
     });
     
     midiHandler->setStopCallback([this]() {
         this->onMidiStop();
     });
     
+    // After the callbacks, so the first message has somewhere to go
+    if (!config.controlSocketPath.empty() || config.oscPort > 0) {
+        controlSocket = std::make_unique<ControlSocket>();
+        if (!controlSocket->start(midiHandler.get(), config.controlSocketPath, config.oscPort)) {
+            std::cerr << "⚠ Control socket input disabled" << std::endl;
+            controlSocket.reset();
+        }
+    }
+    
+    if (config.metricsPort > 0 || !config.metricsPath.empty()) {
+        std::vector<const VideoClip*> clips;
+        for (const auto& clip : videoClips) {
+            clips.push_back(clip.get());
+        }
+        metricsExporter = std::make_unique<MetricsExporter>();
+        if (!metricsExporter->start(config.metricsPort, config.metricsPath, config.metricsIntervalSeconds, clips)) {
+            std::cerr << "⚠ Metrics export disabled" << std::endl;
+            metricsExporter.reset();
+        }
+    }
+    
     running = true;
     std::cout << "=== Application Ready ===" << std::endl;
     return true;
@@ -88,6 +203,7 @@ void Application::run() {
     } else {
         std::cout << "📺 Windowed mode - Press ESC to quit, F11 for fullscreen" << std::endl;
     }
+    std::cout << "📊 Press H to toggle the performance overlay" << std::endl;
     std::cout << "🎹 Listening for MIDI input...\n" << std::endl;
     
     // Show available clips
@@ -100,56 +216,247 @@ void Application::run() {
     }
     std::cout << std::endl;
     
-    // Main render loop - remove frame counting debug
+    // Main render loop
+    VJ_TRACE_THREAD_NAME("render");
+    if (config.realtime) {
+        // Start OpenCV's worker pool first: threads inherit their creator's
+        // affinity and policy, and the pool must not be squeezed onto the
+        // render core at FIFO priority
+        cv::parallel_for_(cv::Range(0, cv::getNumThreads()), [](const cv::Range&) {});
+        Realtime::applyToCurrentThread(ThreadRole::Render);
+    }
+    PerfCounters& counters = PerfCounters::instance();
+    // One frame per output refresh (--output-hz)
+    const uint32_t targetFrameUs = static_cast<uint32_t>(1e6 / config.outputHz);
+    uint64_t lastFrameStart = monotonicNs();
+    
+    // Ticks are paced against absolute deadlines so they stay evenly spaced;
+    // frame-rate conversion picks clip frames for the scheduled tick time
+    uint64_t tickNs = lastFrameStart;
+    uint64_t replayFinishedNs = 0;
+    
+    if (midiReplayer) {
+        midiReplayer->start(midiHandler.get(), config.replaySpeed);
+    }
+    
+    if (config.stressTest) {
+        std::vector<int> startNotes, stopNotes;
+        for (const auto& clip : videoClips) {
+            startNotes.push_back(clip->getStartNote());
+            stopNotes.push_back(clip->getStopNote());
+        }
+        stressTest = std::make_unique<StressTest>(config.stress, startNotes, stopNotes);
+        stressTest->start(midiHandler.get());
+    }
+    
     while (running && displayManager->isWindowOpen()) {
-        cv::Mat frame;
-        videoPlayer->getCompositeFrame(frame);
-        displayManager->showFrame(frame);
+        uint64_t frameStart = monotonicNs();
+        uint32_t frameUs = static_cast<uint32_t>((frameStart - lastFrameStart) / 1000);
+        counters.recordFrame(frameUs, targetFrameUs);
+        runStats->addFrameTime(frameUs);
+        lastFrameStart = frameStart;
+        
+        if (stressTest) {
+            stressTest->onFrame(frameUs);
+            if (stressTest->isComplete()) {
+                running = false;
+                break;
+            }
+        }
+        
+        // Regression runs end a couple of seconds after the last replayed message
+        if (config.exitAfterReplay && midiReplayer && midiReplayer->isFinished()) {
+            if (!replayFinishedNs) {
+                replayFinishedNs = frameStart;
+            } else if (frameStart - replayFinishedNs > 2000000000ULL) {
+                VJ_LOG_INFO("Replay complete, shutting down...");
+                running = false;
+                break;
+            }
+        }
+        
+        // Pick up at most one value per knob/velocity since the last frame
+        midiHandler->getControlState().drain([this](const ControlEvent& event) {
+            this->applyControlEvent(event);
+        });
+        
+        videoPlayer->renderOutputs(tickNs);
+        
+        if (hud->isVisible() && frameStart - hudRefreshNs > 250000000ULL) {
+            refreshHud();
+            hudRefreshNs = frameStart;
+        }
+        
+        for (int i = 0; i < videoPlayer->getOutputCount(); i++) {
+            cv::Mat frame;
+            videoPlayer->getCompositeFrame(frame, i);
+            
+            if (i == 0) {
+                if (sharedFrameRing) {
+                    sharedFrameRing->publish(frame); // Before the HUD, so consumers get a clean picture
+                }
+                if (recorder) {
+                    recorder->submit(frame);
+                }
+                if (hud->isVisible()) {
+                    for (int n = 0; n < PerfCounters::kHistorySize; n++) {
+                        hudFrameTimes[n] = counters.getFrameTime(n);
+                    }
+                    hud->draw(frame, hudFrameTimes, targetFrameUs);
+                }
+            }
+            
+            VJ_TRACE_SCOPE("present");
+            displayManager->showFrame(i, frame);
+        }
+        
+        char key;
+        {
+            VJ_TRACE_SCOPE("waitKey");
+            key = displayManager->handleEvents();
+        }
+        
+        // The frame is on screen now; close out any note-to-photon measurements
+        uint64_t presentedNs = monotonicNs();
+        for (int i = 0; i < videoPlayer->getOutputCount(); i++) {
+            bool wasCue = false;
+            uint64_t triggerNs = videoPlayer->takeFirstFrameTrigger(i, &wasCue);
+            if (triggerNs && presentedNs > triggerNs) {
+                uint32_t latencyUs = static_cast<uint32_t>((presentedNs - triggerNs) / 1000);
+                counters.recordTriggerLatency(latencyUs, wasCue);
+                if (wasCue) {
+                    runStats->addCueLatency(latencyUs);
+                } else {
+                    runStats->addTriggerLatency(latencyUs);
+                }
+            }
+        }
         
-        char key = displayManager->handleEvents();
         if (key == 27) { // ESC key
-            std::cout << "ESC pressed, shutting down..." << std::endl;
+            VJ_LOG_INFO("ESC pressed, shutting down...");
             running = false;
             break;
         } else if (key == 122) { // F11 key
             displayManager->toggleFullscreen();
+        } else if (key == 'h' || key == 'H') {
+            hud->toggle();
+            hudRefreshNs = 0;
         }
         
-        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        tickNs += static_cast<uint64_t>(targetFrameUs) * 1000;
+        uint64_t now = monotonicNs();
+        if (now > tickNs + 2ULL * targetFrameUs * 1000) {
+            tickNs = now; // Fell well behind (a stall): resync rather than rush to catch up
+        }
+        if (tickNs > now) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(tickNs - now));
+        }
+    }
+    
+    if (midiReplayer) {
+        midiReplayer->stop();
+    }
+    
+    if (stressTest) {
+        Log::flush();
+        exitCode = stressTest->report() ? 0 : 1;
+        stressTest.reset();
+    }
+    
+    Log::flush(); // Reports below go straight to cout
+    runStats->printSummary();
+    Realtime::printReport();
+    if (!config.baselinePath.empty()) {
+        runStats->printBaselineComparison(config.baselinePath);
+    }
+    if (!config.statsPath.empty()) {
+        runStats->writeJson(config.statsPath);
     }
     
     std::cout << "Application stopped." << std::endl;
 }
 
 void Application::shutdown() {
+    Log::flush();
     std::cout << "Shutting down application..." << std::endl;
     running = false;
     
+    if (midiReplayer) {
+        midiReplayer->stop(); // Before anything it calls into goes away
+    }
+    if (controlSocket) {
+        controlSocket->stop();
+        Log::flush();
+        controlSocket->printStats();
+        controlSocket.reset();
+    }
+    if (metricsExporter) {
+        metricsExporter->stop(); // Writes a last snapshot while the clips still exist
+        metricsExporter->printStats();
+        metricsExporter.reset();
+    }
     if (videoPlayer) {
         videoPlayer->shutdown();
     }
+    if (audioOutput) {
+        audioOutput->close(); // Clips have all removed themselves by now
+        Log::flush();
+        audioOutput->printStats();
+        audioOutput.reset();
+    }
     if (displayManager) {
         displayManager->shutdown();
     }
     if (midiHandler) {
         midiHandler->shutdown();
     }
+    if (sharedFrameRing) {
+        sharedFrameRing->printStats();
+        sharedFrameRing.reset();
+    }
+    if (recorder) {
+        recorder->close(); // Encodes the frames still queued
+        recorder->printStats();
+        recorder.reset();
+    }
+    ClipReadahead::instance().stop();
+    Log::flush();
+    ClipReadahead::instance().printStats();
+    FrameArena::instance().printStats();
     
     videoClips.clear();
+    Tracer::stop();
+    Log::stop();
     std::cout << "Application shutdown complete." << std::endl;
 }
 
-void Application::onMidiNote(int note, bool isNoteOn) {
+void Application::onMidiNote(int note, bool isNoteOn, int velocity) {
+    VJ_TRACE_SCOPE("onMidiNote");
+    uint64_t receivedNs = monotonicNs();
+    
     // Show all MIDI input
-    std::cout << "🎹 MIDI " << note << (isNoteOn ? " ON" : " OFF") << std::endl;
+    VJ_LOG_INFO("🎹 MIDI {} {}", note, isNoteOn ? "ON" : "OFF");
     
     if (isNoteOn) {
+        int cueIndex = -1;
         VideoClip* clip = findClipByNote(note, true);
+        if (!clip) {
+            clip = findClipByCue(note, cueIndex);
+        }
         if (clip) {
+            if (cueIndex >= 0 && clip->isPlaying()) {
+                // A cue on a running clip jumps: relaunch it at the cue
+                videoPlayer->stopClip(clip);
+                clip->setPlaying(false);
+            }
             if (!clip->isPlaying()) {
-                stopAllPlayingClips();
-                std::cout << "▶️  Starting: " << clip->getPath() << std::endl;
-                if (videoPlayer->startClip(clip)) {
+                stopAllPlayingClips(clip);
+                if (cueIndex >= 0) {
+                    VJ_LOG_INFO("▶️  Starting: {} @ {}s", clip->getPath(), clip->getCues()[cueIndex].seconds);
+                } else {
+                    VJ_LOG_INFO("▶️  Starting: {}", clip->getPath());
+                }
+                if (videoPlayer->startClip(clip, receivedNs, cueIndex)) {
                     clip->setPlaying(true);
                 }
             }
@@ -159,20 +466,229 @@ void Application::onMidiNote(int note, bool isNoteOn) {
     // Handle explicit stop notes
     VideoClip* stopClip = findClipByNote(note, false);
     if (stopClip && stopClip->isPlaying() && !isNoteOn) {
-        std::cout << "⏹️  Stopping: " << stopClip->getPath() << std::endl;
+        VJ_LOG_INFO("⏹️  Stopping: {}", stopClip->getPath());
         videoPlayer->stopClip(stopClip);
         stopClip->setPlaying(false);
     }
 }
 
 void Application::onMidiStop() {
-    std::cout << "🛑 MIDI STOP - stopping all clips" << std::endl;
+    VJ_LOG_INFO("🛑 MIDI STOP - stopping all clips");
     videoPlayer->stopAllClips();
     for (auto& clip : videoClips) {
         clip->setPlaying(false);
     }
 }
 
+void Application::applyControlEvent(const ControlEvent& event) {
+    EffectMapping::Source source = EffectMapping::Source::ControlChange;
+    int number = event.number;
+    float normalized = event.value / 127.0f;
+    if (event.type == ControlEvent::Type::Velocity) {
+        source = EffectMapping::Source::Velocity;
+    } else if (event.type == ControlEvent::Type::PitchBend) {
+        source = EffectMapping::Source::PitchBend;
+        number = event.channel;
+        normalized = event.value / 16383.0f;
+    }
+    
+    for (const auto& mapping : effectMappings) {
+        if (mapping.source != source) continue;
+        if (mapping.number != number && !(source == EffectMapping::Source::PitchBend && mapping.number < 0)) continue;
+        
+        float value = mapping.min + normalized * (mapping.max - mapping.min);
+        
+        if (mapping.transport == EffectMapping::Transport::None) {
+            EffectParams& params = mapping.clip ? mapping.clip->getEffects() : videoPlayer->getMasterEffects();
+            params.set(mapping.param, value);
+            continue;
+        }
+        
+        // Transport controls are read by the playback threads, so they go
+        // through the clip's atomics rather than the render-side params
+        uint64_t nowNs = monotonicNs();
+        for (auto& clip : videoClips) {
+            if (mapping.clip && mapping.clip != clip.get()) continue;
+            
+            PlaybackControl& playback = clip->getPlayback();
+            if (mapping.transport == EffectMapping::Transport::Speed) {
+                playback.setSpeed(value);
+            } else {
+                playback.scratch.store(std::min(std::max(value, 0.0f), 1.0f), std::memory_order_relaxed);
+                playback.scratchNs.store(nowNs, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+void Application::loadEffectMappings(const std::string& effectsPath) {
+    if (effectsPath.empty()) return;
+    
+    std::vector<EffectMappingData> mappingData;
+    try {
+        mappingData = CsvParser::parseEffectsFile(effectsPath);
+    } catch (const std::exception& e) {
+        std::cout << "No effect mappings loaded (" << e.what() << ")" << std::endl;
+        return;
+    }
+    
+    for (const auto& data : mappingData) {
+        EffectMapping mapping;
+        
+        mapping.param = EffectParam::Brightness;
+        mapping.transport = EffectMapping::Transport::None;
+        if (data.effect == "speed") {
+            mapping.transport = EffectMapping::Transport::Speed;
+        } else if (data.effect == "scratch") {
+            mapping.transport = EffectMapping::Transport::Scratch;
+        } else if (!EffectParams::paramFromName(data.effect, mapping.param)) {
+            std::cerr << "  ❌ Unknown effect: " << data.effect << std::endl;
+            continue;
+        }
+        
+        mapping.clip = nullptr;
+        if (data.target != "master") {
+            for (auto& clip : videoClips) {
+                if (clip->getPath() == data.target) {
+                    mapping.clip = clip.get();
+                    break;
+                }
+            }
+            if (!mapping.clip) {
+                std::cerr << "  ❌ Effect target is not a clip: " << data.target << std::endl;
+                continue;
+            }
+        }
+        
+        if (data.source == "cc") {
+            mapping.source = EffectMapping::Source::ControlChange;
+        } else if (data.source == "velocity") {
+            mapping.source = EffectMapping::Source::Velocity;
+        } else if (data.source == "pitchbend") {
+            mapping.source = EffectMapping::Source::PitchBend;
+        } else {
+            std::cerr << "  ❌ Unknown effect source: " << data.source << std::endl;
+            continue;
+        }
+        
+        bool valid = true;
+        try {
+            if (mapping.source == EffectMapping::Source::PitchBend) {
+                // Number is the MIDI channel 1-16; empty = any channel
+                mapping.number = data.number.empty() ? -1 : std::stoi(data.number) - 1;
+                if (mapping.number > 15) throw std::out_of_range("channel");
+            } else if (data.number.empty() && mapping.source == EffectMapping::Source::Velocity && mapping.clip) {
+                mapping.number = mapping.clip->getStartNote(); // Velocity of the clip's own trigger
+            } else {
+                mapping.number = CsvParser::noteStringToMidi(data.number);
+            }
+            mapping.min = std::stof(data.min);
+            mapping.max = std::stof(data.max);
+        } catch (const std::exception&) {
+            valid = false;
+        }
+        
+        if (!valid || (mapping.number < 0 && mapping.source != EffectMapping::Source::PitchBend)) {
+            std::cerr << "  ❌ Invalid effect mapping for " << data.target << " " << data.effect << std::endl;
+            continue;
+        }
+        
+        effectMappings.push_back(mapping);
+        std::cout << "  🎛️  " << data.source << " " << mapping.number << " → " << data.target
+                  << " " << data.effect << " [" << data.min << ", " << data.max << "]" << std::endl;
+    }
+    
+    std::cout << "✓ Loaded " << effectMappings.size() << " effect mappings" << std::endl;
+}
+
+void Application::refreshHud() {
+    PerfCounters& counters = PerfCounters::instance();
+    ProcessStats process = ProcessStats::read();
+    uint64_t now = monotonicNs();
+    double seconds = hudRefreshNs ? (now - hudRefreshNs) / 1e9 : 0.0;
+    
+    uint64_t frames = counters.outputFrames.load(std::memory_order_relaxed);
+    double outputFps = seconds > 0 ? (frames - hudPrevFrames) / seconds : 0.0;
+    hudPrevFrames = frames;
+    
+    uint32_t windowMaxUs = 0;
+    for (int n = 0; n < 60; n++) {
+        windowMaxUs = std::max(windowMaxUs, counters.getFrameTime(n));
+    }
+    
+    std::vector<std::string> lines;
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(1);
+    
+    line << "OUTPUT " << outputFps << " fps  " << counters.lastFrameUs.load() / 1000.0 << " ms  max "
+         << windowMaxUs / 1000.0 << " ms  dropped " << counters.droppedFrames.load();
+    lines.push_back(line.str());
+    
+    line.str("");
+    line << "NOTE->PHOTON " << counters.lastNoteToPhotonUs.load() / 1000.0 << " ms  CUE "
+         << counters.lastCueToPhotonUs.load() / 1000.0 << " ms";
+    lines.push_back(line.str());
+    
+    line.str("");
+    line << "THREADS " << process.threads << "  RSS " << (process.rssBytes >> 20) << " MB  VIDEOS "
+         << counters.activeVideos.load();
+    lines.push_back(line.str());
+    
+    if (FrameArena::isInstalled()) {
+        FrameArena::Stats arena = FrameArena::instance().getStats();
+        line.str("");
+        line << "ARENA " << (arena.usedBytes >> 20) << "/" << (arena.mappedBytes >> 20) << " MB  "
+             << (arena.explicitSlabs + arena.transparentSlabs) << "/" << arena.slabs << " huge slabs";
+        lines.push_back(line.str());
+    }
+    
+    if (recorder) {
+        FrameRecorder::Stats recording = recorder->getStats();
+        double encodeFps = seconds > 0 ? (recording.encoded - hudPrevEncoded) / seconds : 0.0;
+        hudPrevEncoded = recording.encoded;
+        line.str("");
+        line << "REC " << encodeFps << " fps  queue " << recording.queueDepth << "/" << FrameRecorder::kPoolSize
+             << "  dropped " << recording.dropped;
+        lines.push_back(line.str());
+    }
+    
+    const ControlState& controls = midiHandler->getControlState();
+    line.str("");
+    line << "MIDI " << counters.midiMessages.load() << " msgs  CC queue " << controls.getUpdateCount()
+         << " in / " << controls.getDeliveredCount() << " applied";
+    if (midiHandler->getTempo() > 0) {
+        line << "  " << midiHandler->getTempo() << " BPM";
+    }
+    lines.push_back(line.str());
+    
+    for (const auto& clip : videoClips) {
+        const ClipStats& stats = clip->getStats();
+        uint64_t decoded = stats.framesDecoded.load(std::memory_order_relaxed);
+        uint64_t& prevDecoded = hudPrevDecoded[clip.get()];
+        double decodeFps = seconds > 0 ? (decoded - prevDecoded) / seconds : 0.0;
+        prevDecoded = decoded;
+        
+        if (!clip->isPlaying()) continue;
+        
+        line.str("");
+        line << std::filesystem::path(clip->getPath()).filename().string() << "  decode " << decodeFps
+             << " fps  lag " << stats.lagUs.load() / 1000.0 << " ms  late " << stats.lateFrames.load();
+        if (stats.ioBytes.load() > 0) {
+            line << "  io " << (stats.ioBytes.load() >> 20) << " MB wait " << stats.ioWaitUs.load() / 1000 << " ms";
+        }
+        if (stats.decoderStalls.load() > 0) {
+            line << "  stalls " << stats.decoderStalls.load() << " (" << stats.recoveryUs.load() / 1000.0 << " ms)";
+        }
+        if (audioOutput && (stats.avOffsetUs.load() != 0 || stats.audioUnderruns.load() > 0)) {
+            line << "  a/v " << std::showpos << stats.avOffsetUs.load() / 1000.0 << std::noshowpos << " ms underruns "
+                 << stats.audioUnderruns.load();
+        }
+        lines.push_back(line.str());
+    }
+    
+    hud->setLines(lines);
+}
+
 VideoClip* Application::findClipByNote(int note, bool isStart) {
     for (auto& clip : videoClips) {
         if (isStart && clip->getStartNote() == note) {
@@ -184,6 +700,15 @@ VideoClip* Application::findClipByNote(int note, bool isStart) {
     return nullptr;
 }
 
+VideoClip* Application::findClipByCue(int note, int& cueIndex) {
+    for (auto& clip : videoClips) {
+        cueIndex = clip->findCue(note);
+        if (cueIndex >= 0) return clip.get();
+    }
+    cueIndex = -1;
+    return nullptr;
+}
+
 bool Application::loadClipsFromCSV(const std::string& csvPath) {
     try {
         auto clipData = CsvParser::parseClipsFile(csvPath);
@@ -193,8 +718,48 @@ bool Application::loadClipsFromCSV(const std::string& csvPath) {
             int stopNote = CsvParser::noteStringToMidi(data.stopNote);
             
             if (startNote >= 0 && stopNote >= 0) {
-                videoClips.push_back(std::make_unique<VideoClip>(data.path, startNote, stopNote));
-                std::cout << "  📹 " << data.path << " (MIDI " << startNote << "-" << stopNote << ")" << std::endl;
+                auto clip = std::make_unique<VideoClip>(data.path, startNote, stopNote);
+                clip->setOutputs(CsvParser::parseIndexList(data.outputs));
+                std::cout << "  📹 " << data.path << " (MIDI " << startNote << "-" << stopNote << ")";
+                if (!data.outputs.empty()) {
+                    std::cout << " outputs " << data.outputs;
+                }
+                std::cout << std::endl;
+                
+                if (ImageSequence::isImageSource(data.path)) {
+                    // Every image is its own keyframe; no index needed
+                    if (!data.fps.empty()) {
+                        try {
+                            clip->setFrameRate(std::stod(data.fps));
+                        } catch (const std::exception&) {
+                            std::cerr << "  ❌ Invalid fps " << data.fps << " for clip: " << data.path << std::endl;
+                        }
+                    }
+                    size_t frames = ImageSequence::listFrames(data.path).size();
+                    std::cout << "  🖼️  " << (frames == 1 ? "Still image" : "Image sequence, " + std::to_string(frames) + " frames")
+                              << " at " << (clip->getFrameRate() > 0 ? clip->getFrameRate() : ImageSequence::kDefaultFps)
+                              << " fps" << std::endl;
+                } else {
+                    // Seek index for reverse/varispeed/scratch; read from cache when unchanged
+                    clip->setKeyframeIndex(KeyframeIndex::loadOrBuild(data.path));
+                    ClipReadahead::instance().prepare(data.path, &clip->getStats());
+                }
+                
+                for (const auto& cue : CsvParser::parseCueList(data.cues)) {
+                    int cueNote = CsvParser::noteStringToMidi(cue.note);
+                    double seconds = -1;
+                    try {
+                        seconds = std::stod(cue.seconds);
+                    } catch (const std::exception&) {
+                    }
+                    if (cueNote < 0 || seconds < 0) {
+                        std::cerr << "  ❌ Invalid cue " << cue.note << "@" << cue.seconds << " for clip: " << data.path << std::endl;
+                        continue;
+                    }
+                    clip->addCue(cueNote, seconds);
+                }
+                VideoPlayer::prerollCues(*clip);
+                videoClips.push_back(std::move(clip));
             } else {
                 std::cerr << "  ❌ Invalid notes for clip: " << data.path << std::endl;
             }
@@ -207,8 +772,11 @@ bool Application::loadClipsFromCSV(const std::string& csvPath) {
     }
 }
 
-void Application::stopAllPlayingClips() {
+void Application::stopAllPlayingClips(const VideoClip* onOutputsOf) {
     for (auto& clip : videoClips) {
+        // A new clip only replaces what is on its own outputs
+        if (onOutputsOf && !clip->sharesOutputWith(*onOutputsOf)) continue;
+        
         if (clip->isPlaying()) {
             videoPlayer->stopClip(clip.get());
             clip->setPlaying(false);
@@ -2,21 +2,75 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <map>
+#include <cstdint>
+#include "video/EffectParams.h"
+#include "display/DisplayManager.h"
+#include "core/StressTest.h"
+#include "utils/Realtime.h"
+#include "utils/Log.h"
+#include "video/FrameTimeline.h"
+#include "output/FrameRecorder.h"
 
 struct AppConfig {
     std::string csvPath;
+    std::string effectsPath;
     bool fullscreen;
     int displayIndex;
+    std::vector<OutputConfig> outputs; // Empty = single output on displayIndex
     int midiPort;
     bool listMidiPorts;
+    std::string shmName;   // Publish output 0 to this shared-memory ring, empty = off
+    std::string tracePath; // Chrome trace-event JSON output, empty = tracing off
+    std::string recordMidiPath;  // Save every incoming MIDI message to this .mid file
+    std::string replayMidiPath;  // Inject a recorded .mid session instead of (or as well as) live input
+    double replaySpeed;
+    bool exitAfterReplay;
+    std::string statsPath;       // Frame-time/latency summary JSON written at exit
+    bool stressTest;
+    StressConfig stress;
+    bool realtime;               // Affinity, SCHED_FIFO and locked memory
+    RealtimeConfig realtimeConfig;
+    std::string baselinePath;    // Earlier --stats JSON to compare this run's frame times with
+    bool hugePages;              // Back the frame arena with huge pages when available
+    std::string logPath;         // Also write timestamped log messages here, empty = console only
+    LogLevel logLevel;
+    double outputHz;             // Render loop rate, normally the display refresh rate
+    FrameRateMode frameRateMode; // How clip frames are mapped onto outputHz
+    std::string recordPath;      // Record output 0 to this video file, empty = off
+    RecordPolicy recordPolicy;
+    std::string controlSocketPath; // UNIX datagram trigger input, empty = off
+    int oscPort;                   // OSC trigger input on 127.0.0.1, 0 = off
+    uint32_t stallBudgetMs;        // Replace a decoder that produces nothing for this long, 0 = off
+    size_t readaheadMb;            // Page-cache window kept ahead of each playing clip, 0 = off
+    size_t pinClipsMb;             // Lock clips up to this size in memory at load, 0 = off
+    size_t pinTotalMb;             // Stop pinning once this much is locked
+    bool audio;                    // Play clip audio tracks
+    std::string audioDriver;       // SDL audio driver, empty = SDL's default
+    double audioOffsetMs;          // Extra audio delay to match display latency
+    int metricsPort;               // Prometheus endpoint on 127.0.0.1, 0 = off
+    std::string metricsPath;       // JSON metrics snapshot rewritten periodically, empty = off
+    double metricsIntervalSeconds;
     
-    AppConfig() : csvPath("data/clips.csv"), fullscreen(false), displayIndex(-1), midiPort(-1), listMidiPorts(false) {}
+    AppConfig() : csvPath("data/clips.csv"), effectsPath("data/effects.csv"), fullscreen(false), displayIndex(-1), midiPort(-1), listMidiPorts(false),
+                  replaySpeed(1.0), exitAfterReplay(false), stressTest(false), realtime(false),
+                  hugePages(true), logLevel(LogLevel::Info), outputHz(60.0), frameRateMode(FrameRateMode::Nearest),
+                  recordPolicy(RecordPolicy::DropOldest), oscPort(0),
+                  stallBudgetMs(400), readaheadMb(32), pinClipsMb(0), pinTotalMb(1024), audio(false), audioOffsetMs(0.0),
+                  metricsPort(0), metricsIntervalSeconds(10.0) {}
 };
 
 class VideoClip;
 class MidiHandler;
+struct ControlEvent;
 class VideoPlayer;
-class DisplayManager;
+class SharedFrameRing;
+class PerformanceHud;
+class MidiReplayer;
+class RunStats;
+class ControlSocket;
+class AudioOutput;
+class MetricsExporter;
 
 class Application {
 public:
@@ -26,22 +80,59 @@ public:
     bool initialize(const AppConfig& config);
     void run();
     void shutdown();
+    int getExitCode() const { return exitCode; }
     
     // Called by MidiHandler when notes are received
-    void onMidiNote(int note, bool isNoteOn);
+    void onMidiNote(int note, bool isNoteOn, int velocity);
     void onMidiStop();
     
     void listMidiPorts(); // Public method to list MIDI ports
     
 private:
+    // Routes one CC, note velocity or pitch bend onto an effect parameter,
+    // or onto a clip's transport (speed / scratch position)
+    struct EffectMapping {
+        enum class Source { ControlChange, Velocity, PitchBend };
+        enum class Transport { None, Speed, Scratch };
+        
+        VideoClip* clip;     // nullptr = master (transport: every clip)
+        EffectParam param;
+        Transport transport; // None = effect parameter
+        Source source;
+        int number;          // CC number, note number, or pitch bend channel (-1 = any)
+        float min, max;
+    };
+    
     std::vector<std::unique_ptr<VideoClip>> videoClips;
+    std::vector<EffectMapping> effectMappings;
     std::unique_ptr<MidiHandler> midiHandler;
     std::unique_ptr<VideoPlayer> videoPlayer;
     std::unique_ptr<DisplayManager> displayManager;
+    std::unique_ptr<SharedFrameRing> sharedFrameRing;
+    std::unique_ptr<FrameRecorder> recorder;
+    std::unique_ptr<AudioOutput> audioOutput;
+    std::unique_ptr<PerformanceHud> hud;
+    std::unique_ptr<MidiReplayer> midiReplayer;
+    std::unique_ptr<ControlSocket> controlSocket;
+    std::unique_ptr<MetricsExporter> metricsExporter;
+    std::unique_ptr<RunStats> runStats;
+    std::unique_ptr<StressTest> stressTest;
+    int exitCode;
+    
+    // HUD text is rebuilt a few times a second from the counters
+    uint64_t hudRefreshNs;
+    uint64_t hudPrevFrames;
+    uint64_t hudPrevEncoded;
+    std::map<const VideoClip*, uint64_t> hudPrevDecoded;
+    std::vector<uint32_t> hudFrameTimes; // Graph input, reused so drawing does not allocate
     AppConfig config;
     bool running;
     bool loadClipsFromCSV(const std::string& csvPath);
-    void stopAllPlayingClips();
+    void loadEffectMappings(const std::string& effectsPath);
+    void applyControlEvent(const ControlEvent& event);
+    void refreshHud();
+    void stopAllPlayingClips(const VideoClip* onOutputsOf = nullptr);
     
     VideoClip* findClipByNote(int note, bool isStart);
+    VideoClip* findClipByCue(int note, int& cueIndex);
 };
\ No newline at end of file
@@ -0,0 +1,415 @@
+#include "core/MetricsExporter.h"
+#include "core/PerfCounters.h"
+#include "video/VideoClip.h"
+#include "utils/Clock.h"
+#include "utils/ProcessStats.h"
+#include "utils/Trace.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint64_t kSampleIntervalNs = 1000000000ULL;
+
+// Label values and JSON strings need the same three escapes for file names
+std::string escape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else if (static_cast<unsigned char>(c) >= 0x20) {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+void writeHeader(std::ostringstream& out, const char* name, const char* type, const char* help) {
+    out << "# HELP " << name << ' ' << help << "\n# TYPE " << name << ' ' << type << '\n';
+}
+
+void writeHistogram(std::ostringstream& out, const char* name, const std::string& labels,
+                    const LatencyHistogram& histogram) {
+    std::string prefix = labels.empty() ? "{" : "{" + labels + ",";
+    uint64_t cumulative = 0;
+    for (int i = 0; i < LatencyHistogram::kBuckets; i++) {
+        cumulative += histogram.getBucket(i);
+        out << name << "_bucket" << prefix << "le=\"" << LatencyHistogram::kBoundsUs[i] / 1e6 << "\"} "
+            << cumulative << '\n';
+    }
+    cumulative += histogram.getBucket(LatencyHistogram::kBuckets);
+    out << name << "_bucket" << prefix << "le=\"+Inf\"} " << cumulative << '\n';
+    std::string suffix = labels.empty() ? "" : "{" + labels + "}";
+    out << name << "_sum" << suffix << ' ' << histogram.getSumUs() / 1e6 << '\n';
+    out << name << "_count" << suffix << ' ' << cumulative << '\n';
+}
+
+void writeJsonHistogram(std::ostringstream& out, const LatencyHistogram& histogram) {
+    uint64_t count = 0;
+    out << "{\"buckets_us\": {";
+    for (int i = 0; i <= LatencyHistogram::kBuckets; i++) {
+        uint64_t bucket = histogram.getBucket(i);
+        count += bucket;
+        if (i > 0) out << ", ";
+        if (i < LatencyHistogram::kBuckets) {
+            out << '"' << LatencyHistogram::kBoundsUs[i] << "\": " << bucket;
+        } else {
+            out << "\"inf\": " << bucket;
+        }
+    }
+    out << "}, \"count\": " << count << ", \"sum_us\": " << histogram.getSumUs() << '}';
+}
+
+} // namespace
+
+MetricsExporter::MetricsExporter()
+    : snapshotIntervalNs(0), listenFd(-1), stopFd(-1), sampleNs(0), sampleFrames(0), sampleMidi(0), scrapes(0),
+      snapshots(0) {
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::start(int port, const std::string& path, double snapshotSeconds,
+                            const std::vector<const VideoClip*>& clipList) {
+    stop();
+    clips = clipList;
+    clipNames.clear();
+    clipLabels.clear();
+    for (size_t i = 0; i < clips.size(); i++) {
+        clipNames.push_back(escape(std::filesystem::path(clips[i]->getPath()).filename().string()));
+        clipLabels.push_back("clip=\"" + clipNames.back() + "\",note=\"" + std::to_string(clips[i]->getStartNote()) +
+                             "\",index=\"" + std::to_string(i) + "\"");
+    }
+    snapshotPath = path;
+    snapshotIntervalNs = static_cast<uint64_t>(std::max(snapshotSeconds, 0.1) * 1e9);
+    rates.clipDecodeFps.assign(clips.size(), 0.0);
+    sampleDecoded.assign(clips.size(), 0);
+
+    if (port > 0) {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // Scraped through the local node agent or a tunnel
+        listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int reuse = 1;
+        if (listenFd >= 0) {
+            setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        }
+        if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(listenFd, 8) != 0) {
+            std::cerr << "Cannot listen for metrics on port " << port << ": " << std::strerror(errno) << std::endl;
+            stop();
+            return false;
+        }
+    }
+    stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (stopFd < 0) {
+        std::cerr << "Cannot create metrics exporter: " << std::strerror(errno) << std::endl;
+        stop();
+        return false;
+    }
+
+    exporterThread = std::thread([this]() {
+        VJ_TRACE_THREAD_NAME("metrics");
+        exporterLoop(); // Normal priority, unpinned: this is the least urgent thread in the process
+    });
+
+    if (listenFd >= 0) {
+        std::cout << "✓ Metrics on http://127.0.0.1:" << port << "/metrics" << std::endl;
+    }
+    if (!snapshotPath.empty()) {
+        std::cout << "✓ Metrics snapshot " << snapshotPath << " every " << snapshotIntervalNs / 1e9 << " s" << std::endl;
+    }
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if (exporterThread.joinable()) {
+        uint64_t one = 1;
+        ssize_t written = write(stopFd, &one, sizeof(one));
+        (void)written; // Only fails if the counter would overflow
+        exporterThread.join();
+    }
+    if (listenFd >= 0) {
+        close(listenFd);
+        listenFd = -1;
+    }
+    if (stopFd >= 0) {
+        close(stopFd);
+        stopFd = -1;
+    }
+}
+
+void MetricsExporter::exporterLoop() {
+    uint64_t now = monotonicNs();
+    sampleRates(now);
+    uint64_t nextSample = now + kSampleIntervalNs;
+    uint64_t nextSnapshot = snapshotPath.empty() ? UINT64_MAX : now + snapshotIntervalNs;
+
+    while (true) {
+        now = monotonicNs();
+        uint64_t wake = std::min(nextSample, nextSnapshot);
+        int timeoutMs = wake > now ? static_cast<int>((wake - now) / 1000000) + 1 : 0;
+
+        pollfd fds[2] = {{stopFd, POLLIN, 0}, {listenFd, POLLIN, 0}};
+        int ready = poll(fds, listenFd >= 0 ? 2 : 1, timeoutMs);
+        if (ready > 0 && fds[0].revents) break;
+        if (ready > 0 && (fds[1].revents & POLLIN)) {
+            int client = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client >= 0) {
+                serveConnection(client);
+                close(client);
+            }
+        }
+
+        now = monotonicNs();
+        if (now >= nextSample) {
+            sampleRates(now);
+            nextSample = now + kSampleIntervalNs;
+        }
+        if (now >= nextSnapshot) {
+            writeSnapshot();
+            nextSnapshot = now + snapshotIntervalNs;
+        }
+    }
+
+    if (!snapshotPath.empty()) {
+        writeSnapshot(); // Final state, for runs shorter than the interval
+    }
+}
+
+void MetricsExporter::sampleRates(uint64_t now) {
+    const PerfCounters& counters = PerfCounters::instance();
+    uint64_t frames = counters.outputFrames.load(std::memory_order_relaxed);
+    uint64_t midi = counters.midiMessages.load(std::memory_order_relaxed);
+    double seconds = sampleNs ? (now - sampleNs) / 1e9 : 0.0;
+
+    if (seconds > 0) {
+        rates.outputFps = (frames - sampleFrames) / seconds;
+        rates.midiPerSecond = (midi - sampleMidi) / seconds;
+    }
+    for (size_t i = 0; i < clips.size(); i++) {
+        uint64_t decoded = clips[i]->getStats().framesDecoded.load(std::memory_order_relaxed);
+        rates.clipDecodeFps[i] = seconds > 0 ? (decoded - sampleDecoded[i]) / seconds : 0.0;
+        sampleDecoded[i] = decoded;
+    }
+    sampleNs = now;
+    sampleFrames = frames;
+    sampleMidi = midi;
+}
+
+void MetricsExporter::serveConnection(int fd) {
+    // Scrapers send a short GET; never let a slow client hold the thread for long
+    timeval timeout{0, 500000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    std::string request;
+    char buffer[1024];
+    while (request.size() < 8192 && request.find("\r\n\r\n") == std::string::npos) {
+        ssize_t bytes = recv(fd, buffer, sizeof(buffer), 0);
+        if (bytes <= 0) break;
+        request.append(buffer, static_cast<size_t>(bytes));
+    }
+
+    std::string target;
+    if (request.compare(0, 4, "GET ") == 0) {
+        target = request.substr(4, request.find(' ', 4) - 4);
+        target = target.substr(0, target.find('?'));
+    }
+
+    std::string status = "200 OK";
+    std::string contentType = "text/plain; version=0.0.4; charset=utf-8";
+    std::string body;
+    if (target == "/metrics") {
+        body = renderPrometheus();
+        scrapes++;
+    } else if (target == "/metrics.json") {
+        body = renderJson();
+        contentType = "application/json";
+        scrapes++;
+    } else if (target == "/") {
+        body = "vj-app metrics: /metrics (Prometheus), /metrics.json\n";
+    } else {
+        status = "404 Not Found";
+        body = "Not found\n";
+    }
+
+    std::string response = "HTTP/1.1 " + status + "\r\nContent-Type: " + contentType +
+                            "\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t bytes = send(fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (bytes <= 0) break;
+        sent += static_cast<size_t>(bytes);
+    }
+}
+
+std::string MetricsExporter::renderPrometheus() const {
+    VJ_TRACE_SCOPE("render metrics");
+    const PerfCounters& counters = PerfCounters::instance();
+    ProcessStats process = ProcessStats::read();
+    std::ostringstream out;
+    out.precision(12); // Byte and frame counters stay exact when printed through double
+
+    writeHeader(out, "vj_output_frames_total", "counter", "Output frames rendered.");
+    out << "vj_output_frames_total " << counters.outputFrames.load() << '\n';
+    writeHeader(out, "vj_output_dropped_frames_total", "counter", "Output intervals missed by slow frames.");
+    out << "vj_output_dropped_frames_total " << counters.droppedFrames.load() << '\n';
+    writeHeader(out, "vj_output_fps", "gauge", "Output frame rate over the last second.");
+    out << "vj_output_fps " << rates.outputFps << '\n';
+    writeHeader(out, "vj_frame_time_seconds", "histogram", "Render loop frame time.");
+    writeHistogram(out, "vj_frame_time_seconds", "", counters.frameTimes);
+
+    writeHeader(out, "vj_trigger_latency_seconds", "histogram", "Trigger received to first frame presented.");
+    writeHistogram(out, "vj_trigger_latency_seconds", "launch=\"start\"", counters.noteToPhoton);
+    writeHistogram(out, "vj_trigger_latency_seconds", "launch=\"cue\"", counters.cueToPhoton);
+
+    writeHeader(out, "vj_midi_messages_total", "counter", "MIDI messages handled, by kind.");
+    out << "vj_midi_messages_total{kind=\"all\"} " << counters.midiMessages.load() << '\n';
+    out << "vj_midi_messages_total{kind=\"note\"} " << counters.midiNotes.load() << '\n';
+    out << "vj_midi_messages_total{kind=\"control\"} " << counters.midiControls.load() << '\n';
+    writeHeader(out, "vj_midi_messages_per_second", "gauge", "MIDI message rate over the last second.");
+    out << "vj_midi_messages_per_second " << rates.midiPerSecond << '\n';
+
+    writeHeader(out, "vj_active_clips", "gauge", "Clips playing.");
+    out << "vj_active_clips " << counters.activeVideos.load() << '\n';
+    writeHeader(out, "vj_live_decoders", "gauge", "Clip decoders alive, including ones shutting down.");
+    out << "vj_live_decoders " << counters.liveDecoders.load() << '\n';
+    writeHeader(out, "vj_process_resident_memory_bytes", "gauge", "Resident set size.");
+    out << "vj_process_resident_memory_bytes " << process.rssBytes << '\n';
+    writeHeader(out, "vj_process_threads", "gauge", "Threads in the process.");
+    out << "vj_process_threads " << process.threads << '\n';
+
+    // Per clip, one family at a time as the format requires
+    struct ClipMetric {
+        const char* name;
+        const char* type;
+        const char* help;
+        double (*value)(const ClipStats&);
+    };
+    static const ClipMetric clipMetrics[] = {
+        {"vj_clip_frames_decoded_total", "counter", "Frames decoded.",
+         [](const ClipStats& s) { return static_cast<double>(s.framesDecoded.load()); }},
+        {"vj_clip_late_frames_total", "counter", "Frames decoded after their display deadline.",
+         [](const ClipStats& s) { return static_cast<double>(s.lateFrames.load()); }},
+        {"vj_clip_decode_lag_seconds", "gauge", "How far behind schedule the last frame was.",
+         [](const ClipStats& s) { return s.lagUs.load() / 1e6; }},
+        {"vj_clip_seek_cache_hits_total", "counter", "Random-access frames found already decoded.",
+         [](const ClipStats& s) { return static_cast<double>(s.seekCacheHits.load()); }},
+        {"vj_clip_seek_cache_misses_total", "counter", "Random-access frames whose block had to be decoded.",
+         [](const ClipStats& s) { return static_cast<double>(s.seekCacheMisses.load()); }},
+        {"vj_clip_seek_misses_total", "counter", "Random-access frames not ready in time.",
+         [](const ClipStats& s) { return static_cast<double>(s.seekMisses.load()); }},
+        {"vj_clip_readahead_misses_total", "counter", "Times the decoder got past the readahead.",
+         [](const ClipStats& s) { return static_cast<double>(s.readaheadMisses.load()); }},
+        {"vj_clip_io_bytes_total", "counter", "Bytes read ahead of the decoder.",
+         [](const ClipStats& s) { return static_cast<double>(s.ioBytes.load()); }},
+        {"vj_clip_decoder_stalls_total", "counter", "Decoders replaced by the stall watchdog.",
+         [](const ClipStats& s) { return static_cast<double>(s.decoderStalls.load()); }},
+        {"vj_clip_audio_underruns_total", "counter", "Audio buffers the decoder could not fill.",
+         [](const ClipStats& s) { return static_cast<double>(s.audioUnderruns.load()); }},
+        {"vj_clip_av_offset_seconds", "gauge", "Audio minus video at the last audio buffer.",
+         [](const ClipStats& s) { return s.avOffsetUs.load() / 1e6; }},
+    };
+    if (!clips.empty()) {
+        writeHeader(out, "vj_clip_playing", "gauge", "1 while the clip plays.");
+        for (size_t i = 0; i < clips.size(); i++) {
+            out << "vj_clip_playing{" << clipLabels[i] << "} " << (clips[i]->isPlaying() ? 1 : 0) << '\n';
+        }
+        writeHeader(out, "vj_clip_decode_fps", "gauge", "Decode rate over the last second.");
+        for (size_t i = 0; i < clips.size(); i++) {
+            out << "vj_clip_decode_fps{" << clipLabels[i] << "} " << rates.clipDecodeFps[i] << '\n';
+        }
+        for (const ClipMetric& metric : clipMetrics) {
+            writeHeader(out, metric.name, metric.type, metric.help);
+            for (size_t i = 0; i < clips.size(); i++) {
+                out << metric.name << "{" << clipLabels[i] << "} " << metric.value(clips[i]->getStats()) << '\n';
+            }
+        }
+    }
+    return out.str();
+}
+
+std::string MetricsExporter::renderJson() const {
+    const PerfCounters& counters = PerfCounters::instance();
+    ProcessStats process = ProcessStats::read();
+    auto wallMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::ostringstream out;
+
+    out << "{\n";
+    out << "  \"timestamp_ms\": " << wallMs << ",\n";
+    out << "  \"output\": {\"frames\": " << counters.outputFrames.load() << ", \"fps\": " << rates.outputFps
+        << ", \"dropped\": " << counters.droppedFrames.load() << ", \"last_frame_us\": " << counters.lastFrameUs.load()
+        << ", \"max_frame_us\": " << counters.maxFrameUs.load() << ",\n             \"frame_time\": ";
+    writeJsonHistogram(out, counters.frameTimes);
+    out << "},\n";
+    out << "  \"midi\": {\"messages\": " << counters.midiMessages.load() << ", \"notes\": " << counters.midiNotes.load()
+        << ", \"controls\": " << counters.midiControls.load() << ", \"per_second\": " << rates.midiPerSecond << "},\n";
+    out << "  \"trigger_latency\": {\"last_start_us\": " << counters.lastNoteToPhotonUs.load()
+        << ", \"last_cue_us\": " << counters.lastCueToPhotonUs.load() << ",\n                      \"start\": ";
+    writeJsonHistogram(out, counters.noteToPhoton);
+    out << ",\n                      \"cue\": ";
+    writeJsonHistogram(out, counters.cueToPhoton);
+    out << "},\n";
+    out << "  \"process\": {\"rss_bytes\": " << process.rssBytes << ", \"threads\": " << process.threads
+        << ", \"active_clips\": " << counters.activeVideos.load() << ", \"live_decoders\": "
+        << counters.liveDecoders.load() << "},\n";
+    out << "  \"clips\": [";
+    for (size_t i = 0; i < clips.size(); i++) {
+        const ClipStats& stats = clips[i]->getStats();
+        uint64_t hits = stats.seekCacheHits.load();
+        uint64_t misses = stats.seekCacheMisses.load();
+        out << (i ? ",\n" : "\n") << "    {\"name\": \"" << clipNames[i] << "\", \"note\": " << clips[i]->getStartNote()
+            << ", \"index\": " << i << ", \"playing\": "
+            << (clips[i]->isPlaying() ? "true" : "false") << ", \"decode_fps\": " << rates.clipDecodeFps[i]
+            << ", \"frames_decoded\": " << stats.framesDecoded.load() << ", \"late_frames\": " << stats.lateFrames.load()
+            << ", \"lag_us\": " << stats.lagUs.load() << ", \"seek_cache_hit_rate\": "
+            << (hits + misses ? static_cast<double>(hits) / (hits + misses) : 0.0) << ", \"seek_misses\": "
+            << stats.seekMisses.load() << ", \"readahead_misses\": " << stats.readaheadMisses.load()
+            << ", \"io_bytes\": " << stats.ioBytes.load() << ", \"decoder_stalls\": " << stats.decoderStalls.load()
+            << ", \"audio_underruns\": " << stats.audioUnderruns.load() << ", \"av_offset_us\": "
+            << stats.avOffsetUs.load() << "}";
+    }
+    out << (clips.empty() ? "]\n" : "\n  ]\n");
+    out << "}\n";
+    return out.str();
+}
+
+bool MetricsExporter::writeSnapshot() {
+    // Written aside and renamed, so a reader never sees half a file
+    std::string temporary = snapshotPath + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::trunc);
+        if (!out.is_open()) return false;
+        out << renderJson();
+        if (!out.good()) return false;
+    }
+    if (std::rename(temporary.c_str(), snapshotPath.c_str()) != 0) return false;
+    snapshots++;
+    return true;
+}
+
+void MetricsExporter::printStats() const {
+    if (scrapes == 0 && snapshots == 0) return;
+    std::cout << "📈 Metrics: " << scrapes << " scrapes served, " << snapshots << " snapshots written" << std::endl;
+}
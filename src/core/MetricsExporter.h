@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+class VideoClip;
+
+// Publishes the process's counters for monitoring: Prometheus text format
+// over HTTP on a localhost port, and/or a JSON snapshot file rewritten
+// every few seconds. Everything runs on one exporter thread that only reads
+// relaxed atomics (PerfCounters, ClipStats) and /proc, so the render and
+// decode threads never wait on it or see it.
+class MetricsExporter {
+public:
+    MetricsExporter();
+    ~MetricsExporter();
+
+    // port 0 = no HTTP; empty snapshotPath = no file. The clip list must
+    // outlive the exporter.
+    bool start(int port, const std::string& snapshotPath, double snapshotSeconds,
+               const std::vector<const VideoClip*>& clips);
+    void stop();
+
+    void printStats() const;
+
+private:
+    // Gauges derived from counter deltas, refreshed once a second
+    struct Rates {
+        double outputFps = 0.0;
+        double midiPerSecond = 0.0;
+        std::vector<double> clipDecodeFps;
+    };
+
+    std::vector<const VideoClip*> clips;
+    std::vector<std::string> clipNames;  // Escaped for labels and JSON
+    std::vector<std::string> clipLabels; // clip, note and index: one file can be loaded on several notes
+    std::string snapshotPath;
+    uint64_t snapshotIntervalNs;
+    int listenFd;
+    int stopFd;
+    std::thread exporterThread;
+
+    // Exporter thread only
+    Rates rates;
+    uint64_t sampleNs;
+    uint64_t sampleFrames;
+    uint64_t sampleMidi;
+    std::vector<uint64_t> sampleDecoded;
+    uint64_t scrapes;
+    uint64_t snapshots;
+
+    void exporterLoop();
+    void sampleRates(uint64_t now);
+    void serveConnection(int fd);
+    std::string renderPrometheus() const;
+    std::string renderJson() const;
+    bool writeSnapshot();
+};
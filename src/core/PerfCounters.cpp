@@ -0,0 +1,67 @@
+#include "core/PerfCounters.h"
+
+LatencyHistogram::LatencyHistogram() : sumUs(0) {
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::record(uint32_t us) {
+    int index = 0;
+    while (index < kBuckets && us > kBoundsUs[index]) {
+        index++;
+    }
+    buckets[index].fetch_add(1, std::memory_order_relaxed);
+    sumUs.fetch_add(us, std::memory_order_relaxed);
+}
+
+PerfCounters& PerfCounters::instance() {
+    static PerfCounters counters;
+    return counters;
+}
+
+PerfCounters::PerfCounters()
+    : outputFrames(0), droppedFrames(0), lastFrameUs(0), maxFrameUs(0),
+      midiMessages(0), midiNotes(0), midiControls(0), lastNoteToPhotonUs(0),
+      lastCueToPhotonUs(0),
+      activeVideos(0), liveDecoders(0), historyIndex(0) {
+    for (auto& entry : frameHistory) {
+        entry.store(0, std::memory_order_relaxed);
+    }
+}
+
+void PerfCounters::recordFrame(uint32_t frameUs, uint32_t targetUs) {
+    outputFrames.fetch_add(1, std::memory_order_relaxed);
+    lastFrameUs.store(frameUs, std::memory_order_relaxed);
+    
+    if (frameUs > maxFrameUs.load(std::memory_order_relaxed)) {
+        maxFrameUs.store(frameUs, std::memory_order_relaxed);
+    }
+    
+    // Every whole output interval beyond the first is a frame the screen never got
+    if (targetUs > 0 && frameUs > targetUs + targetUs / 2) {
+        droppedFrames.fetch_add((frameUs + targetUs / 2) / targetUs - 1, std::memory_order_relaxed);
+    }
+    
+    uint32_t index = historyIndex.fetch_add(1, std::memory_order_relaxed);
+    frameHistory[index % kHistorySize].store(frameUs, std::memory_order_relaxed);
+    frameTimes.record(frameUs);
+}
+
+void PerfCounters::recordTriggerLatency(uint32_t latencyUs, bool cue) {
+    if (cue) {
+        lastCueToPhotonUs.store(latencyUs, std::memory_order_relaxed);
+        cueToPhoton.record(latencyUs);
+    } else {
+        lastNoteToPhotonUs.store(latencyUs, std::memory_order_relaxed);
+        noteToPhoton.record(latencyUs);
+    }
+}
+
+uint32_t PerfCounters::getFrameTime(int framesAgo) const {
+    uint32_t index = historyIndex.load(std::memory_order_relaxed);
+    if (framesAgo < 0 || framesAgo >= kHistorySize || static_cast<uint32_t>(framesAgo) >= index) {
+        return 0;
+    }
+    return frameHistory[(index - 1 - framesAgo) % kHistorySize].load(std::memory_order_relaxed);
+}
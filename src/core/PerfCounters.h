@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Latency distribution in fixed buckets, for the metrics exporter. Recording
+// is one relaxed increment per bucket and sum, so any thread can record and
+// anything can read without a lock.
+class LatencyHistogram {
+public:
+    static constexpr int kBuckets = 12;
+    static constexpr uint32_t kBoundsUs[kBuckets] = {1000, 2000, 4000, 8000, 12000, 16667,
+                                                     20000, 33333, 50000, 100000, 250000, 1000000};
+    
+    LatencyHistogram();
+    
+    void record(uint32_t us);
+    uint64_t getBucket(int index) const { return buckets[index].load(std::memory_order_relaxed); } // kBuckets = above all
+    uint64_t getSumUs() const { return sumUs.load(std::memory_order_relaxed); }
+    
+private:
+    std::atomic<uint64_t> buckets[kBuckets + 1];
+    std::atomic<uint64_t> sumUs;
+};
+
+// Process-wide performance counters. Every field is a relaxed atomic so the
+// render loop, MIDI callback and decoder threads can update them without
+// locks, and the HUD (or anything else) can read them at any time.
+class PerfCounters {
+public:
+    static constexpr int kHistorySize = 256;
+    
+    static PerfCounters& instance();
+    
+    // Render loop
+    void recordFrame(uint32_t frameUs, uint32_t targetUs);
+    void recordTriggerLatency(uint32_t latencyUs, bool cue);
+    uint32_t getFrameTime(int framesAgo) const;
+    
+    std::atomic<uint64_t> outputFrames;
+    std::atomic<uint64_t> droppedFrames;    // Missed output intervals
+    std::atomic<uint32_t> lastFrameUs;
+    std::atomic<uint32_t> maxFrameUs;
+    
+    // MIDI
+    std::atomic<uint64_t> midiMessages;
+    std::atomic<uint64_t> midiNotes;
+    std::atomic<uint64_t> midiControls;
+    
+    // Trigger latency: MIDI note received -> first frame of the clip presented,
+    // kept apart for launches from frame 0 and launches at a cue point
+    std::atomic<uint32_t> lastNoteToPhotonUs;
+    std::atomic<uint32_t> lastCueToPhotonUs;
+    
+    LatencyHistogram frameTimes;
+    LatencyHistogram noteToPhoton;
+    LatencyHistogram cueToPhoton;
+    
+    // Video
+    std::atomic<int> activeVideos;   // Clips in the playing set
+    std::atomic<int> liveDecoders;   // PlayingVideo objects alive, including ones being torn down
+    
+private:
+    PerfCounters();
+    
+    std::atomic<uint32_t> frameHistory[kHistorySize];
+    std::atomic<uint32_t> historyIndex;
+};
@@ -0,0 +1,109 @@
+#include "core/RunStats.h"
+#include "core/PerfCounters.h"
+#include "utils/Realtime.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+RunStats::RunStats() {
+    frameTimesUs.reserve(60 * 60 * 60); // An hour at 60 fps before reallocating
+}
+
+uint32_t RunStats::percentile(std::vector<uint32_t> samples, double fraction) {
+    if (samples.empty()) return 0;
+    
+    size_t index = std::min(samples.size() - 1, static_cast<size_t>(fraction * (samples.size() - 1) + 0.5));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+void RunStats::printSummary() const {
+    if (frameTimesUs.empty()) return;
+    
+    const PerfCounters& counters = PerfCounters::instance();
+    std::cout << "📊 Frames: " << frameTimesUs.size()
+              << "  dropped " << counters.droppedFrames.load() << std::endl;
+    std::cout << "   Frame time ms  p50 " << percentile(frameTimesUs, 0.5) / 1000.0
+              << "  p99 " << percentile(frameTimesUs, 0.99) / 1000.0
+              << "  p99.9 " << percentile(frameTimesUs, 0.999) / 1000.0
+              << "  max " << percentile(frameTimesUs, 1.0) / 1000.0 << std::endl;
+    
+    if (!triggerLatenciesUs.empty()) {
+        std::cout << "   Note-to-photon ms  p50 " << percentile(triggerLatenciesUs, 0.5) / 1000.0
+                  << "  p99 " << percentile(triggerLatenciesUs, 0.99) / 1000.0
+                  << "  max " << percentile(triggerLatenciesUs, 1.0) / 1000.0
+                  << "  (" << triggerLatenciesUs.size() << " triggers)" << std::endl;
+    }
+    if (!cueLatenciesUs.empty()) {
+        std::cout << "   Cue-to-photon ms   p50 " << percentile(cueLatenciesUs, 0.5) / 1000.0
+                  << "  p99 " << percentile(cueLatenciesUs, 0.99) / 1000.0
+                  << "  max " << percentile(cueLatenciesUs, 1.0) / 1000.0
+                  << "  (" << cueLatenciesUs.size() << " cue launches)" << std::endl;
+    }
+}
+
+bool RunStats::writeJson(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Cannot write stats file: " << path << std::endl;
+        return false;
+    }
+    
+    const PerfCounters& counters = PerfCounters::instance();
+    out << "{\n";
+    out << "  \"frames\": " << frameTimesUs.size() << ",\n";
+    out << "  \"dropped_frames\": " << counters.droppedFrames.load() << ",\n";
+    out << "  \"midi_messages\": " << counters.midiMessages.load() << ",\n";
+    out << "  \"realtime\": " << (Realtime::isEnabled() ? "true" : "false") << ",\n";
+    out << "  \"frame_time_us\": {\"p50\": " << percentile(frameTimesUs, 0.5)
+        << ", \"p99\": " << percentile(frameTimesUs, 0.99)
+        << ", \"p999\": " << percentile(frameTimesUs, 0.999)
+        << ", \"max\": " << percentile(frameTimesUs, 1.0) << "},\n";
+    out << "  \"triggers\": " << triggerLatenciesUs.size() << ",\n";
+    out << "  \"note_to_photon_us\": {\"p50\": " << percentile(triggerLatenciesUs, 0.5)
+        << ", \"p99\": " << percentile(triggerLatenciesUs, 0.99)
+        << ", \"max\": " << percentile(triggerLatenciesUs, 1.0) << "},\n";
+    out << "  \"cue_triggers\": " << cueLatenciesUs.size() << ",\n";
+    out << "  \"cue_to_photon_us\": {\"p50\": " << percentile(cueLatenciesUs, 0.5)
+        << ", \"p99\": " << percentile(cueLatenciesUs, 0.99)
+        << ", \"max\": " << percentile(cueLatenciesUs, 1.0) << "}\n";
+    out << "}\n";
+    
+    std::cout << "📊 Wrote run stats to " << path << std::endl;
+    return true;
+}
+
+void RunStats::printBaselineComparison(const std::string& baselinePath) const {
+    std::ifstream in(baselinePath);
+    if (!in.is_open()) {
+        std::cerr << "Cannot read baseline stats: " << baselinePath << std::endl;
+        return;
+    }
+    std::string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    
+    // Only our own writeJson() output is expected here, so a key search will do
+    auto read = [&json](const std::string& key) -> long {
+        size_t section = json.find("\"frame_time_us\"");
+        if (section == std::string::npos) return -1;
+        size_t at = json.find("\"" + key + "\":", section);
+        if (at == std::string::npos) return -1;
+        return std::strtol(json.c_str() + at + key.size() + 3, nullptr, 10);
+    };
+    
+    long baseP99 = read("p99");
+    long baseP999 = read("p999");
+    if (baseP99 < 0 || baseP999 < 0 || frameTimesUs.empty()) {
+        std::cerr << "Baseline stats have no frame times: " << baselinePath << std::endl;
+        return;
+    }
+    
+    uint32_t p99 = percentile(frameTimesUs, 0.99);
+    uint32_t p999 = percentile(frameTimesUs, 0.999);
+    std::cout << "📊 Versus baseline " << baselinePath << std::endl;
+    std::cout << "   p99   " << baseP99 / 1000.0 << " -> " << p99 / 1000.0 << " ms ("
+              << std::showpos << (static_cast<long>(p99) - baseP99) / 1000.0 << std::noshowpos << ")" << std::endl;
+    std::cout << "   p99.9 " << baseP999 / 1000.0 << " -> " << p999 / 1000.0 << " ms ("
+              << std::showpos << (static_cast<long>(p999) - baseP999) / 1000.0 << std::noshowpos << ")" << std::endl;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Whole-run frame-time and trigger-latency samples, kept by the render
+// thread and summarised at exit so two runs (e.g. a replayed show on two
+// builds) can be compared.
+class RunStats {
+public:
+    RunStats();
+    
+    void addFrameTime(uint32_t frameUs) { frameTimesUs.push_back(frameUs); }
+    void addTriggerLatency(uint32_t latencyUs) { triggerLatenciesUs.push_back(latencyUs); }
+    void addCueLatency(uint32_t latencyUs) { cueLatenciesUs.push_back(latencyUs); }
+    
+    void printSummary() const;
+    bool writeJson(const std::string& path) const;
+    
+    // Compares frame-time percentiles with an earlier writeJson() file
+    void printBaselineComparison(const std::string& baselinePath) const;
+    
+private:
+    std::vector<uint32_t> frameTimesUs;
+    std::vector<uint32_t> triggerLatenciesUs;
+    std::vector<uint32_t> cueLatenciesUs;
+    
+    static uint32_t percentile(std::vector<uint32_t> samples, double fraction);
+};
@@ -0,0 +1,182 @@
+#include "core/StressTest.h"
+#include "core/PerfCounters.h"
+#include "midi/MidiHandler.h"
+#include "utils/Clock.h"
+#include "utils/ProcessStats.h"
+#include "utils/Trace.h"
+#include "utils/Realtime.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+// How long the player gets after the final panic before leak checks
+static const uint64_t kSettleNs = 1500000000ULL;
+
+StressTest::StressTest(const StressConfig& stressConfig, const std::vector<int>& starts, const std::vector<int>& stops)
+    : config(stressConfig), startNotes(starts), stopNotes(stops), shouldStop(false), generatorDone(false),
+      messagesSent(0), startNs(0), generatorDoneNs(0), lastSampleNs(0), complete(false), frames(0), stalls(0),
+      maxFrameUs(0), baselineThreads(0), maxThreads(0), baselineRss(0), maxRss(0),
+      finalActiveVideos(0), finalLiveDecoders(0) {
+    if (config.patterns.empty()) {
+        config.patterns.push_back("all");
+    }
+}
+
+StressTest::~StressTest() {
+    shouldStop = true;
+    if (generatorThread.joinable()) {
+        generatorThread.join();
+    }
+}
+
+void StressTest::start(MidiHandler* handler) {
+    ProcessStats process = ProcessStats::read();
+    baselineThreads = maxThreads = process.threads;
+    baselineRss = maxRss = process.rssBytes;
+    startNs = lastSampleNs = monotonicNs();
+    
+    std::cout << "🔥 Stress test: ";
+    for (const auto& pattern : config.patterns) std::cout << pattern << " ";
+    std::cout << "for " << config.seconds << " s (stall budget " << config.stallBudgetMs << " ms)" << std::endl;
+    
+    generatorThread = std::thread(&StressTest::generatorLoop, this, handler);
+}
+
+void StressTest::generatorLoop(MidiHandler* handler) {
+    VJ_TRACE_THREAD_NAME("stress");
+    Realtime::applyToCurrentThread(ThreadRole::Midi); // Stands in for the MIDI driver thread
+    
+    auto has = [this](const char* name) {
+        return std::find(config.patterns.begin(), config.patterns.end(), name) != config.patterns.end() ||
+               std::find(config.patterns.begin(), config.patterns.end(), "all") != config.patterns.end();
+    };
+    const bool retrigger = has("retrigger");
+    const bool chords = has("chords");
+    const bool ccStorm = has("cc");
+    const bool panic = has("panic");
+    
+    std::mt19937 random(12345); // Fixed seed: the same flood every run
+    auto pick = [&random](const std::vector<int>& notes) {
+        return notes.empty() ? 60 : notes[random() % notes.size()];
+    };
+    
+    auto send = [&](std::vector<unsigned char> message) {
+        handler->injectMessage(message);
+        messagesSent.fetch_add(1, std::memory_order_relaxed);
+    };
+    
+    // 1 ms ticks; each pattern fires on its own cadence
+    const auto tick = std::chrono::milliseconds(1);
+    auto next = std::chrono::steady_clock::now();
+    const uint64_t endNs = startNs + static_cast<uint64_t>(config.seconds * 1e9);
+    uint64_t tickCount = 0;
+    
+    while (!shouldStop && monotonicNs() < endNs) {
+        // Finger drumming: a note-on/off pair every 5 ms across the clips
+        if (retrigger && tickCount % 5 == 0) {
+            int note = pick(startNotes);
+            send({0x90, static_cast<unsigned char>(note), static_cast<unsigned char>(1 + random() % 127)});
+            send({0x80, static_cast<unsigned char>(note), 0});
+            if (random() % 4 == 0) {
+                send({0x80, static_cast<unsigned char>(pick(stopNotes)), 0});
+            }
+        }
+        // Chords: every clip note on all 16 channels at once, every 100 ms
+        if (chords && tickCount % 100 == 0) {
+            for (int channel = 0; channel < 16; channel++) {
+                for (int note : startNotes) {
+                    send({static_cast<unsigned char>(0x90 | channel), static_cast<unsigned char>(note), 100});
+                }
+            }
+        }
+        // Knob storm: ~2 kHz of CC across the usual knob range
+        if (ccStorm) {
+            for (int i = 0; i < 2; i++) {
+                send({static_cast<unsigned char>(0xB0 | (random() % 16)),
+                      static_cast<unsigned char>(70 + random() % 8), static_cast<unsigned char>(random() % 128)});
+            }
+        }
+        // Panic spam every 50 ms
+        if (panic && tickCount % 50 == 0) {
+            send({0xB0, static_cast<unsigned char>(random() % 2 ? 120 : 123), 0});
+        }
+        
+        tickCount++;
+        next += tick;
+        std::this_thread::sleep_until(next);
+    }
+    
+    // Leave nothing playing, then let the render thread run the leak checks
+    send({0xB0, 123, 0});
+    generatorDone.store(true, std::memory_order_release);
+}
+
+void StressTest::sampleProcess() {
+    ProcessStats process = ProcessStats::read();
+    maxThreads = std::max(maxThreads, process.threads);
+    maxRss = std::max(maxRss, process.rssBytes);
+}
+
+void StressTest::onFrame(uint32_t frameUs) {
+    if (complete || !startNs) return;
+    
+    uint64_t now = monotonicNs();
+    frames++;
+    frameTimesUs.push_back(frameUs);
+    maxFrameUs = std::max(maxFrameUs, frameUs);
+    if (frameUs > config.stallBudgetMs * 1000.0) {
+        stalls++;
+    }
+    
+    if (now - lastSampleNs > 100000000ULL) {
+        sampleProcess();
+        lastSampleNs = now;
+    }
+    
+    if (generatorDone.load(std::memory_order_acquire)) {
+        if (!generatorDoneNs) {
+            generatorDoneNs = now;
+        } else if (now - generatorDoneNs > kSettleNs) {
+            sampleProcess();
+            const PerfCounters& counters = PerfCounters::instance();
+            finalActiveVideos = counters.activeVideos.load();
+            finalLiveDecoders = counters.liveDecoders.load();
+            complete = true;
+        }
+    }
+}
+
+bool StressTest::report() const {
+    // Each playing clip may own a playback thread plus FFmpeg's per-core decode threads
+    const int perClip = 1 + static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const int threadLimit = baselineThreads + static_cast<int>(startNotes.size()) * perClip + config.threadSlack;
+    const uint64_t rssLimit = baselineRss + (config.rssBudgetMb << 20);
+    const double elapsed = generatorDoneNs > startNs ? (generatorDoneNs - startNs) / 1e9 : 0.0;
+    
+    std::vector<uint32_t> sorted = frameTimesUs;
+    std::sort(sorted.begin(), sorted.end());
+    uint32_t p99 = sorted.empty() ? 0 : sorted[std::min(sorted.size() - 1, sorted.size() * 99 / 100)];
+    
+    bool noStalls = stalls == 0;
+    bool threadsBounded = maxThreads <= threadLimit;
+    bool rssBounded = maxRss <= rssLimit;
+    bool noLeaks = complete && finalActiveVideos == 0 && finalLiveDecoders == 0;
+    bool passed = noStalls && threadsBounded && rssBounded && noLeaks;
+    
+    auto mark = [](bool ok) { return ok ? "✓" : "❌"; };
+    std::cout << "\n=== Stress test report ===" << std::endl;
+    std::cout << "  Messages: " << messagesSent.load() << " in " << elapsed << " s ("
+              << (elapsed > 0 ? messagesSent.load() / elapsed : 0.0) << " msg/s)" << std::endl;
+    std::cout << "  Frames: " << frames << "  p99 " << p99 / 1000.0 << " ms  max " << maxFrameUs / 1000.0 << " ms" << std::endl;
+    std::cout << "  " << mark(noStalls) << " Render stalls over " << config.stallBudgetMs << " ms: " << stalls << std::endl;
+    std::cout << "  " << mark(threadsBounded) << " Threads: baseline " << baselineThreads << ", peak " << maxThreads
+              << " (limit " << threadLimit << ")" << std::endl;
+    std::cout << "  " << mark(rssBounded) << " RSS: baseline " << (baselineRss >> 20) << " MB, peak " << (maxRss >> 20)
+              << " MB (limit " << (rssLimit >> 20) << " MB)" << std::endl;
+    std::cout << "  " << mark(noLeaks) << " After panic: " << finalActiveVideos << " playing, " << finalLiveDecoders
+              << " PlayingVideo objects alive" << std::endl;
+    std::cout << "  Result: " << (passed ? "PASS" : "FAIL") << std::endl;
+    
+    return passed;
+}
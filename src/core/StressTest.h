@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+class MidiHandler;
+
+struct StressConfig {
+    std::vector<std::string> patterns; // retrigger, chords, cc, panic (or "all")
+    double seconds;
+    double stallBudgetMs;      // Longest acceptable render frame
+    int threadSlack;           // Threads allowed above baseline + what the clips may own
+    uint64_t rssBudgetMb;      // RSS growth allowed above baseline
+    
+    StressConfig() : seconds(30.0), stallBudgetMs(50.0), threadSlack(8), rssBudgetMb(1024) {}
+};
+
+// Synthesises MIDI floods into MidiHandler (through the same path as live
+// input) while the render loop reports each frame. Afterwards it sends a
+// panic, lets the player settle, and checks for stalls, thread and memory
+// growth, and leaked PlayingVideo objects.
+class StressTest {
+public:
+    StressTest(const StressConfig& config, const std::vector<int>& startNotes, const std::vector<int>& stopNotes);
+    ~StressTest();
+    
+    void start(MidiHandler* handler);
+    
+    // Render thread, once per frame
+    void onFrame(uint32_t frameUs);
+    bool isComplete() const { return complete; }
+    
+    // Prints the report; true if every check passed
+    bool report() const;
+    
+private:
+    StressConfig config;
+    std::vector<int> startNotes;
+    std::vector<int> stopNotes;
+    
+    std::thread generatorThread;
+    std::atomic<bool> shouldStop;
+    std::atomic<bool> generatorDone;
+    std::atomic<uint64_t> messagesSent;
+    
+    // Render-thread state
+    uint64_t startNs;
+    uint64_t generatorDoneNs;
+    uint64_t lastSampleNs;
+    bool complete;
+    uint64_t frames;
+    uint64_t stalls;
+    uint32_t maxFrameUs;
+    std::vector<uint32_t> frameTimesUs;
+    int baselineThreads;
+    int maxThreads;
+    uint64_t baselineRss;
+    uint64_t maxRss;
+    int finalActiveVideos;
+    int finalLiveDecoders;
+    
+    void generatorLoop(MidiHandler* handler);
+    void sampleProcess();
+};
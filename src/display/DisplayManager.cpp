@@ -12,35 +12,63 @@ DisplayManager::~DisplayManager() {
 }
 
 bool DisplayManager::initialize(bool startFullscreen, int displayIndex) {
+    OutputConfig output;
+    output.displayIndex = displayIndex;
+    return initialize(startFullscreen, std::vector<OutputConfig>{output});
+}
+
+bool DisplayManager::initialize(bool startFullscreen, const std::vector<OutputConfig>& outputConfigs) {
     std::cout << "Initializing display manager..." << std::endl;
     
     detectDisplays();
     
-    // Create the window with minimal UI - no toolbar, just basic window controls
-    cv::namedWindow(windowName, cv::WINDOW_NORMAL | cv::WINDOW_KEEPRATIO | cv::WINDOW_GUI_NORMAL);
-    windowOpen = true;
-    
-    // Set window properties for clean appearance
-    cv::setWindowProperty(windowName, cv::WND_PROP_ASPECT_RATIO, cv::WINDOW_FREERATIO);
-    
-    // Determine which display to use
-    if (displayIndex >= 0 && displayIndex < static_cast<int>(displays.size())) {
-        currentDisplayIndex = displayIndex;
-        std::cout << "Using specified display " << displayIndex << std::endl;
-    } else if (displays.size() > 1) {
-        currentDisplayIndex = 1; // Default to second display if available
-        std::cout << "Multiple displays detected, using display 1" << std::endl;
-    } else {
-        currentDisplayIndex = 0;
-        std::cout << "Using primary display" << std::endl;
+    for (size_t i = 0; i < outputConfigs.size(); i++) {
+        const auto& outputConfig = outputConfigs[i];
+        OutputWindow output;
+        output.windowName = (i == 0) ? windowName : windowName + " " + std::to_string(i + 1);
+        
+        // Determine which display to use
+        int displayIndex = outputConfig.displayIndex;
+        if (displayIndex >= 0 && displayIndex < static_cast<int>(displays.size())) {
+            output.displayIndex = displayIndex;
+            std::cout << "Output " << i << ": using specified display " << displayIndex << std::endl;
+        } else if (displays.size() > 1) {
+            output.displayIndex = 1; // Default to second display if available
+            std::cout << "Output " << i << ": multiple displays detected, using display 1" << std::endl;
+        } else {
+            output.displayIndex = 0;
+            std::cout << "Output " << i << ": using primary display" << std::endl;
+        }
+        
+        const auto& display = displays[output.displayIndex];
+        if (outputConfig.width > 0 && outputConfig.height > 0) {
+            output.resolution = cv::Size(outputConfig.width, outputConfig.height);
+        } else {
+            output.resolution = cv::Size(display.width, display.height);
+        }
+        
+        // Create the window with minimal UI - no toolbar, just basic window controls
+        cv::namedWindow(output.windowName, cv::WINDOW_NORMAL | cv::WINDOW_KEEPRATIO | cv::WINDOW_GUI_NORMAL);
+        
+        // Set window properties for clean appearance
+        cv::setWindowProperty(output.windowName, cv::WND_PROP_ASPECT_RATIO, cv::WINDOW_FREERATIO);
+        
+        // Set initial size (windowed mode) and position on the chosen display
+        cv::resizeWindow(output.windowName, display.width / 2, display.height / 2);
+        outputs.push_back(output);
+        moveWindowToDisplay(output);
+        
+        std::cout << "Output " << i << ": " << output.resolution.width << "x" << output.resolution.height
+                  << " on display " << output.displayIndex << std::endl;
     }
     
-    // Position window on chosen display
-    setOutputDisplay(currentDisplayIndex);
+    if (outputs.empty()) {
+        std::cerr << "No outputs configured" << std::endl;
+        return false;
+    }
     
-    // Set initial size (windowed mode)
-    const auto& display = displays[currentDisplayIndex];
-    cv::resizeWindow(windowName, display.width / 2, display.height / 2);
+    windowOpen = true;
+    currentDisplayIndex = outputs[0].displayIndex;
     
     // Go fullscreen if requested
     if (startFullscreen) {
@@ -53,7 +81,10 @@ bool DisplayManager::initialize(bool startFullscreen, int displayIndex) {
 
 void DisplayManager::shutdown() {
     if (windowOpen) {
-        cv::destroyWindow(windowName);
+        for (const auto& output : outputs) {
+            cv::destroyWindow(output.windowName);
+        }
+        outputs.clear();
         windowOpen = false;
     }
 }
@@ -131,24 +162,36 @@ bool DisplayManager::setOutputDisplay(int displayIndex) {
     currentDisplayIndex = displayIndex;
     
     if (windowOpen) {
+        outputs[0].displayIndex = displayIndex;
         moveWindowToDisplay(displayIndex);
     }
     
     return true;
 }
 
+cv::Size DisplayManager::getOutputSize(int outputIndex) const {
+    if (outputIndex < 0 || outputIndex >= static_cast<int>(outputs.size())) {
+        return cv::Size();
+    }
+    return outputs[outputIndex].resolution;
+}
+
 void DisplayManager::moveWindowToDisplay(int displayIndex) {
-    if (displayIndex < 0 || displayIndex >= static_cast<int>(displays.size())) {
+    if (displayIndex < 0 || displayIndex >= static_cast<int>(displays.size()) || outputs.empty()) {
         return;
     }
     
-    const auto& display = displays[displayIndex];
+    moveWindowToDisplay(outputs[0]);
+}
+
+void DisplayManager::moveWindowToDisplay(const OutputWindow& output) {
+    const auto& display = displays[output.displayIndex];
     
-    std::cout << "Moving window to display " << displayIndex 
+    std::cout << "Moving " << output.windowName << " to display " << output.displayIndex
               << " (" << display.width << "x" << display.height << ")" << std::endl;
     
     // Move window
-    cv::moveWindow(windowName, display.x + 50, display.y + 50); // Small offset from edge
+    cv::moveWindow(output.windowName, display.x + 50, display.y + 50); // Small offset from edge
 }
 
 void DisplayManager::setFullscreen(bool fullscreen) {
@@ -158,14 +201,20 @@ void DisplayManager::setFullscreen(bool fullscreen) {
     
     if (fullscreen) {
         std::cout << "Switching to fullscreen mode" << std::endl;
-        cv::setWindowProperty(windowName, cv::WND_PROP_FULLSCREEN, cv::WINDOW_FULLSCREEN);
-        moveWindowToDisplay(currentDisplayIndex);
     } else {
         std::cout << "Switching to windowed mode" << std::endl;
-        cv::setWindowProperty(windowName, cv::WND_PROP_FULLSCREEN, cv::WINDOW_NORMAL);
-        const auto& display = displays[currentDisplayIndex];
-        cv::resizeWindow(windowName, display.width / 2, display.height / 2);
-        cv::moveWindow(windowName, display.x + 50, display.y + 50);
+    }
+    
+    for (const auto& output : outputs) {
+        if (fullscreen) {
+            cv::setWindowProperty(output.windowName, cv::WND_PROP_FULLSCREEN, cv::WINDOW_FULLSCREEN);
+            moveWindowToDisplay(output);
+        } else {
+            cv::setWindowProperty(output.windowName, cv::WND_PROP_FULLSCREEN, cv::WINDOW_NORMAL);
+            const auto& display = displays[output.displayIndex];
+            cv::resizeWindow(output.windowName, display.width / 2, display.height / 2);
+            cv::moveWindow(output.windowName, display.x + 50, display.y + 50);
+        }
     }
 }
 
@@ -174,24 +223,16 @@ void DisplayManager::toggleFullscreen() {
 }
 
 void DisplayManager::showFrame(const cv::Mat& frame) {
+    showFrame(0, frame);
+}
+
+void DisplayManager::showFrame(int outputIndex, const cv::Mat& frame) {
     if (!windowOpen || frame.empty()) return;
+    if (outputIndex < 0 || outputIndex >= static_cast<int>(outputs.size())) return;
     
-    cv::Mat scaledFrame;
-    
-    if (isFullscreen) {
-        const auto& display = displays[currentDisplayIndex];
-        // Scale frame to match display resolution in fullscreen
-        if (frame.cols != display.width || frame.rows != display.height) {
-            cv::resize(frame, scaledFrame, cv::Size(display.width, display.height));
-        } else {
-            scaledFrame = frame;
-        }
-    } else {
-        // In windowed mode, just show the frame as-is
-        scaledFrame = frame;
-    }
-    
-    cv::imshow(windowName, scaledFrame);
+    // Frames are already rendered at the output's resolution, so they go
+    // straight to the window without another resize
+    cv::imshow(outputs[outputIndex].windowName, frame);
 }
 
 char DisplayManager::handleEvents() {
@@ -10,32 +10,53 @@ struct DisplayInfo {
     bool isPrimary;
 };
 
+// One output window bound to a display
+struct OutputConfig {
+    int displayIndex;  // -1 = auto
+    int width, height; // Render resolution, 0 = native display resolution
+    
+    OutputConfig() : displayIndex(-1), width(0), height(0) {}
+};
+
 class DisplayManager {
 public:
     DisplayManager();
     ~DisplayManager();
     
     bool initialize(bool startFullscreen = false, int displayIndex = -1);
+    bool initialize(bool startFullscreen, const std::vector<OutputConfig>& outputConfigs);
     void shutdown();
     
     std::vector<DisplayInfo> getAvailableDisplays();
     bool setOutputDisplay(int displayIndex);
     void toggleFullscreen();
     
+    int getOutputCount() const { return static_cast<int>(outputs.size()); }
+    cv::Size getOutputSize(int outputIndex) const;
+    
     void showFrame(const cv::Mat& frame);
+    void showFrame(int outputIndex, const cv::Mat& frame);
     bool isWindowOpen() const { return windowOpen; }
     
     // Window event handling
     char handleEvents(); // Returns key pressed, 27 for ESC
     
 private:
+    struct OutputWindow {
+        std::string windowName;
+        int displayIndex;
+        cv::Size resolution;
+    };
+    
     std::string windowName;
     bool windowOpen;
     bool isFullscreen;
     int currentDisplayIndex;
     std::vector<DisplayInfo> displays;
+    std::vector<OutputWindow> outputs;
     
     void detectDisplays();
     void moveWindowToDisplay(int displayIndex);
+    void moveWindowToDisplay(const OutputWindow& output);
     void setFullscreen(bool fullscreen);
-};
\ No newline at end of file
+};
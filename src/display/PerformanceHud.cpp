@@ -0,0 +1,111 @@
+#include "display/PerformanceHud.h"
+#include "video/PixelKernels.h"
+#include <algorithm>
+
+PerformanceHud::PerformanceHud() : visible(false), cellWidth(0), cellHeight(0) {
+    buildAtlas();
+}
+
+void PerformanceHud::buildAtlas() {
+    const int font = cv::FONT_HERSHEY_PLAIN;
+    const double scale = 1.0;
+    int baseline = 0;
+    cv::Size glyphSize = cv::getTextSize("W", font, scale, 1, &baseline);
+    
+    cellWidth = glyphSize.width + 1;
+    cellHeight = glyphSize.height + baseline + 2;
+    
+    int glyphCount = kLastGlyph - kFirstGlyph + 1;
+    atlas = cv::Mat::zeros(cellHeight, cellWidth * glyphCount, CV_8UC1);
+    
+    for (int c = kFirstGlyph; c <= kLastGlyph; c++) {
+        cv::Mat cell = atlas(cv::Rect((c - kFirstGlyph) * cellWidth, 0, cellWidth, cellHeight));
+        cv::putText(cell, std::string(1, static_cast<char>(c)), cv::Point(0, glyphSize.height + 1),
+                    font, scale, cv::Scalar(255), 1, cv::LINE_AA);
+    }
+}
+
+void PerformanceHud::draw(cv::Mat& frame, const std::vector<uint32_t>& frameTimesUs, uint32_t targetUs) {
+    if (!visible || frame.empty() || frame.type() != CV_8UC3) return;
+    
+    size_t longest = 0;
+    for (const auto& line : textLines) {
+        longest = std::max(longest, line.size());
+    }
+    
+    const int margin = 8;
+    int panelWidth = std::max(static_cast<int>(longest) * cellWidth, 256) + margin * 2;
+    int panelHeight = static_cast<int>(textLines.size()) * cellHeight + kGraphHeight + margin * 3;
+    cv::Rect panel = cv::Rect(margin, margin, panelWidth, panelHeight) & cv::Rect(0, 0, frame.cols, frame.rows);
+    if (panel.empty()) return;
+    
+    darken(frame, panel);
+    
+    int y = panel.y + margin;
+    for (const auto& line : textLines) {
+        drawText(frame, panel.x + margin, y, line);
+        y += cellHeight;
+    }
+    
+    cv::Rect graph(panel.x + margin, y + margin, panelWidth - margin * 2, kGraphHeight);
+    drawGraph(frame, graph & panel, frameTimesUs, targetUs);
+}
+
+void PerformanceHud::darken(cv::Mat& frame, const cv::Rect& area) const {
+    cv::Mat panel = frame(area);
+    pixel::fade(panel, 0.25f);
+}
+
+void PerformanceHud::drawText(cv::Mat& frame, int x, int y, const std::string& text) const {
+    for (char ch : text) {
+        int c = static_cast<unsigned char>(ch);
+        if (c < kFirstGlyph || c > kLastGlyph) c = '?';
+        
+        if (x + cellWidth > frame.cols || y + cellHeight > frame.rows) return;
+        
+        const int atlasX = (c - kFirstGlyph) * cellWidth;
+        for (int gy = 0; gy < cellHeight; gy++) {
+            const uchar* mask = atlas.ptr<uchar>(gy) + atlasX;
+            uchar* dst = frame.ptr<uchar>(y + gy) + x * 3;
+            for (int gx = 0; gx < cellWidth; gx++) {
+                unsigned alpha = mask[gx];
+                if (!alpha) continue;
+                // White text blended by glyph coverage
+                for (int ch3 = 0; ch3 < 3; ch3++) {
+                    dst[gx * 3 + ch3] = static_cast<uchar>((dst[gx * 3 + ch3] * (255 - alpha) + 255 * alpha) / 255);
+                }
+            }
+        }
+        x += cellWidth;
+    }
+}
+
+void PerformanceHud::drawGraph(cv::Mat& frame, const cv::Rect& area, const std::vector<uint32_t>& frameTimesUs,
+                               uint32_t targetUs) const {
+    if (area.empty() || targetUs == 0) return;
+    
+    // Full height = three output intervals; the target line sits at one third
+    const uint32_t fullScaleUs = targetUs * 3;
+    const int targetRow = area.y + area.height - area.height / 3;
+    
+    int bars = std::min(area.width, static_cast<int>(frameTimesUs.size()));
+    for (int i = 0; i < bars; i++) {
+        uint32_t us = std::min(frameTimesUs[i], fullScaleUs);
+        int height = static_cast<int>(static_cast<uint64_t>(us) * area.height / fullScaleUs);
+        int x = area.x + area.width - 1 - i; // Newest on the right
+        
+        // Green within budget, red over budget
+        bool over = frameTimesUs[i] > targetUs + targetUs / 2;
+        for (int y = area.y + area.height - height; y < area.y + area.height; y++) {
+            uchar* px = frame.ptr<uchar>(y) + x * 3;
+            px[0] = 40;
+            px[1] = over ? 40 : 220;
+            px[2] = over ? 230 : 60;
+        }
+    }
+    
+    uchar* line = frame.ptr<uchar>(targetRow) + area.x * 3;
+    for (int x = 0; x < area.width; x++) {
+        line[x * 3 + 0] = line[x * 3 + 1] = line[x * 3 + 2] = 160;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+// On-screen stats overlay. Glyphs are rasterised once into an atlas, and
+// drawing is plain pixel blits into the output frame, so the overlay costs
+// microseconds rather than a cv::putText call per string per frame.
+class PerformanceHud {
+public:
+    PerformanceHud();
+    
+    void toggle() { visible = !visible; }
+    bool isVisible() const { return visible; }
+    
+    // Text changes a few times a second; the caller refreshes it when it likes
+    void setLines(const std::vector<std::string>& lines) { textLines = lines; }
+    
+    // Frame times in µs, newest first, and the output interval for scaling
+    void draw(cv::Mat& frame, const std::vector<uint32_t>& frameTimesUs, uint32_t targetUs);
+    
+private:
+    static constexpr int kFirstGlyph = 32;
+    static constexpr int kLastGlyph = 126;
+    static constexpr int kGraphHeight = 48;
+    
+    bool visible;
+    std::vector<std::string> textLines;
+    
+    cv::Mat atlas;  // CV_8UC1 coverage masks, one cell per printable ASCII char
+    int cellWidth;
+    int cellHeight;
+    
+    void buildAtlas();
+    void darken(cv::Mat& frame, const cv::Rect& area) const;
+    void drawText(cv::Mat& frame, int x, int y, const std::string& text) const;
+    void drawGraph(cv::Mat& frame, const cv::Rect& area, const std::vector<uint32_t>& frameTimesUs, uint32_t targetUs) const;
+};
@@ -1,6 +1,10 @@
 #include <iostream>
+#include <cstdio>
 #include <opencv2/opencv.hpp>
 #include "core/Application.h"
+#include "video/ClipProfiler.h"
+#include "video/PixelKernels.h"
+#include "video/VideoPlayer.h"
 
 void printUsage(const char* programName) {
     std::cout << "Usage: " << programName << " [options] [csv_file]" << std::endl;
@@ -8,7 +12,47 @@ void printUsage(const char* programName) {
     std::cout << "Options:" << std::endl;
     std::cout << "  -f, --fullscreen    Start in fullscreen mode" << std::endl;
     std::cout << "  -d, --display N     Use display N (0=primary, 1=secondary, etc.)" << std::endl;
+    std::cout << "  -o, --output D[:WxH] Add an output window on display D (repeatable)" << std::endl;
     std::cout << "  -m, --midi N        Use MIDI port N (see --list-midi for available ports)" << std::endl;
+    std::cout << "  -e, --effects FILE  CC/velocity effect mappings (default: data/effects.csv)" << std::endl;
+    std::cout << "  --shm NAME          Publish frames to shared memory /NAME (see vj-frame-reader)" << std::endl;
+    std::cout << "  --record FILE       Record output 0 to a video file (.mkv/.avi MJPEG, .mp4 MPEG-4)" << std::endl;
+    std::cout << "  --record-policy P   When the encoder falls behind: drop (oldest frames, default) or downscale" << std::endl;
+    std::cout << "  --trace FILE        Record a Chrome/Perfetto trace of the pipeline to FILE" << std::endl;
+    std::cout << "  --control-socket PATH  Accept triggers on a UNIX datagram socket (see vj-control)" << std::endl;
+    std::cout << "  --osc-port N        Accept OSC triggers on 127.0.0.1:N (/vj/trigger, /vj/cc, ...)" << std::endl;
+    std::cout << "  --metrics-port N    Serve Prometheus metrics on http://127.0.0.1:N/metrics" << std::endl;
+    std::cout << "  --metrics-file FILE Rewrite a JSON metrics snapshot to FILE periodically" << std::endl;
+    std::cout << "  --metrics-interval S  Seconds between metrics snapshots (default 10)" << std::endl;
+    std::cout << "  --record-midi FILE  Record all incoming MIDI to a .mid file" << std::endl;
+    std::cout << "  --replay-midi FILE  Replay a recorded .mid session with its original timing" << std::endl;
+    std::cout << "  --replay-speed X    Replay speed multiplier (default 1.0)" << std::endl;
+    std::cout << "  --exit-after-replay Quit shortly after the replayed session ends" << std::endl;
+    std::cout << "  --stats FILE        Write frame-time and latency stats as JSON at exit" << std::endl;
+    std::cout << "  --stress PATTERNS   Run a MIDI flood stress test and exit with pass/fail;" << std::endl;
+    std::cout << "                      PATTERNS: retrigger,chords,cc,panic or all" << std::endl;
+    std::cout << "  --stress-seconds N  Stress test duration (default 30)" << std::endl;
+    std::cout << "  --stress-budget-ms N  Longest acceptable render frame during the stress test (default 50)" << std::endl;
+    std::cout << "  --realtime          Pin threads to cores, use SCHED_FIFO and lock memory where permitted" << std::endl;
+    std::cout << "  --realtime-cpus R:M:D  CPU lists for render, MIDI and decode threads (e.g. 3:2:0-1)" << std::endl;
+    std::cout << "  --baseline FILE     Compare frame-time p99/p99.9 with an earlier --stats file at exit" << std::endl;
+    std::cout << "  --no-hugepages      Back the frame arena with normal 4 KB pages" << std::endl;
+    std::cout << "  --log FILE          Also write timestamped log messages to FILE" << std::endl;
+    std::cout << "  --log-level L       debug, info (default), warn or error" << std::endl;
+    std::cout << "  --readahead-mb N    Page-cache window read ahead of each playing clip (default 32, 0 = off)" << std::endl;
+    std::cout << "  --pin-clips-mb N    Load clips up to N MB fully into locked memory at startup" << std::endl;
+    std::cout << "  --pin-total-mb N    Total memory --pin-clips-mb may lock (default 1024)" << std::endl;
+    std::cout << "  --stall-budget-ms N Replace a clip decoder that stalls this long (default 400, 0 = off)" << std::endl;
+    std::cout << "  --audio             Play clip audio tracks, kept in sync with the picture" << std::endl;
+    std::cout << "  --audio-driver D    SDL audio driver (e.g. alsa, pulseaudio; dummy for tests without a sound card)" << std::endl;
+    std::cout << "  --audio-offset-ms N Delay audio by N ms more to match the display's latency" << std::endl;
+    std::cout << "  --output-hz N       Render rate, normally the display refresh rate (default 60)" << std::endl;
+    std::cout << "  --frc MODE          Frame-rate conversion: nearest (default), blend or off" << std::endl;
+    std::cout << "  --bench-cadence     Simulate frame-rate conversion, report judder and cadence error and exit" << std::endl;
+    std::cout << "  --profile-clips     Measure every clip's decode speed, latency, GOP and memory against the output, report and exit" << std::endl;
+    std::cout << "  --profile-out FILE  JSON report written by --profile-clips (default clip-profile.json)" << std::endl;
+    std::cout << "  --bench-kernels     Check the SIMD pixel kernels against scalar, benchmark them and exit" << std::endl;
+    std::cout << "  --check-stall FILE  Hang FILE's seek decoder mid-play, check the watchdog replaces it and exit" << std::endl;
     std::cout << "  --list-midi         List available MIDI ports and exit" << std::endl;
     std::cout << "  -h, --help          Show this help message" << std::endl;
     std::cout << std::endl;
@@ -17,10 +61,15 @@ void printUsage(const char* programName) {
     std::cout << "  " << programName << " -m 1                           # Use MIDI port 1" << std::endl;
     std::cout << "  " << programName << " -f -d 1 -m 1                   # Fullscreen, display 1, MIDI port 1" << std::endl;
     std::cout << "  " << programName << " -m 1 my_clips.csv              # Custom CSV with MIDI port 1" << std::endl;
+    std::cout << "  " << programName << " -f -o 1 -o 2:1280x720          # Projector plus a 720p LED screen" << std::endl;
+    std::cout << "  " << programName << " --replay-midi show.mid --exit-after-replay --stats run.json" << std::endl;
+    std::cout << "  " << programName << " --realtime --replay-midi show.mid --exit-after-replay --baseline run.json" << std::endl;
 }
 
 int main(int argc, char* argv[]) {
     AppConfig config;
+    bool profileClips = false;
+    std::string profilePath = "clip-profile.json";
     
     // Parse command line arguments
     for (int i = 1; i < argc; i++) {
@@ -40,6 +89,24 @@ int main(int argc, char* argv[]) {
                 std::cerr << "Error: --display requires a number" << std::endl;
                 return 1;
             }
+        } else if (arg == "-o" || arg == "--output") {
+            if (i + 1 < argc) {
+                // D or D:WIDTHxHEIGHT
+                std::string spec = argv[++i];
+                OutputConfig output;
+                output.displayIndex = std::atoi(spec.c_str());
+                size_t colon = spec.find(':');
+                if (colon != std::string::npos) {
+                    if (std::sscanf(spec.c_str() + colon + 1, "%dx%d", &output.width, &output.height) != 2) {
+                        std::cerr << "Error: --output resolution must look like 1920x1080" << std::endl;
+                        return 1;
+                    }
+                }
+                config.outputs.push_back(output);
+            } else {
+                std::cerr << "Error: --output requires a display number" << std::endl;
+                return 1;
+            }
         } else if (arg == "-m" || arg == "--midi") {
             if (i + 1 < argc) {
                 config.midiPort = std::atoi(argv[++i]);
@@ -47,6 +114,248 @@ int main(int argc, char* argv[]) {
                 std::cerr << "Error: --midi requires a number" << std::endl;
                 return 1;
             }
+        } else if (arg == "-e" || arg == "--effects") {
+            if (i + 1 < argc) {
+                config.effectsPath = argv[++i];
+            } else {
+                std::cerr << "Error: --effects requires a file" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--shm") {
+            if (i + 1 < argc) {
+                config.shmName = argv[++i];
+            } else {
+                std::cerr << "Error: --shm requires a name" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--record") {
+            if (i + 1 < argc) {
+                config.recordPath = argv[++i];
+            } else {
+                std::cerr << "Error: --record requires a file" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--record-policy") {
+            if (i + 1 >= argc || !parseRecordPolicy(argv[i + 1], config.recordPolicy)) {
+                std::cerr << "Error: --record-policy requires drop or downscale" << std::endl;
+                return 1;
+            }
+            i++;
+        } else if (arg == "--trace") {
+            if (i + 1 < argc) {
+                config.tracePath = argv[++i];
+            } else {
+                std::cerr << "Error: --trace requires a file" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--control-socket") {
+            if (i + 1 < argc) {
+                config.controlSocketPath = argv[++i];
+            } else {
+                std::cerr << "Error: --control-socket requires a path" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--osc-port") {
+            if (i + 1 < argc && std::atoi(argv[i + 1]) > 0 && std::atoi(argv[i + 1]) < 65536) {
+                config.oscPort = std::atoi(argv[++i]);
+            } else {
+                std::cerr << "Error: --osc-port requires a port number" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--metrics-port") {
+            if (i + 1 < argc && std::atoi(argv[i + 1]) > 0 && std::atoi(argv[i + 1]) < 65536) {
+                config.metricsPort = std::atoi(argv[++i]);
+            } else {
+                std::cerr << "Error: --metrics-port requires a port number" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--metrics-file") {
+            if (i + 1 < argc) {
+                config.metricsPath = argv[++i];
+            } else {
+                std::cerr << "Error: --metrics-file requires a file" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--metrics-interval") {
+            if (i + 1 < argc && std::atof(argv[i + 1]) > 0) {
+                config.metricsIntervalSeconds = std::atof(argv[++i]);
+            } else {
+                std::cerr << "Error: --metrics-interval requires a positive number of seconds" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--record-midi") {
+            if (i + 1 < argc) {
+                config.recordMidiPath = argv[++i];
+            } else {
+                std::cerr << "Error: --record-midi requires a file" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--replay-midi") {
+            if (i + 1 < argc) {
+                config.replayMidiPath = argv[++i];
+            } else {
+                std::cerr << "Error: --replay-midi requires a file" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--replay-speed") {
+            if (i + 1 < argc) {
+                config.replaySpeed = std::atof(argv[++i]);
+            } else {
+                std::cerr << "Error: --replay-speed requires a number" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--exit-after-replay") {
+            config.exitAfterReplay = true;
+        } else if (arg == "--stats") {
+            if (i + 1 < argc) {
+                config.statsPath = argv[++i];
+            } else {
+                std::cerr << "Error: --stats requires a file" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--stress") {
+            if (i + 1 < argc) {
+                config.stressTest = true;
+                std::string patterns = argv[++i];
+                size_t begin = 0;
+                while (begin <= patterns.size()) {
+                    size_t comma = patterns.find(',', begin);
+                    if (comma == std::string::npos) comma = patterns.size();
+                    if (comma > begin) config.stress.patterns.push_back(patterns.substr(begin, comma - begin));
+                    begin = comma + 1;
+                }
+            } else {
+                std::cerr << "Error: --stress requires patterns (e.g. all)" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--stress-seconds") {
+            if (i + 1 < argc) {
+                config.stress.seconds = std::atof(argv[++i]);
+            } else {
+                std::cerr << "Error: --stress-seconds requires a number" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--stress-budget-ms") {
+            if (i + 1 < argc) {
+                config.stress.stallBudgetMs = std::atof(argv[++i]);
+            } else {
+                std::cerr << "Error: --stress-budget-ms requires a number" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--realtime") {
+            config.realtime = true;
+        } else if (arg == "--realtime-cpus") {
+            std::string lists = (i + 1 < argc) ? argv[++i] : "";
+            size_t first = lists.find(':');
+            size_t second = (first == std::string::npos) ? first : lists.find(':', first + 1);
+            RealtimeConfig& rt = config.realtimeConfig;
+            if (second == std::string::npos ||
+                !Realtime::parseCpuList(lists.substr(0, first), rt.renderCpus) ||
+                !Realtime::parseCpuList(lists.substr(first + 1, second - first - 1), rt.midiCpus) ||
+                !Realtime::parseCpuList(lists.substr(second + 1), rt.decodeCpus)) {
+                std::cerr << "Error: --realtime-cpus requires render:midi:decode CPU lists (e.g. 3:2:0-1)" << std::endl;
+                return 1;
+            }
+            config.realtime = true;
+        } else if (arg == "--log") {
+            if (i + 1 < argc) {
+                config.logPath = argv[++i];
+            } else {
+                std::cerr << "Error: --log requires a file path" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--log-level") {
+            if (i + 1 >= argc || !Log::parseLevel(argv[i + 1], config.logLevel)) {
+                std::cerr << "Error: --log-level requires debug, info, warn or error" << std::endl;
+                return 1;
+            }
+            i++;
+        } else if (arg == "--readahead-mb") {
+            if (i + 1 < argc && std::atoi(argv[i + 1]) >= 0) {
+                config.readaheadMb = static_cast<size_t>(std::atoi(argv[++i]));
+            } else {
+                std::cerr << "Error: --readahead-mb requires a number" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--pin-clips-mb") {
+            if (i + 1 < argc && std::atoi(argv[i + 1]) >= 0) {
+                config.pinClipsMb = static_cast<size_t>(std::atoi(argv[++i]));
+            } else {
+                std::cerr << "Error: --pin-clips-mb requires a number" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--pin-total-mb") {
+            if (i + 1 < argc && std::atoi(argv[i + 1]) >= 0) {
+                config.pinTotalMb = static_cast<size_t>(std::atoi(argv[++i]));
+            } else {
+                std::cerr << "Error: --pin-total-mb requires a number" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--stall-budget-ms") {
+            if (i + 1 < argc && std::atoi(argv[i + 1]) >= 0) {
+                config.stallBudgetMs = static_cast<uint32_t>(std::atoi(argv[++i]));
+            } else {
+                std::cerr << "Error: --stall-budget-ms requires a number" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--audio") {
+            config.audio = true;
+        } else if (arg == "--audio-driver") {
+            if (i + 1 < argc) {
+                config.audioDriver = argv[++i];
+                config.audio = true;
+            } else {
+                std::cerr << "Error: --audio-driver requires a driver name" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--audio-offset-ms") {
+            if (i + 1 < argc) {
+                config.audioOffsetMs = std::atof(argv[++i]);
+            } else {
+                std::cerr << "Error: --audio-offset-ms requires a number" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--output-hz") {
+            if (i + 1 < argc && std::atof(argv[i + 1]) > 0) {
+                config.outputHz = std::atof(argv[++i]);
+            } else {
+                std::cerr << "Error: --output-hz requires a positive rate" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--frc") {
+            if (i + 1 >= argc || !parseFrameRateMode(argv[i + 1], config.frameRateMode)) {
+                std::cerr << "Error: --frc requires nearest, blend or off" << std::endl;
+                return 1;
+            }
+            i++;
+        } else if (arg == "--bench-cadence") {
+            return runCadenceBench() ? 0 : 1;
+        } else if (arg == "--profile-clips") {
+            profileClips = true;
+        } else if (arg == "--profile-out") {
+            if (i + 1 < argc) {
+                profilePath = argv[++i];
+            } else {
+                std::cerr << "Error: --profile-out requires a file path" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--bench-kernels") {
+            return pixel::runKernelBench() ? 0 : 1;
+        } else if (arg == "--check-stall") {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: --check-stall requires a video file" << std::endl;
+                return 1;
+            }
+            return runStallCheck(argv[i + 1]) ? 0 : 1;
+        } else if (arg == "--no-hugepages") {
+            config.hugePages = false;
+        } else if (arg == "--baseline") {
+            if (i + 1 < argc) {
+                config.baselinePath = argv[++i];
+            } else {
+                std::cerr << "Error: --baseline requires a file path" << std::endl;
+                return 1;
+            }
         } else if (arg[0] != '-') {
             // Not a flag, assume it's the CSV file
             config.csvPath = arg;
@@ -57,6 +366,18 @@ int main(int argc, char* argv[]) {
         }
     }
     
+    if (profileClips) {
+        // Measured against the largest output given a resolution; otherwise 1080p
+        cv::Size outputSize;
+        for (const OutputConfig& output : config.outputs) {
+            if (output.width * output.height > outputSize.area()) {
+                outputSize = cv::Size(output.width, output.height);
+            }
+        }
+        if (outputSize.empty()) outputSize = cv::Size(1920, 1080);
+        return runClipProfile(config.csvPath, config.outputHz, outputSize, profilePath) ? 0 : 1;
+    }
+    
     Application app;
     
     if (!app.initialize(config)) {
@@ -70,5 +391,5 @@ int main(int argc, char* argv[]) {
     std::cout << "Application initialized successfully" << std::endl;
     app.run();
     
-    return 0;
+    return app.getExitCode();
 }
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "midi/ControlState.h"
+
+ControlState::ControlState() : updateCount(0), deliveredCount(0) {
+    for (auto& value : values) {
+        value.store(0, std::memory_order_relaxed);
+    }
+    for (int channel = 0; channel < kChannels; channel++) {
+        values[kPitchBendBase + channel].store(8192, std::memory_order_relaxed); // Centred
+    }
+    for (auto& word : dirty) {
+        word.store(0, std::memory_order_relaxed);
+    }
+}
+
+void ControlState::setControl(int channel, int controller, int value) {
+    if (channel < 0 || channel >= kChannels || controller < 0 || controller >= kNumbers) return;
+    store(channel * kNumbers + controller, value);
+}
+
+void ControlState::setVelocity(int note, int velocity) {
+    if (note < 0 || note >= kNumbers) return;
+    store(kVelocityBase + note, velocity);
+}
+
+void ControlState::setPitchBend(int channel, int value) {
+    if (channel < 0 || channel >= kChannels) return;
+    store(kPitchBendBase + channel, value);
+}
+
+void ControlState::store(int slot, int value) {
+    // Publish the value before the dirty bit so a reader that sees the bit
+    // also sees a value at least as new as the one that set it
+    values[slot].store(static_cast<uint16_t>(value), std::memory_order_relaxed);
+    dirty[slot / 64].fetch_or(uint64_t(1) << (slot % 64), std::memory_order_release);
+    updateCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ControlState::drain(const std::function<void(const ControlEvent&)>& handler) {
+    uint64_t delivered = 0;
+    
+    for (int word = 0; word < kDirtyWords; word++) {
+        uint64_t bits = dirty[word].exchange(0, std::memory_order_acquire);
+        
+        while (bits) {
+            int bit = __builtin_ctzll(bits);
+            bits &= bits - 1;
+            
+            int slot = word * 64 + bit;
+            ControlEvent event;
+            event.value = values[slot].load(std::memory_order_relaxed);
+            
+            if (slot < kVelocityBase) {
+                event.type = ControlEvent::Type::ControlChange;
+                event.channel = slot / kNumbers;
+                event.number = slot % kNumbers;
+            } else if (slot < kPitchBendBase) {
+                event.type = ControlEvent::Type::Velocity;
+                event.channel = 0;
+                event.number = slot - kVelocityBase;
+            } else {
+                event.type = ControlEvent::Type::PitchBend;
+                event.channel = slot - kPitchBendBase;
+                event.number = 0;
+            }
+            
+            handler(event);
+            delivered++;
+        }
+    }
+    
+    if (delivered) {
+        deliveredCount.fetch_add(delivered, std::memory_order_relaxed);
+    }
+}
+
+int ControlState::getControl(int channel, int controller) const {
+    if (channel < 0 || channel >= kChannels || controller < 0 || controller >= kNumbers) return 0;
+    return values[channel * kNumbers + controller].load(std::memory_order_relaxed);
+}
+
+int ControlState::getVelocity(int note) const {
+    if (note < 0 || note >= kNumbers) return 0;
+    return values[kVelocityBase + note].load(std::memory_order_relaxed);
+}
+
+int ControlState::getPitchBend(int channel) const {
+    if (channel < 0 || channel >= kChannels) return 8192;
+    return values[kPitchBendBase + channel].load(std::memory_order_relaxed);
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+// A single coalesced controller update handed to the render thread
+struct ControlEvent {
+    enum class Type { ControlChange, Velocity, PitchBend };
+    
+    Type type;
+    int channel;  // 0-15 (always 0 for velocity)
+    int number;   // CC number or note number (0 for pitch bend)
+    int value;    // 0-127, or 0-16383 for pitch bend
+};
+
+// Lock-free "latest value wins" store for continuous MIDI controls.
+// The MIDI thread writes values and marks them dirty; the render thread
+// drains once per frame and sees at most one event per parameter, so a
+// 1 kHz knob sweep costs the render loop one update per frame.
+class ControlState {
+public:
+    static constexpr int kChannels = 16;
+    static constexpr int kNumbers = 128;
+    
+    ControlState();
+    
+    // Writer side (MIDI callback thread)
+    void setControl(int channel, int controller, int value);
+    void setVelocity(int note, int velocity);
+    void setPitchBend(int channel, int value);
+    
+    // Reader side (render thread)
+    void drain(const std::function<void(const ControlEvent&)>& handler);
+    
+    int getControl(int channel, int controller) const;
+    int getVelocity(int note) const;
+    int getPitchBend(int channel) const;
+    
+    uint64_t getUpdateCount() const { return updateCount.load(std::memory_order_relaxed); }
+    uint64_t getDeliveredCount() const { return deliveredCount.load(std::memory_order_relaxed); }
+    
+private:
+    static constexpr int kControlSlots = kChannels * kNumbers;
+    static constexpr int kVelocityBase = kControlSlots;
+    static constexpr int kPitchBendBase = kVelocityBase + kNumbers;
+    static constexpr int kSlots = kPitchBendBase + kChannels;
+    static constexpr int kDirtyWords = (kSlots + 63) / 64;
+    
+    std::array<std::atomic<uint16_t>, kSlots> values;
+    std::array<std::atomic<uint64_t>, kDirtyWords> dirty;
+    std::atomic<uint64_t> updateCount;
+    std::atomic<uint64_t> deliveredCount;
+    
+    void store(int slot, int value);
+};
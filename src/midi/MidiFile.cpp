@@ -0,0 +1,243 @@
+#include "midi/MidiFile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace {
+
+// 500000 µs per quarter note / 25000 ticks per quarter note = 20 µs per tick
+const uint32_t kTempoUsPerQuarter = 500000;
+const uint16_t kTicksPerQuarter = 25000;
+
+void writeU32(std::vector<unsigned char>& out, uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) out.push_back(static_cast<unsigned char>(value >> shift));
+}
+
+void writeU16(std::vector<unsigned char>& out, uint16_t value) {
+    out.push_back(static_cast<unsigned char>(value >> 8));
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+void writeVarLen(std::vector<unsigned char>& out, uint32_t value) {
+    unsigned char bytes[5];
+    int count = 0;
+    do {
+        bytes[count++] = value & 0x7F;
+        value >>= 7;
+    } while (value && count < 5);
+    
+    while (count > 1) out.push_back(bytes[--count] | 0x80);
+    out.push_back(bytes[0]);
+}
+
+struct Reader {
+    const std::vector<unsigned char>& data;
+    size_t pos;
+    size_t end;
+    
+    unsigned char byte() {
+        if (pos >= end) throw std::runtime_error("Unexpected end of MIDI file");
+        return data[pos++];
+    }
+    uint32_t u32() { uint32_t v = 0; for (int i = 0; i < 4; i++) v = (v << 8) | byte(); return v; }
+    uint16_t u16() { uint16_t v = byte(); return static_cast<uint16_t>((v << 8) | byte()); }
+    uint32_t varLen() {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++) {
+            unsigned char b = byte();
+            value = (value << 7) | (b & 0x7F);
+            if (!(b & 0x80)) return value;
+        }
+        throw std::runtime_error("Bad variable-length value in MIDI file");
+    }
+};
+
+struct TickEvent {
+    uint64_t tick;
+    int order;              // Keeps same-tick events in file order across tracks
+    bool isTempo;
+    uint32_t tempo;
+    std::vector<unsigned char> bytes;
+};
+
+int dataBytesFor(unsigned char status) {
+    switch (status & 0xF0) {
+        case 0xC0: case 0xD0: return 1;
+        default: return 2;
+    }
+}
+
+} // namespace
+
+bool MidiFile::write(const std::string& path, const std::vector<TimedMidiMessage>& messages) {
+    std::vector<unsigned char> track;
+    
+    // Tempo meta event fixing the tick length
+    track.insert(track.end(), {0x00, 0xFF, 0x51, 0x03});
+    track.push_back(static_cast<unsigned char>(kTempoUsPerQuarter >> 16));
+    track.push_back(static_cast<unsigned char>(kTempoUsPerQuarter >> 8));
+    track.push_back(static_cast<unsigned char>(kTempoUsPerQuarter));
+    
+    const double ticksPerSecond = kTicksPerQuarter * 1e6 / kTempoUsPerQuarter;
+    uint64_t lastTick = 0;
+    
+    for (const auto& message : messages) {
+        if (message.bytes.empty()) continue;
+        
+        uint64_t tick = static_cast<uint64_t>(std::llround(std::max(message.seconds, 0.0) * ticksPerSecond));
+        tick = std::max(tick, lastTick);
+        writeVarLen(track, static_cast<uint32_t>(tick - lastTick));
+        lastTick = tick;
+        
+        unsigned char status = message.bytes[0];
+        if (status == 0xF0) {
+            // SysEx: F0 <length> <bytes after F0>
+            track.push_back(0xF0);
+            writeVarLen(track, static_cast<uint32_t>(message.bytes.size() - 1));
+            track.insert(track.end(), message.bytes.begin() + 1, message.bytes.end());
+        } else if (status >= 0xF0) {
+            // Realtime/common messages have no SMF encoding; store them escaped
+            track.push_back(0xF7);
+            writeVarLen(track, static_cast<uint32_t>(message.bytes.size()));
+            track.insert(track.end(), message.bytes.begin(), message.bytes.end());
+        } else {
+            track.insert(track.end(), message.bytes.begin(), message.bytes.end());
+        }
+    }
+    
+    // End of track
+    track.insert(track.end(), {0x00, 0xFF, 0x2F, 0x00});
+    
+    std::vector<unsigned char> file = {'M', 'T', 'h', 'd'};
+    writeU32(file, 6);
+    writeU16(file, 0); // Format 0
+    writeU16(file, 1); // One track
+    writeU16(file, kTicksPerQuarter);
+    file.insert(file.end(), {'M', 'T', 'r', 'k'});
+    writeU32(file, static_cast<uint32_t>(track.size()));
+    file.insert(file.end(), track.begin(), track.end());
+    
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) return false;
+    out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    return out.good();
+}
+
+std::vector<TimedMidiMessage> MidiFile::read(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    
+    Reader reader{data, 0, data.size()};
+    if (reader.u32() != 0x4D546864) throw std::runtime_error("Not a MIDI file: " + path); // "MThd"
+    uint32_t headerLength = reader.u32();
+    size_t headerEnd = reader.pos + headerLength;
+    reader.u16(); // Format; 0 and 1 are both handled by merging tracks
+    uint16_t trackCount = reader.u16();
+    uint16_t division = reader.u16();
+    reader.pos = headerEnd;
+    
+    std::vector<TickEvent> events;
+    int order = 0;
+    
+    for (int track = 0; track < trackCount && reader.pos + 8 <= data.size(); track++) {
+        uint32_t chunkType = reader.u32();
+        uint32_t chunkLength = reader.u32();
+        size_t chunkEnd = std::min(data.size(), reader.pos + chunkLength);
+        
+        if (chunkType != 0x4D54726B) { // Skip anything that isn't "MTrk"
+            reader.pos = chunkEnd;
+            track--;
+            continue;
+        }
+        
+        Reader trackReader{data, reader.pos, chunkEnd};
+        uint64_t tick = 0;
+        unsigned char runningStatus = 0;
+        
+        while (trackReader.pos < chunkEnd) {
+            tick += trackReader.varLen();
+            unsigned char status = trackReader.byte();
+            
+            TickEvent event;
+            event.tick = tick;
+            event.order = order++;
+            event.isTempo = false;
+            event.tempo = 0;
+            
+            if (status == 0xFF) {
+                unsigned char metaType = trackReader.byte();
+                uint32_t length = trackReader.varLen();
+                if (metaType == 0x51 && length == 3) {
+                    event.isTempo = true;
+                    for (int i = 0; i < 3; i++) {
+                        event.tempo = (event.tempo << 8) | trackReader.byte();
+                    }
+                    events.push_back(event);
+                } else {
+                    trackReader.pos += length;
+                }
+                if (metaType == 0x2F) break;
+                continue;
+            }
+            
+            if (status == 0xF0 || status == 0xF7) {
+                uint32_t length = trackReader.varLen();
+                if (status == 0xF0) event.bytes.push_back(0xF0);
+                for (uint32_t i = 0; i < length; i++) event.bytes.push_back(trackReader.byte());
+                events.push_back(event);
+                continue;
+            }
+            
+            if (status < 0x80) {
+                // Running status: this byte was the first data byte
+                if (!runningStatus) throw std::runtime_error("Running status without a status byte");
+                trackReader.pos--;
+                status = runningStatus;
+            }
+            runningStatus = status;
+            
+            event.bytes.push_back(status);
+            for (int i = 0; i < dataBytesFor(status); i++) event.bytes.push_back(trackReader.byte());
+            events.push_back(event);
+        }
+        
+        reader.pos = chunkEnd;
+    }
+    
+    std::sort(events.begin(), events.end(), [](const TickEvent& a, const TickEvent& b) {
+        return a.tick != b.tick ? a.tick < b.tick : a.order < b.order;
+    });
+    
+    // Convert ticks to seconds through the tempo map
+    std::vector<TimedMidiMessage> messages;
+    bool smpte = (division & 0x8000) != 0;
+    double secondsPerTick;
+    if (smpte) {
+        int framesPerSecond = -static_cast<int8_t>(division >> 8);
+        int ticksPerFrame = division & 0xFF;
+        secondsPerTick = 1.0 / (std::max(framesPerSecond, 1) * std::max(ticksPerFrame, 1));
+    } else {
+        secondsPerTick = 500000 / 1e6 / std::max<int>(division, 1);
+    }
+    
+    double seconds = 0.0;
+    uint64_t lastTick = 0;
+    for (const auto& event : events) {
+        seconds += (event.tick - lastTick) * secondsPerTick;
+        lastTick = event.tick;
+        
+        if (event.isTempo) {
+            if (!smpte) secondsPerTick = event.tempo / 1e6 / std::max<int>(division, 1);
+        } else if (!event.bytes.empty()) {
+            messages.push_back(TimedMidiMessage{seconds, event.bytes});
+        }
+    }
+    
+    return messages;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// One MIDI message with its time from the start of the session
+struct TimedMidiMessage {
+    double seconds;
+    std::vector<unsigned char> bytes;
+};
+
+// Minimal Standard MIDI File reader/writer for session recording and replay.
+// Writes format 0 with a 20 µs tick; reads formats 0 and 1 (tracks merged,
+// tempo changes and SMPTE divisions honoured).
+class MidiFile {
+public:
+    static bool write(const std::string& path, const std::vector<TimedMidiMessage>& messages);
+    static std::vector<TimedMidiMessage> read(const std::string& path); // Throws on malformed files
+};
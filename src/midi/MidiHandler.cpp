@@ -1,8 +1,20 @@
 #include "midi/MidiHandler.h"
+#include "core/PerfCounters.h"
+#include "utils/Trace.h"
+#include "utils/Realtime.h"
+#include "utils/Log.h"
+#include "utils/Clock.h"
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 
-MidiHandler::MidiHandler() {
+namespace {
+// Longest a live message is taken to have queued behind a busy callback
+constexpr uint64_t kMaxInputLagNs = 2000000000ULL;
+}
+
+MidiHandler::MidiHandler() : tempoBpm(0.0), recording(false), recordStartNs(0), lastRecordedNs(0),
+                             droppedRecordMessages(0), lastInputNs(0) {
     midiIn = std::make_unique<RtMidiIn>();
 }
 
@@ -40,6 +52,63 @@ void MidiHandler::shutdown() {
     if (midiIn && midiIn->isPortOpen()) {
         midiIn->closePort();
     }
+    stopRecording();
+}
+
+void MidiHandler::startRecording(const std::string& path) {
+    std::lock_guard<std::mutex> lock(dispatchMutex);
+    recordPath = path;
+    recordedMessages.clear();
+    recordedMessages.reserve(1 << 16);
+    recordStartNs = lastRecordedNs = monotonicNs();
+    droppedRecordMessages = 0;
+    recording = true;
+    std::cout << "⏺️  Recording MIDI session to " << path << std::endl;
+}
+
+void MidiHandler::stopRecording() {
+    std::lock_guard<std::mutex> lock(dispatchMutex);
+    if (!recording) return;
+    recording = false;
+    
+    if (MidiFile::write(recordPath, recordedMessages)) {
+        std::cout << "⏺️  Saved " << recordedMessages.size() << " MIDI messages to " << recordPath;
+        if (droppedRecordMessages) {
+            std::cout << " (" << droppedRecordMessages << " later ones dropped: recording full)";
+        }
+        std::cout << std::endl;
+    } else {
+        std::cerr << "Cannot write MIDI session: " << recordPath << std::endl;
+    }
+}
+
+void MidiHandler::injectMessage(const std::vector<unsigned char>& message, uint64_t eventNs) {
+    handleMessage(message, eventNs);
+}
+
+void MidiHandler::handleMessage(const std::vector<unsigned char>& message, uint64_t eventNs) {
+    std::lock_guard<std::mutex> lock(dispatchMutex);
+    
+    if (recording) {
+        // A source's own timestamp may trail one already recorded from
+        // another source by a little; it is held at the last one instead
+        uint64_t stampNs = std::max(eventNs ? eventNs : monotonicNs(), lastRecordedNs);
+        lastRecordedNs = stampNs;
+        if (recordedMessages.size() < kMaxRecordedMessages) {
+            recordedMessages.push_back(TimedMidiMessage{(stampNs - recordStartNs) / 1e9, message});
+        } else if (droppedRecordMessages++ == 0) {
+            VJ_LOG_WARN("⚠ MIDI recording full ({} messages), later messages are not recorded", kMaxRecordedMessages);
+        }
+    }
+    processMidiMessage(message);
+    if (dispatchObserver) {
+        dispatchObserver(message);
+    }
+}
+
+void MidiHandler::setDispatchObserver(DispatchObserver observer) {
+    std::lock_guard<std::mutex> lock(dispatchMutex);
+    dispatchObserver = observer;
 }
 
 void MidiHandler::listMidiPorts() {
@@ -89,16 +158,36 @@ bool MidiHandler::connectToPort(int portNumber) {
 }
 
 void MidiHandler::midiCallback(double deltatime, std::vector<unsigned char>* message, void* userData) {
+    uint64_t arrivalNs = monotonicNs(); // Before anything that can wait
+    VJ_TRACE_THREAD_NAME("midi");
+    VJ_TRACE_SCOPE("midi receive");
+    Realtime::applyToCurrentThread(ThreadRole::Midi);
+    
     MidiHandler* handler = static_cast<MidiHandler*>(userData);
-    if (handler && message) {
-        handler->processMidiMessage(*message);
+    if (!handler || !message) return;
+    
+    // Each message happened deltatime after the previous one. The first
+    // one, or any that would land in the future or too far behind its
+    // arrival (clock drift, a long gap), anchors on its arrival instead.
+    uint64_t eventNs = arrivalNs;
+    if (handler->lastInputNs && deltatime >= 0) {
+        uint64_t driverNs = handler->lastInputNs + static_cast<uint64_t>(deltatime * 1e9);
+        if (driverNs <= arrivalNs && arrivalNs - driverNs < kMaxInputLagNs) {
+            eventNs = driverNs;
+        }
     }
+    handler->lastInputNs = eventNs;
+    handler->handleMessage(*message, eventNs);
 }
 
 void MidiHandler::processMidiMessage(const std::vector<unsigned char>& message) {
     if (message.size() < 1) return;
     
     unsigned char status = message[0];
+    int channel = status & 0x0F;
+    
+    PerfCounters& counters = PerfCounters::instance();
+    counters.midiMessages.fetch_add(1, std::memory_order_relaxed);
     
     // Note On: 0x90-0x9F
     if ((status & 0xF0) == 0x90 && message.size() >= 3) {
@@ -106,13 +195,15 @@ void MidiHandler::processMidiMessage(const std::vector<unsigned char>& message)
         int velocity = message[2];
         
         if (velocity > 0) {
+            counters.midiNotes.fetch_add(1, std::memory_order_relaxed);
+            controlState.setVelocity(note, velocity);
             if (noteCallback) {
-                noteCallback(note, true);
+                noteCallback(note, true, velocity);
             }
         } else {
             // Note on with velocity 0 = note off
             if (noteCallback) {
-                noteCallback(note, false);
+                noteCallback(note, false, 0);
             }
         }
     }
@@ -120,20 +211,29 @@ void MidiHandler::processMidiMessage(const std::vector<unsigned char>& message)
     else if ((status & 0xF0) == 0x80 && message.size() >= 3) {
         int note = message[1];
         if (noteCallback) {
-            noteCallback(note, false);
+            noteCallback(note, false, message[2]);
         }
     }
-    // Control Change: 0xB0-0xBF (for stop messages)
+    // Control Change: 0xB0-0xBF (stop messages and effect parameters)
     else if ((status & 0xF0) == 0xB0 && message.size() >= 3) {
         int controller = message[1];
         int value = message[2];
+        counters.midiControls.fetch_add(1, std::memory_order_relaxed);
         
         // Common stop/panic controllers
         if (controller == 123 || controller == 120) {
-            std::cout << "🛑 MIDI Stop/Panic (CC" << controller << ")" << std::endl;
+            VJ_LOG_INFO("🛑 MIDI Stop/Panic (CC{})", controller);
             if (stopCallback) {
                 stopCallback();
             }
+        } else {
+            // Knob sweeps are coalesced here; the render loop picks up the latest value
+            controlState.setControl(channel, controller, value);
         }
     }
+    // Pitch Bend: 0xE0-0xEF, 14-bit value LSB first (used for scratching)
+    else if ((status & 0xF0) == 0xE0 && message.size() >= 3) {
+        counters.midiControls.fetch_add(1, std::memory_order_relaxed);
+        controlState.setPitchBend(channel, message[1] | (message[2] << 7));
+    }
 }
\ No newline at end of file
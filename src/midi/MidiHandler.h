@@ -1,7 +1,14 @@
 #pragma once
 #include <RtMidi.h>
 #include <memory>
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "midi/ControlState.h"
+#include "midi/MidiFile.h"
 
 class MidiHandler {
 public:
@@ -12,8 +19,9 @@ public:
     void shutdown();
     
     // Callback function type for MIDI events
-    using NoteCallback = std::function<void(int note, bool isNoteOn)>;
+    using NoteCallback = std::function<void(int note, bool isNoteOn, int velocity)>;
     using StopCallback = std::function<void()>;
+    using DispatchObserver = std::function<void(const std::vector<unsigned char>& message)>;
     
     void setNoteCallback(NoteCallback callback) { noteCallback = callback; }
     void setStopCallback(StopCallback callback) { stopCallback = callback; }
@@ -23,10 +31,56 @@ public:
     int getPortCount() const;
     std::string getPortName(int portNumber) const;
     
+    // Feed a message through the same path as live input (replay, tests).
+    // `eventNs` is when it happened on the monotonic clock, if the source
+    // knows better than the moment of the call (0 = now); used when recording.
+    void injectMessage(const std::vector<unsigned char>& message, uint64_t eventNs = 0);
+    
+    // Called after every message has been handled, from whichever thread
+    // delivered it (latency probes); nullptr removes it
+    void setDispatchObserver(DispatchObserver observer);
+    
+    // Latest tempo from a control source (BPM, 0 = none yet)
+    void setTempo(double bpm) { tempoBpm.store(bpm, std::memory_order_relaxed); }
+    double getTempo() const { return tempoBpm.load(std::memory_order_relaxed); }
+    
+    // Session recording; the file is written by stopRecording()
+    void startRecording(const std::string& path);
+    void stopRecording();
+    
+    // Coalesced CC and velocity values, drained by the render loop once per frame
+    ControlState& getControlState() { return controlState; }
+    
 private:
     std::unique_ptr<RtMidiIn> midiIn;
     NoteCallback noteCallback;
     StopCallback stopCallback;
+    DispatchObserver dispatchObserver;
+    ControlState controlState;
+    std::atomic<double> tempoBpm;
+    
+    // Live input, replay and other injectors are serialised here so the
+    // application callbacks never run concurrently with each other
+    std::mutex dispatchMutex;
+    
+    // Every source is stamped on one session clock: monotonic time since
+    // recording started, never going backwards, so mixed sources interleave
+    std::string recordPath;
+    bool recording;
+    uint64_t recordStartNs;
+    uint64_t lastRecordedNs;
+    std::vector<TimedMidiMessage> recordedMessages;
+    uint64_t droppedRecordMessages; // Past kMaxRecordedMessages
+    
+    // MIDI input thread only: when the last live message happened. RtMidi's
+    // deltatime comes from the driver, so a burst queued while the callback
+    // was busy keeps its real spacing.
+    uint64_t lastInputNs;
+    
+    // About 64 MB: hours of playing, or minutes of a dense CC stream
+    static constexpr size_t kMaxRecordedMessages = 1u << 20;
+    
+    void handleMessage(const std::vector<unsigned char>& message, uint64_t eventNs);
     
     // Static callback for RtMidi (needs to be static)
     static void midiCallback(double deltatime, std::vector<unsigned char>* message, void* userData);
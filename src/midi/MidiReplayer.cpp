@@ -0,0 +1,68 @@
+#include "midi/MidiReplayer.h"
+#include "midi/MidiHandler.h"
+#include "utils/Trace.h"
+#include "utils/Realtime.h"
+#include "utils/Log.h"
+#include <chrono>
+#include <iostream>
+
+MidiReplayer::MidiReplayer() : shouldStop(false), finished(false) {
+}
+
+MidiReplayer::~MidiReplayer() {
+    stop();
+}
+
+bool MidiReplayer::load(const std::string& path) {
+    try {
+        messages = MidiFile::read(path);
+    } catch (const std::exception& e) {
+        std::cerr << "Error loading MIDI session: " << e.what() << std::endl;
+        return false;
+    }
+    
+    double length = messages.empty() ? 0.0 : messages.back().seconds;
+    std::cout << "✓ Loaded MIDI session " << path << " (" << messages.size() << " messages, "
+              << length << " s)" << std::endl;
+    return true;
+}
+
+void MidiReplayer::start(MidiHandler* handler, double speed) {
+    stop();
+    shouldStop = false;
+    finished = false;
+    replayThread = std::thread(&MidiReplayer::replayLoop, this, handler, speed > 0 ? speed : 1.0);
+}
+
+void MidiReplayer::stop() {
+    shouldStop = true;
+    if (replayThread.joinable()) {
+        replayThread.join();
+    }
+}
+
+void MidiReplayer::replayLoop(MidiHandler* handler, double speed) {
+    VJ_TRACE_THREAD_NAME("midi replay");
+    Realtime::applyToCurrentThread(ThreadRole::Midi);
+    VJ_LOG_INFO("⏯️  Replaying MIDI session at {}x", speed);
+    
+    auto start = std::chrono::steady_clock::now();
+    
+    for (const auto& message : messages) {
+        auto due = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(message.seconds / speed));
+        
+        // Sleep in short slices so stop() never waits out a long gap
+        while (!shouldStop && std::chrono::steady_clock::now() < due) {
+            std::this_thread::sleep_until(std::min(due, std::chrono::steady_clock::now() + std::chrono::milliseconds(50)));
+        }
+        if (shouldStop) break;
+        
+        handler->injectMessage(message.bytes);
+    }
+    
+    if (!shouldStop) {
+        VJ_LOG_INFO("⏹️  MIDI session replay finished");
+    }
+    finished.store(true, std::memory_order_release);
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "midi/MidiFile.h"
+
+class MidiHandler;
+
+// Replays a recorded session into MidiHandler on its own thread, through the
+// same processing path as live input, with the original timing (optionally
+// sped up).
+class MidiReplayer {
+public:
+    MidiReplayer();
+    ~MidiReplayer();
+    
+    bool load(const std::string& path);
+    void start(MidiHandler* handler, double speed = 1.0);
+    void stop();
+    
+    bool isFinished() const { return finished.load(std::memory_order_acquire); }
+    size_t getMessageCount() const { return messages.size(); }
+    
+private:
+    std::vector<TimedMidiMessage> messages;
+    std::thread replayThread;
+    std::atomic<bool> shouldStop;
+    std::atomic<bool> finished;
+    
+    void replayLoop(MidiHandler* handler, double speed);
+};
@@ -0,0 +1,203 @@
+#include "output/FrameRecorder.h"
+#include "utils/Clock.h"
+#include "utils/Log.h"
+#include "utils/Realtime.h"
+#include "utils/Trace.h"
+#include "video/PixelKernels.h"
+#include <algorithm>
+#include <iostream>
+
+bool parseRecordPolicy(const std::string& name, RecordPolicy& policy) {
+    if (name == "drop") policy = RecordPolicy::DropOldest;
+    else if (name == "downscale") policy = RecordPolicy::Downscale;
+    else return false;
+    return true;
+}
+
+FrameRecorder::FrameRecorder()
+    : recordPolicy(RecordPolicy::DropOldest), recordFps(0.0), stopping(false), sizeWarningShown(false),
+      submitted(0), submitTotalNs(0), submitMaxNs(0), encoded(0), dropped(0), repeated(0), maxQueueDepth(0),
+      encodeTotalNs(0), startNs(0), lastEncodeNs(0) {
+}
+
+FrameRecorder::~FrameRecorder() {
+    close();
+}
+
+bool FrameRecorder::open(const std::string& path, int width, int height, double fps, RecordPolicy policy) {
+    close();
+
+    outputPath = path;
+    recordPolicy = policy;
+    recordFps = fps;
+    recordSize = policy == RecordPolicy::Downscale ? cv::Size(std::max(2, (width / 2) & ~1), std::max(2, (height / 2) & ~1))
+                                                   : cv::Size(width, height);
+
+    bool mp4 = path.size() >= 4 && path.compare(path.size() - 4, 4, ".mp4") == 0;
+    int fourcc = mp4 ? cv::VideoWriter::fourcc('m', 'p', '4', 'v') : cv::VideoWriter::fourcc('M', 'J', 'P', 'G');
+    if (!writer.open(path, fourcc, fps, recordSize, true)) {
+        std::cerr << "Cannot open recording " << path << std::endl;
+        return false;
+    }
+
+    // All buffers up front: nothing is allocated while the show runs
+    pool.assign(kPoolSize, cv::Mat());
+    poolNs.assign(kPoolSize, 0);
+    freeSlots.clear();
+    queued.clear();
+    for (int i = 0; i < kPoolSize; i++) {
+        pool[i].create(recordSize, CV_8UC3);
+        freeSlots.push_back(i);
+    }
+
+    stopping = false;
+    submitted = submitTotalNs = submitMaxNs = 0;
+    encoded = dropped = repeated = encodeTotalNs = lastEncodeNs = 0;
+    maxQueueDepth = 0;
+    startNs = monotonicNs();
+    encoder = std::thread([this]() {
+        VJ_TRACE_THREAD_NAME("recorder");
+        Realtime::applyToCurrentThread(ThreadRole::Decode); // Off the render and MIDI cores
+        encoderLoop();
+    });
+
+    std::cout << "✓ Recording " << path << " (" << recordSize.width << "x" << recordSize.height << " @ "
+              << fps << " fps, " << (mp4 ? "MPEG-4" : "MJPEG")
+              << (policy == RecordPolicy::Downscale ? ", downscaled" : "") << ")" << std::endl;
+    return true;
+}
+
+void FrameRecorder::close() {
+    if (!encoder.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    queuedCondition.notify_all();
+    encoder.join();
+    writer.release();
+}
+
+void FrameRecorder::submit(const cv::Mat& frame) {
+    if (!encoder.joinable() || frame.empty()) return;
+
+    bool fullSize = frame.size() == recordSize;
+    if (frame.type() != CV_8UC3 || (recordPolicy == RecordPolicy::DropOldest && !fullSize)) {
+        if (!sizeWarningShown) {
+            VJ_LOG_WARN("⚠ Recording frame size mismatch, skipping frames");
+            sizeWarningShown = true;
+        }
+        return;
+    }
+
+    VJ_TRACE_SCOPE("record submit");
+    uint64_t start = monotonicNs();
+
+    int slot;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            // Encoder is behind: reuse the oldest frame it has not started on
+            slot = queued.front();
+            queued.pop_front();
+            dropped++;
+        }
+    }
+
+    // Copied outside the lock; only this thread touches a slot between
+    // taking it and queueing it
+    if (fullSize) {
+        frame.copyTo(pool[slot]);
+    } else {
+        pixel::scaleInto(frame, pool[slot], cv::Rect(0, 0, recordSize.width, recordSize.height));
+    }
+
+    poolNs[slot] = start;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queued.push_back(slot);
+        maxQueueDepth = std::max(maxQueueDepth, queued.size());
+    }
+    queuedCondition.notify_one();
+
+    uint64_t elapsedNs = monotonicNs() - start;
+    submitted++;
+    submitTotalNs += elapsedNs;
+    if (elapsedNs > submitMaxNs) submitMaxNs = elapsedNs;
+}
+
+void FrameRecorder::encoderLoop() {
+    // Written frame n belongs at n / fps after the first submit. The slot
+    // last written is held back from the pool, so it can be written again
+    // when the next frame arrives late.
+    const double framesPerNs = recordFps / 1e9;
+    uint64_t firstNs = 0;
+    int64_t written = 0;
+    int heldSlot = -1;
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        queuedCondition.wait(lock, [this]() { return stopping || !queued.empty(); });
+        if (queued.empty()) break; // Stopping with everything written
+
+        int slot = queued.front();
+        queued.pop_front();
+
+        lock.unlock();
+        uint64_t start = monotonicNs();
+        if (!firstNs) firstNs = poolNs[slot];
+        int64_t due = static_cast<int64_t>((poolNs[slot] - firstNs) * framesPerNs + 0.5);
+        int64_t repeats = 0;
+        bool write = due >= written - 1; // Up to a frame early is jitter, not worth a drop
+        {
+            VJ_TRACE_SCOPE("encode");
+            for (; heldSlot >= 0 && written < due; written++, repeats++) {
+                writer.write(pool[heldSlot]);
+            }
+            if (write) {
+                writer.write(pool[slot]);
+                written++;
+            }
+        }
+        uint64_t end = monotonicNs();
+        lock.lock();
+
+        if (write) {
+            if (heldSlot >= 0) freeSlots.push_back(heldSlot);
+            heldSlot = slot;
+            encoded++;
+        } else {
+            freeSlots.push_back(slot);
+            dropped++;
+        }
+        repeated += repeats;
+        encodeTotalNs += end - start;
+        lastEncodeNs = end;
+    }
+    if (heldSlot >= 0) freeSlots.push_back(heldSlot);
+}
+
+FrameRecorder::Stats FrameRecorder::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return {encoded, dropped, repeated, queued.size()};
+}
+
+void FrameRecorder::printStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (submitted == 0) return;
+
+    double seconds = lastEncodeNs > startNs ? (lastEncodeNs - startNs) / 1e9 : 0.0;
+    std::cout << "📼 Recording " << outputPath << ": " << encoded << " frames encoded";
+    if (seconds > 0) {
+        std::cout << " (" << encoded / seconds << " fps)";
+    }
+    std::cout << ", " << dropped << " dropped, " << repeated << " repeated to keep time, queue max "
+              << maxQueueDepth << "/" << kPoolSize
+              << ", encode avg " << (encoded ? encodeTotalNs / encoded / 1e6 : 0.0) << " ms"
+              << ", submit avg " << (submitTotalNs / submitted) / 1000.0 << " µs, max "
+              << submitMaxNs / 1000.0 << " µs" << std::endl;
+}
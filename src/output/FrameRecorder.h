@@ -0,0 +1,81 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// What the recorder gives up when the encoder falls behind
+enum class RecordPolicy {
+    DropOldest, // Full resolution; the oldest queued frame makes room for the newest
+    Downscale   // Half resolution (a quarter of the encode work); drops only as a last resort
+};
+
+bool parseRecordPolicy(const std::string& name, RecordPolicy& policy);
+
+// Archival recording of the composited output. The render thread copies
+// each frame into a buffer from a fixed pool and queues it; an encoder
+// thread writes queued frames with cv::VideoWriter and returns the buffers.
+// Submitting never waits: when every buffer is taken, the oldest queued
+// frame is dropped instead, so encoding cannot back-pressure the render loop.
+// Frames carry their submit time, and the encoder repeats the previous frame
+// over any gap (drops, slow ticks), so the file keeps to show time.
+class FrameRecorder {
+public:
+    static constexpr int kPoolSize = 8;
+
+    struct Stats {
+        uint64_t encoded;
+        uint64_t dropped;
+        uint64_t repeated; // Extra writes of a frame to fill a gap in time
+        size_t queueDepth;
+    };
+
+    FrameRecorder();
+    ~FrameRecorder();
+
+    // The codec follows the extension: .mp4 = MPEG-4, anything else (.mkv, .avi) = MJPEG
+    bool open(const std::string& path, int width, int height, double fps, RecordPolicy policy);
+    void close(); // Encodes whatever is still queued
+    bool isOpen() const { return encoder.joinable(); }
+
+    void submit(const cv::Mat& frame);
+    Stats getStats() const;
+    void printStats() const;
+
+private:
+    std::string outputPath;
+    RecordPolicy recordPolicy;
+    cv::Size recordSize;
+    cv::VideoWriter writer;
+
+    double recordFps;
+    std::vector<cv::Mat> pool;
+    std::vector<uint64_t> poolNs; // Submit time of the frame in each slot
+    std::vector<int> freeSlots;
+    std::deque<int> queued;
+    bool stopping;
+    mutable std::mutex mutex;
+    std::condition_variable queuedCondition;
+    std::thread encoder;
+    bool sizeWarningShown;
+
+    // Render side
+    uint64_t submitted;
+    uint64_t submitTotalNs;
+    uint64_t submitMaxNs;
+
+    // Encoder side, under mutex
+    uint64_t encoded;
+    uint64_t dropped;
+    uint64_t repeated;
+    size_t maxQueueDepth;
+    uint64_t encodeTotalNs;
+    uint64_t startNs;
+    uint64_t lastEncodeNs;
+
+    void encoderLoop();
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+// Memory layout of the POSIX shared-memory frame ring. Shared between the
+// writer in vj-app and any local reader (see tools/frame_reader.cpp).
+//
+//   [RingHeader][pad to 4096][SlotHeader + pixels][SlotHeader + pixels]...
+//
+// Each slot is a seqlock: the writer makes `sequence` odd while copying and
+// even when done. Readers never take locks; they read `sequence`, use the
+// pixels in place, then re-read `sequence` and discard the frame if it moved.
+namespace vjshm {
+
+constexpr uint32_t kMagic = 0x564A4652;   // "VJFR"
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kFormatBGR24 = 1;      // 8-bit B,G,R interleaved
+constexpr size_t kPageSize = 4096;
+
+struct alignas(64) RingHeader {
+    std::atomic<uint32_t> magic;       // Written last; readers wait for kMagic
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;      // Bytes per pixel row
+    uint32_t format;
+    uint32_t slotCount;
+    uint32_t reserved;
+    uint64_t slotSize;    // Bytes per slot including its SlotHeader
+    uint64_t dataOffset;  // Offset of slot 0 from the start of the mapping
+    std::atomic<uint64_t> latestFrame; // Counter of the newest complete frame, 0 = none yet
+};
+
+struct alignas(64) SlotHeader {
+    std::atomic<uint64_t> sequence;    // Odd while being written
+    uint64_t frameCounter;
+    uint64_t timestampNs;              // CLOCK_MONOTONIC at publish
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Cross-process atomics must be lock-free");
+
+inline size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+inline size_t slotPixelOffset() {
+    return alignUp(sizeof(SlotHeader), 64);
+}
+
+inline size_t ringSize(uint32_t stride, uint32_t height, uint32_t slotCount, uint64_t* slotSize, uint64_t* dataOffset) {
+    *dataOffset = alignUp(sizeof(RingHeader), kPageSize);
+    *slotSize = alignUp(slotPixelOffset() + static_cast<size_t>(stride) * height, kPageSize);
+    return *dataOffset + *slotSize * slotCount;
+}
+
+} // namespace vjshm
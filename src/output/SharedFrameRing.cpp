@@ -0,0 +1,145 @@
+#include "output/SharedFrameRing.h"
+#include <iostream>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+SharedFrameRing::SharedFrameRing()
+    : fd(-1), mapping(nullptr), mappingSize(0), header(nullptr), frameCounter(0),
+      sizeWarningShown(false), publishCount(0), publishTotalNs(0), publishMaxNs(0) {
+}
+
+SharedFrameRing::~SharedFrameRing() {
+    close();
+}
+
+bool SharedFrameRing::open(const std::string& name, int width, int height, int slotCount) {
+    close();
+    
+    shmName = (!name.empty() && name[0] == '/') ? name : "/" + name;
+    uint32_t stride = static_cast<uint32_t>(width) * 3;
+    uint64_t slotSize = 0;
+    uint64_t dataOffset = 0;
+    mappingSize = vjshm::ringSize(stride, height, slotCount, &slotSize, &dataOffset);
+    
+    fd = shm_open(shmName.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cerr << "Cannot create shared memory " << shmName << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    
+    if (ftruncate(fd, static_cast<off_t>(mappingSize)) != 0) {
+        std::cerr << "Cannot size shared memory " << shmName << ": " << std::strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    
+    void* address = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    if (address == MAP_FAILED) {
+        std::cerr << "Cannot map shared memory " << shmName << ": " << std::strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    mapping = static_cast<uint8_t*>(address);
+    
+    // Invalidate first so a reader attached to a previous run's ring never
+    // mistakes the half-initialised header for a live one
+    header = reinterpret_cast<vjshm::RingHeader*>(mapping);
+    header->magic.store(0, std::memory_order_release);
+    
+    header->version = vjshm::kVersion;
+    header->width = static_cast<uint32_t>(width);
+    header->height = static_cast<uint32_t>(height);
+    header->stride = stride;
+    header->format = vjshm::kFormatBGR24;
+    header->slotCount = static_cast<uint32_t>(slotCount);
+    header->reserved = 0;
+    header->slotSize = slotSize;
+    header->dataOffset = dataOffset;
+    header->latestFrame.store(0, std::memory_order_relaxed);
+    
+    for (int i = 0; i < slotCount; i++) {
+        auto* slot = reinterpret_cast<vjshm::SlotHeader*>(mapping + dataOffset + slotSize * i);
+        slot->sequence.store(0, std::memory_order_relaxed);
+        slot->frameCounter = 0;
+        slot->timestampNs = 0;
+    }
+    
+    header->magic.store(vjshm::kMagic, std::memory_order_release);
+    
+    frameCounter = 0;
+    std::cout << "✓ Shared memory output " << shmName << " (" << width << "x" << height
+              << ", " << slotCount << " slots, " << (mappingSize >> 20) << " MB)" << std::endl;
+    return true;
+}
+
+void SharedFrameRing::close() {
+    if (mapping) {
+        munmap(mapping, mappingSize);
+        mapping = nullptr;
+        header = nullptr;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+        shm_unlink(shmName.c_str());
+    }
+}
+
+void SharedFrameRing::publish(const cv::Mat& frame) {
+    if (!header || frame.empty()) return;
+    
+    if (frame.type() != CV_8UC3 || frame.cols != static_cast<int>(header->width) ||
+        frame.rows != static_cast<int>(header->height)) {
+        if (!sizeWarningShown) {
+            std::cerr << "⚠ Shared memory frame size mismatch, skipping frames" << std::endl;
+            sizeWarningShown = true;
+        }
+        return;
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    
+    uint64_t counter = ++frameCounter;
+    size_t slotIndex = counter % header->slotCount;
+    uint8_t* slotBase = mapping + header->dataOffset + header->slotSize * slotIndex;
+    auto* slot = reinterpret_cast<vjshm::SlotHeader*>(slotBase);
+    uint8_t* pixels = slotBase + vjshm::slotPixelOffset();
+    
+    // Seqlock write: odd while the pixels are in flux
+    slot->sequence.store(counter * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    
+    size_t rowBytes = header->stride;
+    if (frame.isContinuous()) {
+        std::memcpy(pixels, frame.data, rowBytes * frame.rows);
+    } else {
+        for (int y = 0; y < frame.rows; y++) {
+            std::memcpy(pixels + rowBytes * y, frame.ptr(y), rowBytes);
+        }
+    }
+    
+    slot->frameCounter = counter;
+    slot->timestampNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        start.time_since_epoch()).count());
+    
+    slot->sequence.store(counter * 2 + 2, std::memory_order_release);
+    header->latestFrame.store(counter, std::memory_order_release);
+    
+    uint64_t elapsedNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    publishCount++;
+    publishTotalNs += elapsedNs;
+    if (elapsedNs > publishMaxNs) publishMaxNs = elapsedNs;
+}
+
+void SharedFrameRing::printStats() const {
+    if (publishCount == 0) return;
+    
+    std::cout << "📤 Shared memory " << shmName << ": " << publishCount << " frames, publish avg "
+              << (publishTotalNs / publishCount) / 1000.0 << " µs, max "
+              << publishMaxNs / 1000.0 << " µs" << std::endl;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <string>
+#include "output/SharedFrameFormat.h"
+
+// Publishes composited frames into a POSIX shared-memory ring so local
+// processes (recorders, streamers, previews) can read them without a
+// screen grab. Publishing never waits for readers.
+class SharedFrameRing {
+public:
+    SharedFrameRing();
+    ~SharedFrameRing();
+    
+    bool open(const std::string& name, int width, int height, int slotCount = 3);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+    
+    void publish(const cv::Mat& frame);
+    void printStats() const;
+    
+private:
+    std::string shmName;
+    int fd;
+    uint8_t* mapping;
+    size_t mappingSize;
+    vjshm::RingHeader* header;
+    uint64_t frameCounter;
+    bool sizeWarningShown;
+    
+    // Publish cost, measured on the render thread
+    uint64_t publishCount;
+    uint64_t publishTotalNs;
+    uint64_t publishMaxNs;
+};
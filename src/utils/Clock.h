@@ -0,0 +1,9 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+// Monotonic nanoseconds (CLOCK_MONOTONIC on Linux), comparable across threads and processes
+inline uint64_t monotonicNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
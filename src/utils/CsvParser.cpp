@@ -14,10 +14,20 @@ std::vector<ClipData> CsvParser::parseClipsFile(const std::string& filename) {
     
     std::string line;
     bool isFirstLine = true;
+    int outputsColumn = -1;
+    int cuesColumn = -1;
+    int fpsColumn = -1;
     
     while (std::getline(file, line)) {
         if (isFirstLine) {
-            isFirstLine = false; // Skip header line
+            isFirstLine = false;
+            // The first three columns are positional; optional ones are found by header name
+            auto header = splitLine(line, ',');
+            for (size_t i = 3; i < header.size(); i++) {
+                if (header[i] == "outputs") outputsColumn = static_cast<int>(i);
+                if (header[i] == "cues") cuesColumn = static_cast<int>(i);
+                if (header[i] == "fps") fpsColumn = static_cast<int>(i);
+            }
             continue;
         }
         
@@ -29,6 +39,15 @@ std::vector<ClipData> CsvParser::parseClipsFile(const std::string& filename) {
             clip.path = parts[0];
             clip.startNote = parts[1];
             clip.stopNote = parts[2];
+            if (outputsColumn >= 0 && outputsColumn < static_cast<int>(parts.size())) {
+                clip.outputs = parts[outputsColumn];
+            }
+            if (cuesColumn >= 0 && cuesColumn < static_cast<int>(parts.size())) {
+                clip.cues = parts[cuesColumn];
+            }
+            if (fpsColumn >= 0 && fpsColumn < static_cast<int>(parts.size())) {
+                clip.fps = parts[fpsColumn];
+            }
             clips.push_back(clip);
         }
     }
@@ -36,6 +55,41 @@ std::vector<ClipData> CsvParser::parseClipsFile(const std::string& filename) {
     return clips;
 }
 
+std::vector<EffectMappingData> CsvParser::parseEffectsFile(const std::string& filename) {
+    std::vector<EffectMappingData> mappings;
+    std::ifstream file(filename);
+    
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    
+    std::string line;
+    bool isFirstLine = true;
+    
+    while (std::getline(file, line)) {
+        if (isFirstLine) {
+            isFirstLine = false; // Skip header line
+            continue;
+        }
+        
+        if (line.empty() || line[0] == '#') continue;
+        
+        auto parts = splitLine(line, ',');
+        if (parts.size() >= 6) {
+            EffectMappingData mapping;
+            mapping.target = parts[0];
+            mapping.effect = parts[1];
+            mapping.source = parts[2];
+            mapping.number = parts[3];
+            mapping.min = parts[4];
+            mapping.max = parts[5];
+            mappings.push_back(mapping);
+        }
+    }
+    
+    return mappings;
+}
+
 std::vector<std::string> CsvParser::splitLine(const std::string& line, char delimiter) {
     std::vector<std::string> tokens;
     std::stringstream ss(line);
@@ -48,6 +102,37 @@ std::vector<std::string> CsvParser::splitLine(const std::string& line, char deli
     return tokens;
 }
 
+std::vector<int> CsvParser::parseIndexList(const std::string& list) {
+    std::vector<int> indices;
+    
+    for (const auto& token : splitLine(list, '|')) {
+        if (token.empty()) continue;
+        try {
+            indices.push_back(std::stoi(token));
+        } catch (const std::exception&) {
+            // Skip anything that isn't a number
+        }
+    }
+    
+    return indices;
+}
+
+std::vector<CueData> CsvParser::parseCueList(const std::string& list) {
+    std::vector<CueData> cues;
+    
+    for (const auto& token : splitLine(list, '|')) {
+        size_t at = token.find('@');
+        if (at == std::string::npos) continue;
+        
+        CueData cue;
+        cue.note = token.substr(0, at);
+        cue.seconds = token.substr(at + 1);
+        cues.push_back(cue);
+    }
+    
+    return cues;
+}
+
 // In CsvParser.cpp, update noteStringToMidi to handle numbers
 int CsvParser::noteStringToMidi(const std::string& note) {
     // If it's already a number, just convert it
@@ -6,12 +6,32 @@ struct ClipData {
     std::string path;
     std::string startNote;
     std::string stopNote;
+    std::string outputs;   // Optional "outputs" column, e.g. "0|1"
+    std::string cues;      // Optional "cues" column, e.g. "28@12.5|C3@30"
+    std::string fps;       // Optional "fps" column, playback rate of image sequences
+};
+
+struct CueData {
+    std::string note;
+    std::string seconds;
+};
+
+struct EffectMappingData {
+    std::string target;  // clip path, or "master"
+    std::string effect;  // brightness, contrast, hue, ...
+    std::string source;  // "cc" or "velocity"
+    std::string number;  // CC number, or note number for velocity (optional)
+    std::string min;
+    std::string max;
 };
 
 class CsvParser {
 public:
     static std::vector<ClipData> parseClipsFile(const std::string& filename);
+    static std::vector<EffectMappingData> parseEffectsFile(const std::string& filename);
     static int noteStringToMidi(const std::string& note); // C1 -> 24, etc.
+    static std::vector<int> parseIndexList(const std::string& list); // "0|2" -> {0, 2}
+    static std::vector<CueData> parseCueList(const std::string& list); // "28@12.5|29@30"
     
 private:
     static std::vector<std::string> splitLine(const std::string& line, char delimiter);
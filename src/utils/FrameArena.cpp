@@ -0,0 +1,240 @@
+#include "utils/FrameArena.h"
+#include "utils/Realtime.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <sys/mman.h>
+
+static bool installed = false;
+
+FrameArena::FrameArena() : useHugePages(true) {
+}
+
+FrameArena& FrameArena::instance() {
+    // Never destroyed: Mats released during static destruction still call back here
+    static FrameArena* arena = new FrameArena();
+    return *arena;
+}
+
+void FrameArena::install(bool hugePages) {
+    FrameArena& arena = instance();
+    arena.useHugePages = hugePages;
+    cv::Mat::setDefaultAllocator(&arena);
+    installed = true;
+}
+
+bool FrameArena::isInstalled() {
+    return installed;
+}
+
+size_t FrameArena::blockSizeFor(size_t bytes) {
+    return (bytes + 4095) & ~size_t(4095); // Page granular, so 64-byte aligned as well
+}
+
+void FrameArena::reserve(cv::Size size, int type, int count) {
+    if (!installed) return;
+    size_t blockBytes = blockSizeFor(static_cast<size_t>(size.width) * size.height * CV_ELEM_SIZE(type));
+    if (blockBytes < kArenaThreshold) return;
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    int available = static_cast<int>(freeBlocks[blockBytes].size());
+    while (available < count && mapSlab(blockBytes)) {
+        available = static_cast<int>(freeBlocks[blockBytes].size());
+    }
+}
+
+bool FrameArena::mapSlab(size_t blockBytes) const {
+    // Caller holds mutex
+    size_t slabBytes = (blockBytes * kBlocksPerSlab + kHugePage - 1) & ~(kHugePage - 1);
+    uint8_t* base = nullptr;
+    PageMode mode = PageMode::Normal;
+    
+    if (useHugePages) {
+        void* mapped = mmap(nullptr, slabBytes, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mapped != MAP_FAILED) {
+            base = static_cast<uint8_t*>(mapped);
+            mode = PageMode::Explicit;
+        }
+    }
+    
+    if (!base) {
+        // Over-map by one huge page and trim, so the slab starts on a 2 MB
+        // boundary and the kernel can back it with transparent huge pages
+        size_t mappedBytes = slabBytes + kHugePage;
+        void* mapped = mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapped == MAP_FAILED) return false;
+        
+        uintptr_t start = reinterpret_cast<uintptr_t>(mapped);
+        uintptr_t aligned = (start + kHugePage - 1) & ~(uintptr_t(kHugePage) - 1);
+        if (aligned > start) {
+            munmap(mapped, aligned - start);
+        }
+        size_t tail = (start + mappedBytes) - (aligned + slabBytes);
+        if (tail) {
+            munmap(reinterpret_cast<void*>(aligned + slabBytes), tail);
+        }
+        base = reinterpret_cast<uint8_t*>(aligned);
+        
+        if (useHugePages && madvise(base, slabBytes, MADV_HUGEPAGE) == 0) {
+            mode = PageMode::Transparent;
+        }
+    }
+    
+    // Realtime mode without MCL_FUTURE: slabs are the memory worth locking,
+    // and one past the limit just stays unlocked
+    if (Realtime::isEnabled() && !Realtime::locksFutureMemory() && mlock(base, slabBytes) == 0) {
+        stats.lockedSlabs++;
+    }
+    
+    Slab slab{base, slabBytes, blockBytes, mode};
+    slabs.insert(std::upper_bound(slabs.begin(), slabs.end(), slab,
+                                  [](const Slab& a, const Slab& b) { return a.base < b.base; }),
+                 slab);
+    stats.slabs++;
+    stats.mappedBytes += slabBytes;
+    if (mode == PageMode::Explicit) stats.explicitSlabs++;
+    if (mode == PageMode::Transparent) stats.transparentSlabs++;
+    
+    // Room for every block of this size up front, so returning one to the
+    // pool never reallocates
+    auto& pool = freeBlocks[blockBytes];
+    size_t count = slabBytes / blockBytes;
+    pool.reserve(pool.capacity() + count);
+    for (size_t offset = 0; offset + blockBytes <= slabBytes; offset += blockBytes) {
+        pool.push_back(base + offset);
+    }
+    return true;
+}
+
+const FrameArena::Slab* FrameArena::findSlab(const uint8_t* block) const {
+    // Caller holds mutex
+    auto it = std::upper_bound(slabs.begin(), slabs.end(), block,
+                               [](const uint8_t* address, const Slab& slab) { return address < slab.base; });
+    if (it == slabs.begin()) return nullptr;
+    --it;
+    return block < it->base + it->bytes ? &*it : nullptr;
+}
+
+uint8_t* FrameArena::takeBlock(size_t bytes) const {
+    size_t blockBytes = blockSizeFor(bytes);
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    auto pool = freeBlocks.find(blockBytes);
+    if (pool == freeBlocks.end()) return nullptr; // Not a reserved size
+    if (pool->second.empty() && !mapSlab(blockBytes)) {
+        stats.fallbacks++;
+        return nullptr;
+    }
+    
+    uint8_t* block = pool->second.back();
+    pool->second.pop_back();
+    
+    stats.arenaAllocations++;
+    stats.usedBytes += blockBytes;
+    if (stats.usedBytes > stats.peakUsedBytes) {
+        stats.peakUsedBytes = stats.usedBytes;
+    }
+    return block;
+}
+
+bool FrameArena::giveBlock(uint8_t* block) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    const Slab* slab = findSlab(block);
+    if (!slab) return false; // Came from the heap
+    
+    // Blocks stay mapped and pooled: the same frame sizes come straight back
+    freeBlocks.find(slab->blockBytes)->second.push_back(block);
+    stats.usedBytes -= slab->blockBytes;
+    return true;
+}
+
+cv::UMatData* FrameArena::allocate(int dims, const int* sizes, int type, void* data0, size_t* step,
+                                   cv::AccessFlag, cv::UMatUsageFlags) const {
+    // Same layout rules as OpenCV's own StdMatAllocator
+    size_t total = CV_ELEM_SIZE(type);
+    for (int i = dims - 1; i >= 0; i--) {
+        if (step) {
+            if (data0 && step[i] != CV_AUTOSTEP) {
+                total = step[i];
+            } else {
+                step[i] = total;
+            }
+        }
+        total *= sizes[i];
+    }
+    
+    uint8_t* data = static_cast<uint8_t*>(data0);
+    if (!data) {
+        if (total >= kArenaThreshold) {
+            data = takeBlock(total);
+        }
+        if (!data) {
+            void* heap = nullptr;
+            if (posix_memalign(&heap, 64, total ? total : 64) != 0) {
+                throw std::bad_alloc();
+            }
+            data = static_cast<uint8_t*>(heap);
+            std::lock_guard<std::mutex> lock(mutex);
+            stats.heapAllocations++;
+        }
+    }
+    
+    cv::UMatData* u = new cv::UMatData(this);
+    u->data = u->origdata = data;
+    u->size = total;
+    if (data0) {
+        u->flags |= cv::UMatData::USER_ALLOCATED;
+    }
+    return u;
+}
+
+bool FrameArena::allocate(cv::UMatData* u, cv::AccessFlag, cv::UMatUsageFlags) const {
+    return u != nullptr; // Host memory only; nothing to map
+}
+
+void FrameArena::deallocate(cv::UMatData* u) const {
+    if (!u) return;
+    
+    CV_Assert(u->urefcount == 0);
+    CV_Assert(u->refcount == 0);
+    if (!(u->flags & cv::UMatData::USER_ALLOCATED)) {
+        if (!giveBlock(u->origdata)) {
+            std::free(u->origdata);
+        }
+        u->origdata = nullptr;
+    }
+    delete u;
+}
+
+FrameArena::Stats FrameArena::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void FrameArena::printStats() const {
+    if (!installed) return;
+    Stats current = getStats();
+    
+    // How much the kernel actually backs with transparent huge pages
+    uint64_t anonHugeKb = 0;
+    std::ifstream rollup("/proc/self/smaps_rollup");
+    std::string line;
+    while (std::getline(rollup, line)) {
+        if (line.compare(0, 14, "AnonHugePages:") == 0) {
+            anonHugeKb = std::stoull(line.substr(14));
+        }
+    }
+    
+    std::cout << "🧱 Frame arena: " << current.slabs << " slabs (" << current.explicitSlabs << " hugetlb, "
+              << current.transparentSlabs << " THP"
+              << (current.lockedSlabs ? ", " + std::to_string(current.lockedSlabs) + " mlocked" : "") << "), "
+              << (current.mappedBytes >> 20) << " MB mapped, peak "
+              << (current.peakUsedBytes >> 20) << " MB used" << std::endl;
+    std::cout << "   " << current.arenaAllocations << " arena allocations, " << current.heapAllocations
+              << " heap, " << current.fallbacks << " fallbacks; AnonHugePages " << (anonHugeKb >> 10) << " MB"
+              << std::endl;
+}
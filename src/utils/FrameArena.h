@@ -0,0 +1,76 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// Frame-buffer allocator installed as OpenCV's default MatAllocator, so
+// decoded frames, compositor surfaces, effect buffers and the copies
+// highgui makes for the windows all come from it. Large allocations are
+// carved from 64-byte aligned slabs backed by huge pages (explicit
+// hugetlbfs pages when reserved, otherwise transparent huge pages) to cut
+// TLB misses; freed blocks are pooled per size. Only sizes announced with
+// reserve() get slabs. Small allocations, other sizes, and anything the
+// kernel refuses fall back to ordinary aligned heap memory.
+class FrameArena : public cv::MatAllocator {
+public:
+    enum class PageMode { Explicit, Transparent, Normal };
+    
+    struct Stats {
+        uint64_t slabs = 0;
+        uint64_t explicitSlabs = 0;
+        uint64_t transparentSlabs = 0;
+        uint64_t lockedSlabs = 0;      // mlocked here because realtime mode could not lock future memory
+        uint64_t mappedBytes = 0;
+        uint64_t usedBytes = 0;
+        uint64_t peakUsedBytes = 0;
+        uint64_t arenaAllocations = 0;
+        uint64_t heapAllocations = 0;  // Small, unreserved-size or fallback allocations
+        uint64_t fallbacks = 0;        // Large allocations the arena could not serve
+    };
+    
+    static FrameArena& instance();
+    
+    // Makes this the allocator for every new cv::Mat; call before frames exist
+    static void install(bool useHugePages);
+    static bool isInstalled();
+    
+    // Makes this a frame size the arena serves, and pre-maps slab space for
+    // `count` frames of it so they don't fault pages in mid-show
+    void reserve(cv::Size size, int type, int count);
+    
+    Stats getStats() const;
+    void printStats() const;
+    
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override;
+    bool allocate(cv::UMatData* data, cv::AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const override;
+    void deallocate(cv::UMatData* data) const override;
+    
+private:
+    static constexpr size_t kHugePage = 2u << 20;
+    static constexpr size_t kArenaThreshold = 512u << 10; // Smaller goes to the heap
+    static constexpr int kBlocksPerSlab = 4;
+    
+    struct Slab {
+        uint8_t* base;
+        size_t bytes;
+        size_t blockBytes;
+        PageMode mode;
+    };
+    
+    mutable std::mutex mutex;
+    mutable std::vector<Slab> slabs;                            // Sorted by base, to find a block's slab
+    mutable std::map<size_t, std::vector<uint8_t*>> freeBlocks; // By reserved block size
+    mutable Stats stats;
+    bool useHugePages;
+    
+    FrameArena();
+    
+    uint8_t* takeBlock(size_t bytes) const;
+    bool giveBlock(uint8_t* block) const;
+    bool mapSlab(size_t blockBytes) const;
+    const Slab* findSlab(const uint8_t* block) const;
+    static size_t blockSizeFor(size_t bytes);
+};
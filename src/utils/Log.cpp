@@ -0,0 +1,328 @@
+#include "utils/Log.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+using logdetail::ArgType;
+using logdetail::Record;
+
+namespace {
+
+// One per thread: the owner advances head, the writer advances tail. Rings
+// of exited threads are handed to new threads once drained, so short-lived
+// decoder threads don't grow the registry.
+struct ThreadRing {
+    static constexpr size_t kCapacity = 1024; // Power of two
+
+    int tid = 0;
+    bool owned = true; // Guarded by registryMutex
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> tail{0};
+    Record slots[kCapacity];
+};
+
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadRing>> registry;
+
+std::atomic<bool> running{false};
+std::atomic<uint64_t> droppedCount{0};
+std::thread writerThread;
+std::mutex writerMutex;
+std::condition_variable writerWake;
+std::condition_variable passDone;
+uint64_t passCount = 0;   // Guarded by writerMutex
+bool stopRequested = false;
+
+FILE* logFile = nullptr;
+uint64_t startNs = 0;
+std::mutex syncMutex; // Serialises synchronous writes before start()/after stop()
+
+ThreadRing* acquireRing() {
+    std::lock_guard<std::mutex> lock(registryMutex); // Once per thread, never per message
+    for (auto& ring : registry) {
+        if (!ring->owned && ring->head.load(std::memory_order_acquire) == ring->tail.load(std::memory_order_acquire)) {
+            ring->owned = true;
+            ring->tid = static_cast<int>(syscall(SYS_gettid));
+            return ring.get();
+        }
+    }
+    registry.push_back(std::make_unique<ThreadRing>());
+    registry.back()->tid = static_cast<int>(syscall(SYS_gettid));
+    return registry.back().get();
+}
+
+// Releases the thread's ring when the thread exits
+struct RingHandle {
+    ThreadRing* ring = nullptr;
+    ~RingHandle() {
+        if (ring) {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            ring->owned = false;
+        }
+    }
+};
+
+thread_local RingHandle threadRing;
+thread_local Record syncRecord;
+
+const char* levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info:  return "INFO ";
+        case LogLevel::Warn:  return "WARN ";
+        case LogLevel::Error: return "ERROR";
+    }
+    return "?";
+}
+
+void appendArg(std::string& out, const Record& record, int index) {
+    const Record::Value& value = record.values[index];
+    char buffer[32];
+    switch (record.types[index]) {
+        case ArgType::Int:
+            out += std::to_string(value.i);
+            break;
+        case ArgType::Uint:
+            out += std::to_string(value.u);
+            break;
+        case ArgType::Double:
+            std::snprintf(buffer, sizeof(buffer), "%g", value.d); // Same as an unmodified ostream
+            out += buffer;
+            break;
+        case ArgType::Bool:
+            out += value.u ? "true" : "false";
+            break;
+        case ArgType::Char:
+            out += static_cast<char>(value.u);
+            break;
+        case ArgType::Text:
+            out += record.text + value.text;
+            break;
+    }
+}
+
+std::string formatMessage(const Record& record) {
+    std::string out;
+    int next = 0;
+    for (const char* p = record.format; *p; p++) {
+        if (p[0] == '{' && p[1] == '}' && next < record.argCount) {
+            appendArg(out, record, next++);
+            p++;
+        } else {
+            out += *p;
+        }
+    }
+    return out;
+}
+
+void writeRecord(const Record& record, int tid) {
+    std::string message = formatMessage(record);
+    message += '\n';
+    std::fwrite(message.data(), 1, message.size(), record.level >= LogLevel::Warn ? stderr : stdout);
+
+    if (logFile) {
+        std::fprintf(logFile, "[%12.6f] %s %6d  ", (record.timeNs - startNs) / 1e9, levelName(record.level), tid);
+        std::fwrite(message.data(), 1, message.size(), logFile);
+    }
+}
+
+// Writes everything currently queued, oldest first across threads
+bool drainOnce() {
+    struct Pending {
+        uint64_t timeNs;
+        ThreadRing* ring;
+        uint64_t index;
+    };
+    static std::vector<Pending> pending;
+    static std::vector<std::pair<ThreadRing*, uint64_t>> ends;
+    pending.clear();
+    ends.clear();
+
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (auto& ring : registry) {
+            uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+            uint64_t head = ring->head.load(std::memory_order_acquire);
+            for (uint64_t i = tail; i < head; i++) {
+                pending.push_back({ring->slots[i % ThreadRing::kCapacity].timeNs, ring.get(), i});
+            }
+            if (head != tail) ends.emplace_back(ring.get(), head);
+        }
+    }
+
+    std::stable_sort(pending.begin(), pending.end(),
+                     [](const Pending& a, const Pending& b) { return a.timeNs < b.timeNs; });
+    for (const auto& item : pending) {
+        writeRecord(item.ring->slots[item.index % ThreadRing::kCapacity], item.ring->tid);
+    }
+
+    // Slots become reusable only after they have been formatted
+    for (const auto& end : ends) {
+        end.first->tail.store(end.second, std::memory_order_release);
+    }
+
+    static uint64_t reportedDrops = 0;
+    uint64_t drops = droppedCount.load(std::memory_order_relaxed);
+    if (drops != reportedDrops) {
+        std::fprintf(stderr, "⚠ Log buffer full: %llu messages dropped so far\n", static_cast<unsigned long long>(drops));
+        reportedDrops = drops;
+    }
+
+    if (!pending.empty()) {
+        std::fflush(stdout);
+        std::fflush(stderr);
+        if (logFile) std::fflush(logFile);
+    }
+    return !pending.empty();
+}
+
+void writerLoop() {
+    std::unique_lock<std::mutex> lock(writerMutex);
+    while (true) {
+        bool stopping = stopRequested;
+        lock.unlock();
+        bool wroteAny = drainOnce();
+        lock.lock();
+
+        passCount++;
+        passDone.notify_all();
+        if (stopping) break;
+        if (!wroteAny) {
+            // Producers never signal (that would be a syscall on the hot path), so poll
+            writerWake.wait_for(lock, std::chrono::milliseconds(5));
+        }
+    }
+}
+
+} // namespace
+
+namespace logdetail {
+
+Record* claim() {
+    if (!running.load(std::memory_order_acquire)) {
+        return &syncRecord;
+    }
+
+    if (!threadRing.ring) {
+        threadRing.ring = acquireRing();
+    }
+    ThreadRing* ring = threadRing.ring;
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= ThreadRing::kCapacity) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return &ring->slots[head % ThreadRing::kCapacity];
+}
+
+void commit(Record* record) {
+    if (record == &syncRecord) {
+        std::lock_guard<std::mutex> lock(syncMutex);
+        writeRecord(*record, static_cast<int>(syscall(SYS_gettid)));
+        std::fflush(record->level >= LogLevel::Warn ? stderr : stdout);
+        if (logFile) std::fflush(logFile);
+        return;
+    }
+
+    ThreadRing* ring = threadRing.ring;
+    ring->head.store(ring->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void addText(Record& record, std::string_view text) {
+    Record::Value& value = record.values[record.argCount - 1];
+    size_t room = kTextBytes - record.textUsed;
+    if (room <= 1) {
+        record.text[kTextBytes - 1] = '\0';
+        value.text = static_cast<uint16_t>(kTextBytes - 1);
+        return;
+    }
+
+    size_t length = std::min(text.size(), room - 1); // Long paths are truncated, not dropped
+    std::memcpy(record.text + record.textUsed, text.data(), length);
+    record.text[record.textUsed + length] = '\0';
+    value.text = record.textUsed;
+    record.textUsed = static_cast<uint16_t>(record.textUsed + length + 1);
+}
+
+} // namespace logdetail
+
+std::atomic<LogLevel> Log::minLevel{LogLevel::Info};
+
+bool Log::start(LogLevel level, const std::string& filePath) {
+    if (running.load()) return true;
+
+    minLevel.store(level);
+    startNs = monotonicNs();
+    if (!filePath.empty()) {
+        logFile = std::fopen(filePath.c_str(), "w");
+        if (!logFile) {
+            std::cerr << "Cannot write log file " << filePath << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        std::cout << "📝 Logging to " << filePath << std::endl;
+    }
+
+    std::cout.flush(); // Anything already printed stays ahead of queued messages
+    stopRequested = false;
+    running.store(true, std::memory_order_release);
+    writerThread = std::thread(writerLoop);
+    return true;
+}
+
+void Log::flush() {
+    if (!running.load(std::memory_order_acquire)) return;
+
+    // Two full passes: the one in progress may have missed recent messages
+    std::unique_lock<std::mutex> lock(writerMutex);
+    uint64_t target = passCount + 2;
+    writerWake.notify_one();
+    passDone.wait_for(lock, std::chrono::seconds(1), [&] { return passCount >= target; });
+}
+
+void Log::stop() {
+    if (!running.exchange(false)) return;
+
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        stopRequested = true;
+    }
+    writerWake.notify_one();
+    writerThread.join();
+
+    // A thread that claimed a slot before `running` cleared can commit it
+    // after the writer's last pass; this thread is the only reader now
+    {
+        std::lock_guard<std::mutex> lock(syncMutex);
+        drainOnce();
+    }
+
+    uint64_t drops = droppedCount.load();
+    if (drops) {
+        std::cerr << "⚠ " << drops << " log messages were dropped (buffer full)" << std::endl;
+    }
+    if (logFile) {
+        std::fclose(logFile);
+        logFile = nullptr;
+    }
+}
+
+bool Log::parseLevel(const std::string& name, LogLevel& level) {
+    if (name == "debug") level = LogLevel::Debug;
+    else if (name == "info") level = LogLevel::Info;
+    else if (name == "warn") level = LogLevel::Warn;
+    else if (name == "error") level = LogLevel::Error;
+    else return false;
+    return true;
+}
+
+uint64_t Log::getDropped() {
+    return droppedCount.load(std::memory_order_relaxed);
+}
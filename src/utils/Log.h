@@ -0,0 +1,124 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "utils/Clock.h"
+
+// Asynchronous logger for threads that must not block on a terminal: the
+// MIDI callback, clip start/stop under videosMutex, and decoder threads.
+//
+// Each thread appends fixed-size records to its own single-producer ring.
+// Arguments are copied, not formatted; a background writer formats them in
+// timestamp order and writes each batch with one flush. A full ring drops
+// the message and counts it. Before start() and after stop(), messages are
+// formatted and written synchronously.
+//
+// Formats use {} placeholders and must be string literals:
+//     VJ_LOG_INFO("▶️  Starting: {}", clip->getPath());
+
+enum class LogLevel : uint8_t { Debug, Info, Warn, Error };
+
+namespace logdetail {
+
+constexpr int kMaxArgs = 8;
+constexpr size_t kTextBytes = 160; // Shared by all string arguments of one message
+
+enum class ArgType : uint8_t { Int, Uint, Double, Bool, Char, Text };
+
+struct Record {
+    uint64_t timeNs;
+    const char* format;
+    LogLevel level;
+    uint8_t argCount;
+    uint16_t textUsed;
+    ArgType types[kMaxArgs];
+    union Value {
+        int64_t i;
+        uint64_t u;
+        double d;
+        uint16_t text; // Offset into text
+    } values[kMaxArgs];
+    char text[kTextBytes];
+};
+
+// claim() returns nullptr when the thread's ring is full (the message is counted as dropped)
+Record* claim();
+void commit(Record* record);
+
+void addText(Record& record, std::string_view text);
+
+template <typename T>
+void addArg(Record& record, const T& value) {
+    int slot = record.argCount++;
+    Record::Value& out = record.values[slot];
+    ArgType& type = record.types[slot];
+
+    if constexpr (std::is_same_v<T, bool>) {
+        type = ArgType::Bool;
+        out.u = value ? 1 : 0;
+    } else if constexpr (std::is_same_v<T, char>) {
+        type = ArgType::Char;
+        out.u = static_cast<unsigned char>(value);
+    } else if constexpr (std::is_enum_v<T>) {
+        type = ArgType::Int;
+        out.i = static_cast<int64_t>(value);
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        type = ArgType::Int;
+        out.i = value;
+    } else if constexpr (std::is_integral_v<T>) {
+        type = ArgType::Uint;
+        out.u = value;
+    } else if constexpr (std::is_floating_point_v<T>) {
+        type = ArgType::Double;
+        out.d = value;
+    } else if constexpr (std::is_pointer_v<T>) {
+        static_assert(std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, char>,
+                      "log arguments: only char pointers are copied as text");
+        type = ArgType::Text;
+        addText(record, value ? std::string_view(value) : std::string_view("(null)"));
+    } else {
+        type = ArgType::Text;
+        addText(record, std::string_view(value));
+    }
+}
+
+} // namespace logdetail
+
+class Log {
+public:
+    // filePath: also append every message, with timestamp and level, to this file ("" = console only)
+    static bool start(LogLevel minLevel, const std::string& filePath);
+    static void stop();  // Writes everything pending and joins the writer
+    static void flush(); // Blocks until messages logged so far have been written
+
+    static bool isEnabled(LogLevel level) { return level >= minLevel.load(std::memory_order_relaxed); }
+    static bool parseLevel(const std::string& name, LogLevel& level);
+    static uint64_t getDropped();
+
+    template <typename... Args>
+    static void write(LogLevel level, const char* format, const Args&... args) {
+        static_assert(sizeof...(Args) <= logdetail::kMaxArgs, "too many log arguments");
+        logdetail::Record* record = logdetail::claim();
+        if (!record) return;
+
+        record->timeNs = monotonicNs();
+        record->format = format;
+        record->level = level;
+        record->argCount = 0;
+        record->textUsed = 0;
+        (logdetail::addArg(*record, args), ...);
+        logdetail::commit(record);
+    }
+
+private:
+    static std::atomic<LogLevel> minLevel;
+};
+
+#define VJ_LOG(level, ...) \
+    do { if (Log::isEnabled(level)) Log::write(level, __VA_ARGS__); } while (0)
+#define VJ_LOG_DEBUG(...) VJ_LOG(LogLevel::Debug, __VA_ARGS__)
+#define VJ_LOG_INFO(...) VJ_LOG(LogLevel::Info, __VA_ARGS__)
+#define VJ_LOG_WARN(...) VJ_LOG(LogLevel::Warn, __VA_ARGS__)
+#define VJ_LOG_ERROR(...) VJ_LOG(LogLevel::Error, __VA_ARGS__)
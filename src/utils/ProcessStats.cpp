@@ -0,0 +1,28 @@
+#include "utils/ProcessStats.h"
+#include <fstream>
+#include <string>
+
+ProcessStats ProcessStats::read() {
+    ProcessStats stats;
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) {
+            stats.rssBytes = std::stoull(line.substr(6)) * 1024; // Reported in kB
+        } else if (line.compare(0, 6, "VmHWM:") == 0) {
+            stats.peakRssBytes = std::stoull(line.substr(6)) * 1024;
+        } else if (line.compare(0, 8, "Threads:") == 0) {
+            stats.threads = std::stoi(line.substr(8));
+        }
+    }
+    
+    return stats;
+}
+
+bool ProcessStats::resetPeak() {
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5"; // Resets VmHWM to the current RSS
+    clearRefs.flush();
+    return clearRefs.good();
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include <cstdint>
+
+// Resident memory and thread count of this process, read from /proc/self/status
+struct ProcessStats {
+    uint64_t rssBytes;
+    uint64_t peakRssBytes; // High-water mark since start or the last resetPeak()
+    int threads;
+    
+    ProcessStats() : rssBytes(0), peakRssBytes(0), threads(0) {}
+    
+    static ProcessStats read();
+    static bool resetPeak(); // Linux 4.0+; false if the kernel refuses
+};
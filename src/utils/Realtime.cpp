@@ -0,0 +1,242 @@
+#include "utils/Realtime.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace {
+
+struct RoleState {
+    const char* name;
+    std::vector<int> cpus;
+    int priority;                    // 0 = normal scheduling
+    std::atomic<int> threads{0};
+    std::atomic<int> pinned{0};
+    std::atomic<int> fifo{0};
+    std::atomic<int> affinityErrno{0};
+    std::atomic<int> fifoErrno{0};
+};
+
+std::atomic<bool> enabled(false);
+std::atomic<bool> futureLocked(false);
+RoleState roles[static_cast<int>(ThreadRole::Count)];
+std::string memoryLockResult;
+std::string prefaultResult;
+thread_local int appliedRole = -1;
+
+std::string cpuListString(const std::vector<int>& cpus) {
+    if (cpus.empty()) return "any";
+    std::ostringstream out;
+    for (size_t i = 0; i < cpus.size(); i++) {
+        out << (i ? "," : "") << cpus[i];
+    }
+    return out.str();
+}
+
+// CAP_IPC_LOCK lets mlock ignore RLIMIT_MEMLOCK
+bool hasIpcLockCapability() {
+    std::FILE* status = std::fopen("/proc/self/status", "r");
+    if (!status) return false;
+    char line[256];
+    unsigned long long effective = 0;
+    while (std::fgets(line, sizeof(line), status)) {
+        if (std::sscanf(line, "CapEff: %llx", &effective) == 1) break;
+    }
+    std::fclose(status);
+    return effective & (1ULL << 14);
+}
+
+// Touch a stack region up front so the thread never page-faults growing it
+void __attribute__((noinline)) prefaultStack() {
+    volatile char stack[256 * 1024];
+    for (size_t i = 0; i < sizeof(stack); i += 4096) {
+        stack[i] = 0;
+    }
+}
+
+} // namespace
+
+void Realtime::enable(const RealtimeConfig& config) {
+    int cpuCount = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    
+    RoleState& render = roles[static_cast<int>(ThreadRole::Render)];
+    RoleState& midi = roles[static_cast<int>(ThreadRole::Midi)];
+    RoleState& decode = roles[static_cast<int>(ThreadRole::Decode)];
+    render.name = "render";
+    midi.name = "midi";
+    decode.name = "decode";
+    render.cpus = config.renderCpus;
+    midi.cpus = config.midiCpus;
+    decode.cpus = config.decodeCpus;
+    render.priority = config.renderPriority;
+    midi.priority = config.midiPriority;
+    decode.priority = 0;
+    
+    // Automatic layout needs enough cores to give render and MIDI their own
+    if (render.cpus.empty() && midi.cpus.empty() && decode.cpus.empty() && cpuCount >= 4) {
+        render.cpus = {cpuCount - 1};
+        midi.cpus = {cpuCount - 2};
+        for (int cpu = 0; cpu < cpuCount - 2; cpu++) {
+            decode.cpus.push_back(cpu);
+        }
+    }
+    
+    // Keep freed frame buffers in the heap instead of returning them to the
+    // kernel, so reallocating one never faults fresh pages in
+    mallopt(M_MMAP_MAX, 0);
+    mallopt(M_TRIM_THRESHOLD, -1);
+    
+    // Grow the heap once and touch every page; with trimming off it stays
+    // resident and later frame allocations are carved out of it
+    if (config.prefaultMb > 0) {
+        size_t bytes = static_cast<size_t>(config.prefaultMb) << 20;
+        char* block = static_cast<char*>(malloc(bytes));
+        if (block) {
+            long page = sysconf(_SC_PAGESIZE);
+            for (size_t i = 0; i < bytes; i += page) {
+                block[i] = 0;
+            }
+            free(block);
+            prefaultResult = std::to_string(config.prefaultMb) + " MB heap prefaulted";
+        } else {
+            prefaultResult = "prefault allocation failed";
+        }
+    }
+    
+    // MCL_FUTURE under a finite limit makes every allocation past it fail
+    // (bad_alloc mid-show once the caches fill), so without an unlimited
+    // limit or CAP_IPC_LOCK only what exists now is locked, and the frame
+    // arena locks its slabs as it maps them
+    struct rlimit limit;
+    getrlimit(RLIMIT_MEMLOCK, &limit);
+    bool lockFuture = limit.rlim_cur == RLIM_INFINITY || hasIpcLockCapability();
+    std::ostringstream limitText;
+    if (limit.rlim_cur == RLIM_INFINITY) {
+        limitText << "RLIMIT_MEMLOCK unlimited";
+    } else {
+        limitText << "RLIMIT_MEMLOCK " << (limit.rlim_cur >> 20) << " MB";
+    }
+    
+    if (mlockall(lockFuture ? MCL_CURRENT | MCL_FUTURE : MCL_CURRENT) == 0) {
+        futureLocked = lockFuture;
+        memoryLockResult = lockFuture ? "locked (current and future)"
+                                      : "current pages locked, frame slabs as they are mapped (" +
+                                            limitText.str() + ", no CAP_IPC_LOCK)";
+    } else {
+        memoryLockResult = std::string("not locked: ") + std::strerror(errno) + " (" + limitText.str() + ")";
+    }
+    
+    enabled = true;
+}
+
+bool Realtime::isEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+bool Realtime::locksFutureMemory() {
+    return futureLocked.load(std::memory_order_relaxed);
+}
+
+void Realtime::applyToCurrentThread(ThreadRole role) {
+    if (!enabled.load(std::memory_order_relaxed)) return;
+    if (appliedRole == static_cast<int>(role)) return;
+    appliedRole = static_cast<int>(role);
+    
+    RoleState& state = roles[static_cast<int>(role)];
+    state.threads.fetch_add(1, std::memory_order_relaxed);
+    
+    if (!state.cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : state.cpus) {
+            CPU_SET(cpu, &set);
+        }
+        int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (error == 0) {
+            state.pinned.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            state.affinityErrno.store(error, std::memory_order_relaxed);
+        }
+    }
+    
+    // Threads inherit their creator's policy, so decoders started from the
+    // MIDI thread explicitly drop back to normal scheduling
+    sched_param param;
+    std::memset(&param, 0, sizeof(param));
+    param.sched_priority = state.priority;
+    int policy = state.priority > 0 ? SCHED_FIFO : SCHED_OTHER;
+    int error = pthread_setschedparam(pthread_self(), policy, &param);
+    if (state.priority > 0) {
+        if (error == 0) {
+            state.fifo.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            state.fifoErrno.store(error, std::memory_order_relaxed);
+        }
+        prefaultStack();
+    }
+}
+
+void Realtime::printReport() {
+    if (!isEnabled()) return;
+    
+    std::cout << "⏱️  Realtime mode" << std::endl;
+    std::cout << "   Memory: " << memoryLockResult;
+    if (!prefaultResult.empty()) {
+        std::cout << ", " << prefaultResult;
+    }
+    std::cout << std::endl;
+    
+    for (const auto& state : roles) {
+        int threads = state.threads.load();
+        std::cout << "   " << state.name << ": " << threads << " thread" << (threads == 1 ? "" : "s")
+                  << ", cpus " << cpuListString(state.cpus);
+        if (!state.cpus.empty()) {
+            std::cout << " (pinned " << state.pinned.load() << ")";
+            if (state.affinityErrno.load()) {
+                std::cout << " affinity failed: " << std::strerror(state.affinityErrno.load());
+            }
+        }
+        if (state.priority > 0) {
+            std::cout << ", SCHED_FIFO " << state.priority << " on " << state.fifo.load() << "/" << threads;
+            if (state.fifoErrno.load()) {
+                std::cout << " (" << std::strerror(state.fifoErrno.load()) << "; needs CAP_SYS_NICE or rtprio limit)";
+            }
+        }
+        std::cout << std::endl;
+    }
+}
+
+bool Realtime::parseCpuList(const std::string& text, std::vector<int>& cpus) {
+    cpus.clear();
+    std::stringstream ss(text);
+    std::string range;
+    
+    while (std::getline(ss, range, ',')) {
+        if (range.empty()) continue;
+        int first = 0, last = 0;
+        char extra = 0;
+        if (std::sscanf(range.c_str(), "%d-%d%c", &first, &last, &extra) == 2) {
+            // Range
+        } else if (std::sscanf(range.c_str(), "%d%c", &first, &extra) == 1) {
+            last = first;
+        } else {
+            return false;
+        }
+        if (first < 0 || last < first || last >= CPU_SETSIZE) return false;
+        for (int cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+    
+    return !cpus.empty();
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+#include <vector>
+
+enum class ThreadRole { Render, Midi, Decode, Count };
+
+struct RealtimeConfig {
+    // Empty lists pick a layout automatically: render and MIDI get a core
+    // each from the top of the range, decoders share the rest
+    std::vector<int> renderCpus;
+    std::vector<int> midiCpus;
+    std::vector<int> decodeCpus;
+    int renderPriority;  // SCHED_FIFO priorities
+    int midiPriority;
+    int prefaultMb;      // Heap grown and touched up front for frame buffers
+    
+    RealtimeConfig() : renderPriority(70), midiPriority(80), prefaultMb(256) {}
+};
+
+// Opt-in real-time operation (--realtime). Locks and prefaults memory for
+// the whole process, then each thread applies its role's CPU affinity and
+// scheduling class itself. Anything the process is not permitted to do is
+// skipped and shown in the report rather than treated as an error.
+class Realtime {
+public:
+    static void enable(const RealtimeConfig& config);
+    static bool isEnabled();
+    static bool locksFutureMemory(); // False: new memory must be mlocked by its owner
+    
+    // Cheap to call repeatedly (e.g. from a MIDI callback); no-op when disabled
+    static void applyToCurrentThread(ThreadRole role);
+    
+    static void printReport();
+    
+    static bool parseCpuList(const std::string& text, std::vector<int>& cpus); // "0-2,5"
+};
@@ -0,0 +1,160 @@
+#include "utils/Trace.h"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    uint64_t startNs;
+    uint64_t endNs;
+};
+
+// One per thread; only the owning thread appends, the writer reads after stop().
+// Storage grows in fixed chunks so short-lived decoder threads stay cheap and
+// nothing the reader can see is ever reallocated.
+struct ThreadBuffer {
+    static constexpr size_t kChunkSize = 1024;
+    static constexpr size_t kMaxChunks = 64;
+    static constexpr size_t kCapacity = kChunkSize * kMaxChunks;
+    
+    int tid;
+    std::string threadName;
+    std::atomic<TraceEvent*> chunks[kMaxChunks] = {};
+    std::atomic<size_t> count{0};
+    std::atomic<uint64_t> dropped{0};
+    
+    const TraceEvent& at(size_t index) const {
+        return chunks[index / kChunkSize].load(std::memory_order_acquire)[index % kChunkSize];
+    }
+};
+
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> registry; // Buffers outlive their threads
+std::string tracePath;
+uint64_t traceStartNs = 0;
+
+thread_local ThreadBuffer* threadBuffer = nullptr;
+thread_local std::string pendingThreadName;
+
+ThreadBuffer* registerThread() {
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->tid = static_cast<int>(syscall(SYS_gettid));
+    buffer->threadName = pendingThreadName.empty() ? "thread " + std::to_string(buffer->tid) : pendingThreadName;
+    
+    std::lock_guard<std::mutex> lock(registryMutex); // Once per thread, never per span
+    registry.push_back(std::move(buffer));
+    return registry.back().get();
+}
+
+void writeJsonString(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') out << '\\';
+        out << c;
+    }
+    out << '"';
+}
+
+} // namespace
+
+std::atomic<bool> Tracer::enabled{false};
+
+bool Tracer::start(const std::string& outputPath) {
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        tracePath = outputPath;
+        traceStartNs = monotonicNs();
+    }
+    enabled.store(true, std::memory_order_release);
+    std::cout << "⏱️  Tracing to " << outputPath << std::endl;
+    return true;
+}
+
+void Tracer::record(const char* name, uint64_t startNs, uint64_t endNs) {
+    if (!isEnabled()) return;
+    
+    if (!threadBuffer) {
+        threadBuffer = registerThread();
+    }
+    
+    size_t index = threadBuffer->count.load(std::memory_order_relaxed);
+    if (index >= ThreadBuffer::kCapacity) {
+        threadBuffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    
+    auto& chunk = threadBuffer->chunks[index / ThreadBuffer::kChunkSize];
+    TraceEvent* events = chunk.load(std::memory_order_relaxed);
+    if (!events) {
+        events = new TraceEvent[ThreadBuffer::kChunkSize]; // Kept until exit, like the buffer
+        chunk.store(events, std::memory_order_release);
+    }
+    
+    events[index % ThreadBuffer::kChunkSize] = TraceEvent{name, startNs, endNs};
+    threadBuffer->count.store(index + 1, std::memory_order_release);
+}
+
+void Tracer::setThreadName(const std::string& name) {
+    if (name == pendingThreadName) return; // Cheap to call from callbacks
+    pendingThreadName = name;
+    if (threadBuffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        threadBuffer->threadName = name;
+    }
+}
+
+void Tracer::stop() {
+    if (!enabled.exchange(false)) return;
+    
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::ofstream out(tracePath);
+    if (!out.is_open()) {
+        std::cerr << "Cannot write trace file: " << tracePath << std::endl;
+        return;
+    }
+    
+    const int pid = static_cast<int>(getpid());
+    size_t eventCount = 0;
+    uint64_t droppedCount = 0;
+    bool first = true;
+    
+    // Microseconds with ns decimals; the default 6 significant digits lose
+    // sub-ms detail after a second and go exponential past 1000 s
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (const auto& buffer : registry) {
+        if (!first) out << ",\n";
+        first = false;
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << buffer->tid
+            << ",\"args\":{\"name\":";
+        writeJsonString(out, buffer->threadName);
+        out << "}}";
+        
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; i++) {
+            const TraceEvent& event = buffer->at(i);
+            uint64_t startNs = event.startNs > traceStartNs ? event.startNs - traceStartNs : 0;
+            out << ",\n{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << buffer->tid
+                << ",\"ts\":" << startNs / 1000.0 << ",\"dur\":" << (event.endNs - event.startNs) / 1000.0 << "}";
+        }
+        
+        eventCount += count;
+        droppedCount += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    out << "\n]}\n";
+    
+    std::cout << "⏱️  Wrote " << eventCount << " trace events to " << tracePath;
+    if (droppedCount) {
+        std::cout << " (" << droppedCount << " dropped, buffers full)";
+    }
+    std::cout << std::endl;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include "utils/Clock.h"
+
+// Opt-in timeline tracer writing Chrome/Perfetto trace-event JSON.
+//
+// Spans are recorded into per-thread buffers that only their owning thread
+// writes, so recording takes no locks. With VJ_ENABLE_TRACE=0 the macros
+// compile away entirely; when compiled in but not started, each span costs
+// one relaxed atomic load.
+#ifndef VJ_ENABLE_TRACE
+#define VJ_ENABLE_TRACE 1
+#endif
+
+class Tracer {
+public:
+    static bool start(const std::string& outputPath);
+    static void stop(); // Writes the JSON file
+    
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+    
+    // Names must be string literals (or otherwise outlive the trace)
+    static void record(const char* name, uint64_t startNs, uint64_t endNs);
+    static void setThreadName(const std::string& name);
+    
+private:
+    static std::atomic<bool> enabled;
+};
+
+class TraceScope {
+public:
+    explicit TraceScope(const char* spanName)
+        : name(spanName), startNs(Tracer::isEnabled() ? monotonicNs() : 0) {}
+    
+    ~TraceScope() {
+        if (startNs) Tracer::record(name, startNs, monotonicNs());
+    }
+    
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+    
+private:
+    const char* name;
+    uint64_t startNs;
+};
+
+#define VJ_TRACE_CONCAT_INNER(a, b) a##b
+#define VJ_TRACE_CONCAT(a, b) VJ_TRACE_CONCAT_INNER(a, b)
+
+#if VJ_ENABLE_TRACE
+#define VJ_TRACE_SCOPE(name) TraceScope VJ_TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define VJ_TRACE_THREAD_NAME(name) Tracer::setThreadName(name)
+#else
+#define VJ_TRACE_SCOPE(name) do {} while (0)
+#define VJ_TRACE_THREAD_NAME(name) do {} while (0)
+#endif
@@ -0,0 +1,221 @@
+#include "video/ClipDecoder.h"
+#include "video/KeyframeIndex.h"
+#include "utils/Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+
+std::atomic<bool> ClipDecoder::readsHeld{false};
+
+ClipDecoder::ClipDecoder(const std::string& path, std::shared_ptr<const KeyframeIndex> keyframes,
+                         size_t budget)
+    : index(std::move(keyframes)), cacheBudgetBytes(budget), cacheBytes(0), nextDecodeFrame(0),
+      lastDecodedStart(-1), useCounter(0), cacheMisses(0), stopping(false) {
+    if (!index) {
+        throw std::runtime_error("No keyframe index for: " + path);
+    }
+    if (!capture.open(path)) {
+        throw std::runtime_error("Cannot open video file: " + path);
+    }
+    
+    std::string name = std::filesystem::path(path).filename().string();
+    worker = std::thread([this, name]() {
+        VJ_TRACE_THREAD_NAME("seek " + name);
+        workerLoop();
+    });
+}
+
+ClipDecoder::~ClipDecoder() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    requestCondition.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+int ClipDecoder::getFrameCount() const {
+    return index->getFrameCount();
+}
+
+int ClipDecoder::blockStart(int frameIndex) const {
+    int keyframe = index->keyframeAtOrBefore(frameIndex);
+    return keyframe + ((frameIndex - keyframe) / kBlockFrames) * kBlockFrames;
+}
+
+int ClipDecoder::blockLength(int start) const {
+    int gopEnd = index->nextKeyframeAfter(start);
+    return std::max(1, std::min(kBlockFrames, gopEnd - start));
+}
+
+bool ClipDecoder::getFrame(int frameIndex, cv::Mat& frame, int64_t waitUs) {
+    if (frameIndex < 0 || frameIndex >= getFrameCount()) return false;
+    int start = blockStart(frameIndex);
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it = blocks.find(start);
+    if (it == blocks.end()) {
+        cacheMisses++;
+        queueBlock(start);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(waitUs);
+        readyCondition.wait_until(lock, deadline, [&]() {
+            return stopping || blocks.find(start) != blocks.end();
+        });
+        it = blocks.find(start);
+        if (it == blocks.end()) return false;
+    }
+    
+    size_t offset = static_cast<size_t>(frameIndex - start);
+    if (offset >= it->second.frames.size()) return false; // Clip ended early
+    
+    it->second.lastUsed = ++useCounter;
+    frame = it->second.frames[offset];
+    return !frame.empty();
+}
+
+void ClipDecoder::prefetch(int frameIndex) {
+    int frameCount = getFrameCount();
+    if (frameCount <= 0) return;
+    frameIndex = ((frameIndex % frameCount) + frameCount) % frameCount;
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    queueBlock(blockStart(frameIndex));
+}
+
+void ClipDecoder::queueBlock(int start) {
+    // Caller holds mutex
+    if (blocks.count(start)) return;
+    if (std::find(requests.begin(), requests.end(), start) != requests.end()) return;
+    
+    // Newest request first: a stale prefetch must not delay what is needed now
+    requests.push_front(start);
+    requestCondition.notify_one();
+}
+
+void ClipDecoder::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    
+    while (true) {
+        requestCondition.wait(lock, [this]() { return stopping || !requests.empty(); });
+        if (stopping) return;
+        
+        int start = requests.front();
+        requests.pop_front();
+        if (blocks.count(start)) continue;
+        
+        bool reverse = start < lastDecodedStart &&
+                       index->keyframeAtOrBefore(start) == index->keyframeAtOrBefore(lastDecodedStart);
+        lastDecodedStart = start;
+        
+        lock.unlock();
+        while (readsHeld.load(std::memory_order_relaxed)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        std::map<int, std::vector<cv::Mat>> decoded;
+        bool ok = decodeBlock(start, reverse, decoded);
+        lock.lock();
+        
+        if (ok) {
+            // Ascending, so the blocks nearest the request are the most
+            // recently used and the last to be evicted
+            for (auto& [blockFirst, frames] : decoded) {
+                if (!blocks.count(blockFirst)) {
+                    storeBlock(blockFirst, frames);
+                }
+            }
+            evict();
+        }
+        readyCondition.notify_all();
+    }
+}
+
+void ClipDecoder::storeBlock(int start, std::vector<cv::Mat>& frames) {
+    // Caller holds mutex
+    Block& block = blocks[start];
+    block.frames = std::move(frames);
+    block.lastUsed = ++useCounter;
+    for (const auto& frame : block.frames) {
+        cacheBytes += frame.total() * frame.elemSize();
+    }
+}
+
+bool ClipDecoder::decodeBlock(int start, bool keepPassed, std::map<int, std::vector<cv::Mat>>& decoded) {
+    VJ_TRACE_SCOPE("decode block");
+    int length = blockLength(start);
+    
+    // Seek only when the capture is not already inside this GOP ahead of the
+    // block; stepping forward sequentially needs no seek at all
+    int keyframe = index->keyframeAtOrBefore(start);
+    if (nextDecodeFrame < keyframe || nextDecodeFrame > start) {
+        capture.set(cv::CAP_PROP_POS_FRAMES, keyframe);
+        nextDecodeFrame = keyframe;
+    }
+    
+    // Frames before the block have to be decoded anyway. Going forwards they
+    // are dropped unconverted; going backwards they are the next blocks
+    // needed, so the nearest of them are kept, up to the cache budget
+    size_t passedBytes = 0;
+    while (nextDecodeFrame < start) {
+        if (!capture.grab()) {
+            nextDecodeFrame = -1;
+            return false;
+        }
+        if (keepPassed) {
+            cv::Mat frame;
+            int first = blockStart(nextDecodeFrame);
+            if (!capture.retrieve(frame)) {
+                decoded.erase(first); // Offsets within it would be wrong from here on
+                keepPassed = false;
+            } else {
+                decoded[first].push_back(frame);
+                passedBytes += frame.total() * frame.elemSize();
+                while (passedBytes > cacheBudgetBytes && decoded.size() > 1) {
+                    for (const auto& dropped : decoded.begin()->second) {
+                        passedBytes -= dropped.total() * dropped.elemSize();
+                    }
+                    decoded.erase(decoded.begin());
+                }
+            }
+        }
+        nextDecodeFrame++;
+    }
+    // A block is only usable whole, from its first frame
+    if (!decoded.empty() && static_cast<int>(decoded.begin()->second.size()) < blockLength(decoded.begin()->first)) {
+        decoded.erase(decoded.begin());
+    }
+    
+    std::vector<cv::Mat>& frames = decoded[start];
+    frames.reserve(length);
+    for (int i = 0; i < length; i++) {
+        cv::Mat frame;
+        if (!capture.read(frame)) {
+            nextDecodeFrame = -1;
+            break;
+        }
+        frames.push_back(frame);
+        nextDecodeFrame++;
+    }
+    
+    return !frames.empty();
+}
+
+void ClipDecoder::evict() {
+    // Caller holds mutex. Drops least recently used blocks; a block still on
+    // screen stays alive through the Mat reference held by the reader.
+    while (cacheBytes > cacheBudgetBytes && blocks.size() > 1) {
+        auto oldest = blocks.begin();
+        for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+            if (it->second.lastUsed < oldest->second.lastUsed) {
+                oldest = it;
+            }
+        }
+        for (const auto& frame : oldest->second.frames) {
+            cacheBytes -= frame.total() * frame.elemSize();
+        }
+        blocks.erase(oldest);
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class KeyframeIndex;
+
+// Random-access decoder for non-linear playback (reverse, varispeed, scratch).
+// Frames are decoded in blocks that start on a keyframe boundary, so a block
+// never costs more than one GOP of decoding, and decoded blocks are kept in an
+// LRU cache. A worker thread owns the capture and fills blocks on request;
+// callers prefetch the next block in their direction of travel. Travelling
+// backwards, the frames decoded on the way from the keyframe to a block are
+// kept as blocks too, so a GOP is decoded about once rather than once per
+// block.
+class ClipDecoder {
+public:
+    static constexpr int kBlockFrames = 24;
+    
+    ClipDecoder(const std::string& path, std::shared_ptr<const KeyframeIndex> index,
+                size_t cacheBudgetBytes = 512u << 20);
+    ~ClipDecoder();
+    
+    // Returns the frame if it is cached; otherwise queues its block and waits
+    // up to waitUs for it. The frame shares the cached buffer.
+    bool getFrame(int frameIndex, cv::Mat& frame, int64_t waitUs);
+    void prefetch(int frameIndex);
+    
+    int getFrameCount() const;
+    uint64_t getCacheMisses() const { return cacheMisses; }
+    
+    // For --check-stall: while held, workers block before each decode, as
+    // on a drive that stops answering
+    static void holdReads(bool hold) { readsHeld.store(hold, std::memory_order_relaxed); }
+    
+private:
+    struct Block {
+        std::vector<cv::Mat> frames;
+        uint64_t lastUsed;
+    };
+    
+    cv::VideoCapture capture;
+    std::shared_ptr<const KeyframeIndex> index;
+    size_t cacheBudgetBytes;
+    size_t cacheBytes;
+    int nextDecodeFrame; // Frame the capture will return next, -1 = unknown
+    int lastDecodedStart; // Worker only; a request below it in the same GOP means reverse
+    
+    std::map<int, Block> blocks; // Keyed by first frame
+    std::deque<int> requests;
+    uint64_t useCounter;
+    uint64_t cacheMisses;
+    std::mutex mutex;
+    std::condition_variable requestCondition;
+    std::condition_variable readyCondition;
+    std::thread worker;
+    bool stopping;
+    static std::atomic<bool> readsHeld;
+    
+    int blockStart(int frameIndex) const;
+    int blockLength(int start) const;
+    void queueBlock(int start);
+    void workerLoop();
+    bool decodeBlock(int start, bool keepPassed, std::map<int, std::vector<cv::Mat>>& decoded);
+    void storeBlock(int start, std::vector<cv::Mat>& frames);
+    void evict();
+};
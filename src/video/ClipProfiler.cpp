@@ -0,0 +1,332 @@
+#include "video/ClipProfiler.h"
+#include "video/ImageSequence.h"
+#include "video/KeyframeIndex.h"
+#include "utils/CsvParser.h"
+#include "utils/ProcessStats.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+namespace {
+
+constexpr double kSampleSeconds = 5.0;     // Flat-out decoding per clip
+constexpr int kSampleFrames = 600;
+constexpr double kLayerHeadroom = 2.0;     // Crossfades and layers decode two clips at once
+constexpr double kLongGopSeconds = 2.0;
+constexpr double kSeekBudgetMs = 250.0;    // Worst acceptable wait for a reverse/scratch/cue block
+constexpr double kOversizeFactor = 1.5;
+constexpr int kStartBudgetFrames = 3;      // Output frames a trigger may wait for its first frame
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+std::string fourccName(double value) {
+    auto code = static_cast<uint32_t>(value);
+    std::string name;
+    for (int i = 0; i < 4; i++) {
+        char c = static_cast<char>((code >> (8 * i)) & 0xFF);
+        if (c > ' ' && c < 127) name += c;
+    }
+    return name.empty() ? "?" : name;
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) >= 0x20) {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+void profileVideo(ClipProfile& profile) {
+    auto start = Clock::now();
+    cv::VideoCapture capture;
+    if (!capture.open(profile.path)) return;
+    profile.openMs = elapsedMs(start);
+    profile.opened = true;
+    profile.codec = fourccName(capture.get(cv::CAP_PROP_FOURCC));
+    profile.fps = capture.get(cv::CAP_PROP_FPS);
+    profile.frameCount = static_cast<int>(capture.get(cv::CAP_PROP_FRAME_COUNT));
+
+    cv::Mat frame;
+    start = Clock::now();
+    if (!capture.read(frame) || frame.empty()) return;
+    profile.firstFrameMs = elapsedMs(start);
+    profile.size = frame.size();
+
+    // As fast as it goes, which is what a playback thread that has fallen
+    // behind gets; reads from the drive are part of it
+    int frames = 0;
+    auto sampleStart = Clock::now();
+    while (frames < kSampleFrames && elapsedMs(sampleStart) < kSampleSeconds * 1000.0) {
+        auto readStart = Clock::now();
+        if (!capture.read(frame)) break; // Short clip: the sample is what there is
+        profile.worstFrameMs = std::max(profile.worstFrameMs, elapsedMs(readStart));
+        frames++;
+    }
+    double sampleMs = elapsedMs(sampleStart);
+    if (frames > 0 && sampleMs > 0) {
+        profile.decodeFps = frames * 1000.0 / sampleMs;
+    } else if (profile.firstFrameMs > 0) {
+        profile.decodeFps = 1000.0 / profile.firstFrameMs;
+    }
+
+    // The playback loop's wrap: rewind and read frame 0
+    start = Clock::now();
+    capture.set(cv::CAP_PROP_POS_FRAMES, 0);
+    capture.read(frame);
+    profile.loopWrapMs = elapsedMs(start);
+
+    auto index = KeyframeIndex::loadOrBuild(profile.path);
+    if (index && index->getFrameCount() > 0) {
+        if (profile.fps <= 0) profile.fps = index->getFps();
+        if (profile.frameCount <= 0) profile.frameCount = index->getFrameCount();
+        profile.longestGop = index->getLongestGop();
+        profile.gopExact = index->isExact();
+        int keyframes = 0;
+        for (int f = 0; f < index->getFrameCount();) {
+            keyframes++;
+            int next = index->nextKeyframeAfter(f);
+            if (next <= f) break;
+            f = next;
+        }
+        profile.averageGop = keyframes ? static_cast<double>(index->getFrameCount()) / keyframes : 0.0;
+    }
+    if (profile.fps <= 0) profile.fps = 30;
+}
+
+void profileSequence(ClipProfile& profile, double fps) {
+    auto start = Clock::now();
+    std::vector<std::string> files = ImageSequence::listFrames(profile.path);
+    profile.openMs = elapsedMs(start);
+    if (files.empty()) return;
+    profile.opened = true;
+    profile.codec = std::filesystem::path(files.front()).extension().string();
+    profile.frameCount = static_cast<int>(files.size());
+    profile.longestGop = 1; // Every image is its own keyframe
+    profile.averageGop = 1.0;
+    profile.gopExact = true;
+
+    // Through the same worker pool and read-ahead playback uses, so the
+    // rate is what the show gets, not one core's
+    std::unique_ptr<ImageSequence> sequence;
+    try {
+        sequence = std::make_unique<ImageSequence>(profile.path, fps);
+    } catch (const std::exception&) {
+        return;
+    }
+    profile.fps = sequence->getFps();
+    profile.firstFrameMs = sequence->getDecodeMs();
+    profile.decodeThreads = sequence->getWorkerCount();
+    cv::Mat frame;
+    if (!sequence->getFrame(0, frame, 0)) return;
+    profile.size = frame.size();
+
+    int frames = 0;
+    auto sampleStart = Clock::now();
+    for (int i = 1; i < profile.frameCount && frames < kSampleFrames &&
+                    elapsedMs(sampleStart) < kSampleSeconds * 1000.0; i++) {
+        auto readStart = Clock::now();
+        sequence->prefetch(i - 1, 1);
+        sequence->getFrame(i, frame, 1000000);
+        profile.worstFrameMs = std::max(profile.worstFrameMs, elapsedMs(readStart));
+        frames++;
+    }
+    double sampleMs = elapsedMs(sampleStart);
+    profile.decodeFps = frames > 0 && sampleMs > 0 ? frames * 1000.0 / sampleMs
+                                                   : 1000.0 / std::max(profile.firstFrameMs, 0.001);
+    sequence.reset();
+
+    // A long sequence has left the cache by the time it wraps
+    start = Clock::now();
+    ImageSequence::decodeFile(files.front(), frame);
+    profile.loopWrapMs = elapsedMs(start);
+}
+
+void diagnose(ClipProfile& profile, double outputHz, cv::Size outputSize) {
+    if (!profile.opened) {
+        profile.warnings.push_back("cannot open");
+        return;
+    }
+    if (profile.size.empty()) {
+        profile.warnings.push_back("cannot decode: no frame could be read");
+        return;
+    }
+
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1);
+    auto warn = [&]() {
+        profile.warnings.push_back(text.str());
+        text.str("");
+    };
+
+    bool still = profile.frameCount <= 1; // Decoded once, then held
+    double clipFrameMs = 1000.0 / profile.fps;
+    if (!still && profile.decodeFps < profile.fps) {
+        text << "too slow: decodes " << profile.decodeFps << " fps, plays at " << profile.fps << " fps ("
+             << std::setprecision(2) << profile.headroom() << "x real time)";
+        warn();
+    } else if (!still && profile.headroom() < kLayerHeadroom) {
+        text << "little headroom: " << std::setprecision(2) << profile.headroom()
+             << "x real time; may stutter while another clip decodes (crossfades, layers)";
+        warn();
+    }
+    if (!still && profile.worstFrameMs > 2 * clipFrameMs) {
+        text << "decode spikes: worst frame " << profile.worstFrameMs << " ms against " << clipFrameMs << " ms per frame";
+        warn();
+    }
+    if (profile.fps > outputHz + 0.5) {
+        text << "rate above output: " << profile.fps << " fps on a " << outputHz
+             << " Hz output decodes frames that are never shown";
+        warn();
+    }
+    if (profile.size.width > outputSize.width * kOversizeFactor ||
+        profile.size.height > outputSize.height * kOversizeFactor) {
+        text << "oversized: " << profile.size.width << "x" << profile.size.height << " for a " << outputSize.width << "x"
+             << outputSize.height << " output; a transcode at output size decodes faster";
+        warn();
+    }
+    double gopSeconds = profile.longestGop / profile.fps;
+    double gopDecodeMs = profile.decodeFps > 0 ? profile.longestGop * 1000.0 / profile.decodeFps : 0.0;
+    if (profile.longestGop > 1 && (gopSeconds > kLongGopSeconds || gopDecodeMs > kSeekBudgetMs)) {
+        text << "long GOP: keyframes up to " << profile.longestGop << " frames (" << gopSeconds
+             << " s) apart; reverse, scratch and cues can wait up to " << std::setprecision(0) << gopDecodeMs << " ms";
+        warn();
+    }
+    double startMs = profile.openMs + profile.firstFrameMs;
+    if (startMs > kStartBudgetFrames * 1000.0 / outputHz) {
+        text << "slow start: first frame " << startMs << " ms after a trigger; add a cue (pre-rolled) or transcode";
+        warn();
+    }
+    if (!still && profile.loopWrapMs > clipFrameMs) {
+        text << "loop hitch: rewinding costs " << profile.loopWrapMs << " ms, more than a frame";
+        warn();
+    }
+}
+
+bool writeJson(const std::string& path, const std::vector<ClipProfile>& profiles, double outputHz, cv::Size outputSize) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Cannot write clip profile: " << path << std::endl;
+        return false;
+    }
+    out << "{\n";
+    out << "  \"output_hz\": " << outputHz << ",\n";
+    out << "  \"output_size\": [" << outputSize.width << ", " << outputSize.height << "],\n";
+    out << "  \"clips\": [";
+    for (size_t i = 0; i < profiles.size(); i++) {
+        const ClipProfile& p = profiles[i];
+        out << (i ? ",\n" : "\n") << "    {\"rank\": " << i + 1 << ", \"path\": \"" << jsonEscape(p.path)
+            << "\", \"opened\": " << (p.opened ? "true" : "false") << ", \"codec\": \"" << jsonEscape(p.codec)
+            << "\", \"width\": " << p.size.width << ", \"height\": " << p.size.height << ", \"fps\": " << p.fps
+            << ", \"frames\": " << p.frameCount << ",\n     \"decode_fps\": " << p.decodeFps
+            << ", \"decode_threads\": " << p.decodeThreads
+            << ", \"realtime_factor\": " << p.headroom() << ", \"worst_frame_ms\": " << p.worstFrameMs
+            << ", \"open_ms\": " << p.openMs << ", \"first_frame_ms\": " << p.firstFrameMs
+            << ", \"loop_wrap_ms\": " << p.loopWrapMs << ", \"longest_gop\": " << p.longestGop
+            << ", \"average_gop\": " << p.averageGop << ", \"gop_exact\": " << (p.gopExact ? "true" : "false")
+            << ", \"peak_memory_bytes\": " << p.peakMemoryBytes << ",\n     \"warnings\": [";
+        for (size_t w = 0; w < p.warnings.size(); w++) {
+            out << (w ? ", " : "") << "\"" << jsonEscape(p.warnings[w]) << "\"";
+        }
+        out << "]}";
+    }
+    out << (profiles.empty() ? "]\n" : "\n  ]\n") << "}\n";
+    return true;
+}
+
+} // namespace
+
+bool runClipProfile(const std::string& csvPath, double outputHz, cv::Size outputSize, const std::string& jsonPath) {
+    std::vector<ClipData> clips;
+    try {
+        clips = CsvParser::parseClipsFile(csvPath);
+    } catch (const std::exception& e) {
+        std::cerr << "Error loading clips: " << e.what() << std::endl;
+        return false;
+    }
+
+    std::cout << "🩺 Clip doctor: " << clips.size() << " clips from " << csvPath << ", output " << outputHz << " Hz "
+              << outputSize.width << "x" << outputSize.height << ", up to " << kSampleSeconds << " s of decoding each"
+              << std::endl;
+    bool peakExact = true;
+    std::vector<ClipProfile> profiles;
+    for (const ClipData& data : clips) {
+        ClipProfile profile;
+        profile.path = data.path;
+        std::cout << "   " << std::filesystem::path(data.path).filename().string() << "..." << std::flush;
+
+        peakExact &= ProcessStats::resetPeak();
+        uint64_t baseline = ProcessStats::read().rssBytes;
+        if (ImageSequence::isImageSource(data.path)) {
+            double fps = 0.0;
+            try {
+                fps = data.fps.empty() ? 0.0 : std::stod(data.fps);
+            } catch (const std::exception&) {
+            }
+            profileSequence(profile, fps);
+        } else if (std::filesystem::exists(data.path)) {
+            profileVideo(profile);
+        }
+        uint64_t peak = ProcessStats::read().peakRssBytes;
+        profile.peakMemoryBytes = peak > baseline ? peak - baseline : 0;
+
+        diagnose(profile, outputHz, outputSize);
+        std::cout << (profile.opened ? " done" : " cannot open") << std::endl;
+        profiles.push_back(std::move(profile));
+    }
+
+    // Worst first: unplayable, then least headroom; stills cost nothing after the first frame
+    auto rankKey = [](const ClipProfile& p) {
+        if (!p.opened || p.size.empty()) return -1.0;
+        return p.frameCount <= 1 ? 1e9 : p.headroom();
+    };
+    std::stable_sort(profiles.begin(), profiles.end(), [&](const ClipProfile& a, const ClipProfile& b) {
+        return rankKey(a) < rankKey(b);
+    });
+
+    bool allPlayable = true;
+    std::cout << std::fixed << std::setprecision(1);
+    for (size_t i = 0; i < profiles.size(); i++) {
+        const ClipProfile& p = profiles[i];
+        std::cout << std::setw(3) << i + 1 << ". " << std::filesystem::path(p.path).filename().string();
+        if (p.opened && !p.size.empty()) {
+            std::cout << "  " << p.size.width << "x" << p.size.height << " " << p.codec << " " << p.fps << " fps"
+                      << "  decode " << p.decodeFps << " fps"
+                      << (p.decodeThreads > 1 ? " on " + std::to_string(p.decodeThreads) + " threads" : "")
+                      << " (" << std::setprecision(2) << p.headroom() << "x)"
+                      << std::setprecision(1) << "  first frame " << p.openMs + p.firstFrameMs << " ms  loop "
+                      << p.loopWrapMs << " ms  GOP " << p.longestGop << " max / " << p.averageGop << " avg"
+                      << (p.gopExact ? "" : " (estimated)") << "  mem " << (p.peakMemoryBytes >> 20) << " MB";
+        }
+        std::cout << std::endl;
+        for (const std::string& warning : p.warnings) {
+            std::cout << "       ⚠ " << warning << std::endl;
+        }
+        if (!p.opened || p.size.empty() || (p.frameCount > 1 && p.decodeFps < p.fps)) {
+            allPlayable = false;
+        }
+    }
+    if (!peakExact) {
+        std::cout << "   (memory is the process peak: this kernel cannot reset it per clip)" << std::endl;
+    }
+
+    if (!jsonPath.empty() && writeJson(jsonPath, profiles, outputHz, outputSize)) {
+        std::cout << "🩺 Wrote clip profile to " << jsonPath << std::endl;
+    }
+    std::cout << "   " << (allPlayable ? "PASS" : "FAIL: some clips cannot play in real time here") << std::endl;
+    return allPlayable;
+}
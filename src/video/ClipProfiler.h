@@ -0,0 +1,32 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+// Decode capability of one clip on this machine, measured by the clip doctor
+struct ClipProfile {
+    std::string path;
+    bool opened = false;
+    std::string codec;
+    cv::Size size;
+    double fps = 0.0;             // The clip's own rate
+    int frameCount = 0;
+    double openMs = 0.0;          // Capture open
+    double firstFrameMs = 0.0;    // Open returned to first frame decoded
+    double decodeFps = 0.0;       // Sustained, decoding flat out
+    int decodeThreads = 1;        // Image sequences decode on a pool
+    double worstFrameMs = 0.0;
+    double loopWrapMs = 0.0;      // Rewind to frame 0 and read it, as playback does at the end
+    int longestGop = 0;           // Frames between keyframes
+    double averageGop = 0.0;
+    bool gopExact = false;
+    uint64_t peakMemoryBytes = 0; // Resident memory added while the clip was open
+    std::vector<std::string> warnings;
+
+    double headroom() const { return fps > 0 ? decodeFps / fps : 0.0; } // Multiple of real time
+};
+
+// --profile-clips: measures every clip in the CSV against the output rate and
+// size, prints them ranked worst first with warnings, and writes the same as
+// JSON. False if any clip cannot be opened or decoded in real time.
+bool runClipProfile(const std::string& csvPath, double outputHz, cv::Size outputSize, const std::string& jsonPath);
@@ -0,0 +1,249 @@
+#include "video/ClipReadahead.h"
+#include "video/VideoClip.h"
+#include "utils/Clock.h"
+#include "utils/Realtime.h"
+#include "utils/Trace.h"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+ClipReadahead::Stream::~Stream() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+ClipReadahead& ClipReadahead::instance() {
+    static ClipReadahead readahead;
+    return readahead;
+}
+
+ClipReadahead::ClipReadahead()
+    : windowBytes(0), pinLimitBytes(0), pinBudgetBytes(0), pinnedBytes(0), stopping(false), totalBytes(0), totalWaitUs(0), totalMisses(0) {
+}
+
+ClipReadahead::~ClipReadahead() {
+    stop();
+    for (const Pinned& pin : pinned) {
+        munmap(pin.address, pin.bytes);
+    }
+}
+
+void ClipReadahead::start(size_t window, size_t pinLimit, size_t pinBudget) {
+    windowBytes = window;
+    pinLimitBytes = pinLimit;
+    pinBudgetBytes = pinBudget;
+    if (windowBytes == 0 || ioThread.joinable()) return;
+
+    stopping = false;
+    ioThread = std::thread([this]() {
+        VJ_TRACE_THREAD_NAME("clip readahead");
+        Realtime::applyToCurrentThread(ThreadRole::Decode);
+        ioLoop();
+    });
+}
+
+void ClipReadahead::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    streamsCondition.notify_all();
+    if (ioThread.joinable()) {
+        ioThread.join();
+    }
+}
+
+void ClipReadahead::prepare(const std::string& path, ClipStats* stats) {
+    if (windowBytes == 0 && pinLimitBytes == 0) return;
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return;
+    }
+    size_t bytes = static_cast<size_t>(info.st_size);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        clips.emplace_back(path, stats);
+    }
+
+    const char* unpinnedReason = nullptr;
+    if (pinLimitBytes == 0) {
+        // Pinning is off
+    } else if (bytes > pinLimitBytes) {
+        unpinnedReason = "over --pin-clips-mb";
+    } else if (pinnedBytes + bytes > pinBudgetBytes) {
+        unpinnedReason = "over --pin-total-mb";
+    } else {
+        // MAP_POPULATE reads the whole file in now; the lock keeps it resident
+        uint64_t start = monotonicNs();
+        void* address = mmap(nullptr, bytes, PROT_READ, MAP_SHARED | MAP_POPULATE, fd, 0);
+        uint64_t waitUs = (monotonicNs() - start) / 1000;
+        if (address != MAP_FAILED) {
+            bool locked = mlock(address, bytes) == 0;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pinned.push_back({path, address, bytes, locked});
+                pinnedBytes += bytes;
+            }
+            stats->ioBytes.fetch_add(bytes, std::memory_order_relaxed);
+            stats->ioWaitUs.fetch_add(waitUs, std::memory_order_relaxed);
+            std::cout << "  📌 Pinned " << bytes / 1048576.0 << " MB in " << waitUs / 1000 << " ms"
+                      << (locked ? "" : " (cached, not locked: raise the memlock limit)") << std::endl;
+            ::close(fd);
+            return;
+        }
+        unpinnedReason = "mmap failed";
+    }
+    if (unpinnedReason) {
+        std::cout << "  📌 Not pinned (" << (bytes >> 20) << " MB, " << unpinnedReason << ")" << std::endl;
+        std::lock_guard<std::mutex> lock(mutex);
+        unpinned.push_back({path, bytes, unpinnedReason});
+    }
+
+    // Triggers start at the head (or a cue, which is pre-rolled anyway)
+    posix_fadvise(fd, 0, static_cast<off_t>(std::min(bytes, kHeadBytes)), POSIX_FADV_WILLNEED);
+    ::close(fd);
+}
+
+std::shared_ptr<ClipReadahead::Stream> ClipReadahead::open(const std::string& path, ClipStats* stats) {
+    if (windowBytes == 0 || !stats) return nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const Pinned& pin : pinned) {
+            if (pin.path == path) return nullptr; // Already resident
+        }
+    }
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL); // Larger kernel readahead for FFmpeg's own reads too
+
+    auto stream = std::make_shared<Stream>();
+    stream->path = path;
+    stream->stats = stats;
+    stream->fd = fd;
+    stream->fileBytes = static_cast<uint64_t>(info.st_size);
+    stream->position = 0.0;
+    stream->readOffset = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        streams.push_back(stream);
+    }
+    streamsCondition.notify_one();
+    return stream;
+}
+
+void ClipReadahead::ioLoop() {
+    std::vector<uint8_t> buffer(kChunkBytes);
+    std::vector<std::shared_ptr<Stream>> live;
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (!stopping) {
+        for (auto it = streams.begin(); it != streams.end();) {
+            if (auto stream = it->lock()) {
+                live.push_back(std::move(stream));
+                ++it;
+            } else {
+                it = streams.erase(it); // Clip stopped
+            }
+        }
+        if (live.empty()) {
+            streamsCondition.wait(lock, [this] { return stopping || !streams.empty(); });
+            continue;
+        }
+
+        // A chunk per stream in turn, so one clip far behind cannot starve the others
+        lock.unlock();
+        bool busy = false;
+        for (auto& stream : live) {
+            busy |= readAhead(*stream, buffer);
+        }
+        live.clear();
+        lock.lock();
+
+        if (!busy) {
+            streamsCondition.wait_for(lock, std::chrono::milliseconds(10), [this] { return stopping; });
+        }
+    }
+}
+
+bool ClipReadahead::readAhead(Stream& stream, std::vector<uint8_t>& buffer) {
+    // Frames are spread roughly evenly through the file; the window is
+    // wide enough to absorb the difference
+    double position = std::clamp(stream.position.load(std::memory_order_relaxed), 0.0, 1.0);
+    uint64_t played = static_cast<uint64_t>(position * stream.fileBytes);
+
+    if (played > stream.readOffset) {
+        // The decoder got past what was read ahead: its reads went to the drive
+        if (stream.readOffset > 0) {
+            stream.stats->readaheadMisses.fetch_add(1, std::memory_order_relaxed);
+            totalMisses.fetch_add(1, std::memory_order_relaxed);
+        }
+        stream.readOffset = played;
+    } else if (stream.readOffset > played + windowBytes + kChunkBytes) {
+        stream.readOffset = played; // Looped, reversed or jumped back
+    }
+
+    uint64_t end = std::min<uint64_t>(stream.fileBytes, played + windowBytes);
+    if (stream.readOffset >= end) return false;
+
+    VJ_TRACE_SCOPE("readahead");
+    size_t size = static_cast<size_t>(std::min<uint64_t>(kChunkBytes, end - stream.readOffset));
+    uint64_t start = monotonicNs();
+    ssize_t bytes = pread(stream.fd, buffer.data(), size, static_cast<off_t>(stream.readOffset));
+    uint64_t waitUs = (monotonicNs() - start) / 1000;
+    if (bytes <= 0) {
+        stream.readOffset = stream.fileBytes; // Short file or read error; FFmpeg will report it
+        return false;
+    }
+
+    stream.readOffset += static_cast<uint64_t>(bytes);
+    if (stream.readOffset >= stream.fileBytes) {
+        // Clips loop: have the head back in cache for the wrap
+        posix_fadvise(stream.fd, 0, static_cast<off_t>(std::min<uint64_t>(stream.fileBytes, kHeadBytes)),
+                      POSIX_FADV_WILLNEED);
+    }
+    stream.stats->ioBytes.fetch_add(static_cast<uint64_t>(bytes), std::memory_order_relaxed);
+    stream.stats->ioWaitUs.fetch_add(waitUs, std::memory_order_relaxed);
+    totalBytes.fetch_add(static_cast<uint64_t>(bytes), std::memory_order_relaxed);
+    totalWaitUs.fetch_add(waitUs, std::memory_order_relaxed);
+    return true;
+}
+
+void ClipReadahead::printStats() const {
+    if (windowBytes == 0 && pinned.empty() && unpinned.empty()) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::cout << "💾 Clip readahead: " << (totalBytes.load() >> 20) << " MB read ahead, I/O wait "
+              << totalWaitUs.load() / 1000 << " ms, " << totalMisses.load() << " misses; "
+              << pinned.size() << " clips pinned (" << (pinnedBytes >> 20) << " of "
+              << (pinBudgetBytes >> 20) << " MB budget)" << std::endl;
+    if (!unpinned.empty()) {
+        std::cout << "   " << unpinned.size() << " clips not pinned:" << std::endl;
+        for (const Unpinned& clip : unpinned) {
+            std::cout << "     " << std::filesystem::path(clip.path).filename().string() << ": "
+                      << (clip.bytes >> 20) << " MB, " << clip.reason << std::endl;
+        }
+    }
+    for (const auto& clip : clips) {
+        const ClipStats& stats = *clip.second;
+        uint64_t bytes = stats.ioBytes.load(std::memory_order_relaxed);
+        if (bytes == 0) continue;
+        std::cout << "   " << std::filesystem::path(clip.first).filename().string() << ": " << (bytes >> 20)
+                  << " MB, wait " << stats.ioWaitUs.load(std::memory_order_relaxed) / 1000 << " ms, "
+                  << stats.readaheadMisses.load(std::memory_order_relaxed) << " misses" << std::endl;
+    }
+}
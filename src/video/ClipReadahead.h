@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct ClipStats;
+
+// Keeps the part of each playing clip file just ahead of its decoder in
+// the page cache, so capture reads from slow or removable drives find
+// their data already in memory. One I/O thread reads a bounded window
+// ahead of every active stream, a chunk per stream in turn; the decoder
+// still reads through FFmpeg as before, but from cache. Short clips can
+// also be pinned whole at load.
+class ClipReadahead {
+public:
+    static constexpr size_t kChunkBytes = 1u << 20;
+    static constexpr size_t kHeadBytes = 4u << 20; // Warmed for every clip at load, for triggers
+
+    // One playing clip. The decoder reports how far through the file it
+    // is; dropping the last reference ends the readahead.
+    struct Stream {
+        std::string path;
+        ClipStats* stats;
+        int fd;
+        uint64_t fileBytes;
+        std::atomic<double> position; // 0..1, share of the clip's frames played
+        uint64_t readOffset;          // I/O thread only: end of what is already read ahead
+
+        ~Stream();
+    };
+
+    static ClipReadahead& instance();
+
+    // windowBytes = 0 turns streaming off; pinLimitBytes = 0 pins nothing.
+    // Clips are pinned in load order until pinBudgetBytes is used up.
+    void start(size_t windowBytes, size_t pinLimitBytes, size_t pinBudgetBytes);
+    void stop();
+    bool isEnabled() const { return windowBytes > 0; }
+
+    // Load time: warms the head of the file, and maps and locks the whole
+    // file when it is within the pin limit and the budget has room
+    void prepare(const std::string& path, ClipStats* stats);
+
+    // Null when streaming is off, the clip is pinned or the file cannot be opened
+    std::shared_ptr<Stream> open(const std::string& path, ClipStats* stats);
+
+    void printStats() const;
+
+private:
+    struct Pinned {
+        std::string path;
+        void* address;
+        size_t bytes;
+        bool locked;
+    };
+
+    struct Unpinned {
+        std::string path;
+        size_t bytes;
+        const char* reason;
+    };
+
+    size_t windowBytes;
+    size_t pinLimitBytes;
+    size_t pinBudgetBytes;
+    size_t pinnedBytes;
+    std::vector<Pinned> pinned;
+    std::vector<Unpinned> unpinned; // Within reach of --pin-clips-mb but not pinned
+    std::vector<std::pair<std::string, ClipStats*>> clips; // For the exit report
+
+    mutable std::mutex mutex;
+    std::condition_variable streamsCondition;
+    std::vector<std::weak_ptr<Stream>> streams;
+    std::thread ioThread;
+    bool stopping;
+
+    // Totals, I/O thread (and prepare) only
+    std::atomic<uint64_t> totalBytes;
+    std::atomic<uint64_t> totalWaitUs;
+    std::atomic<uint64_t> totalMisses;
+
+    ClipReadahead();
+    ~ClipReadahead();
+
+    void ioLoop();
+    bool readAhead(Stream& stream, std::vector<uint8_t>& buffer);
+};
@@ -0,0 +1,140 @@
+#include "video/EffectChain.h"
+#include "video/PixelKernels.h"
+#include <algorithm>
+#include <cmath>
+
+EffectChain::EffectChain()
+    : compiled(false), useColorMatrix(false), useLut(false), rgbSplit(0),
+      feedback(0.0f), strobePeriod(0), frameCounter(0) {
+}
+
+void EffectChain::reset() {
+    compiled = false;
+    feedbackFrame.release();
+    frameCounter = 0;
+}
+
+void EffectChain::compile(const EffectParams& params) {
+    compiledParams = params;
+    compiled = true;
+    
+    float brightness = std::clamp(params.get(EffectParam::Brightness), -1.0f, 1.0f) * 255.0f;
+    float contrast = std::max(params.get(EffectParam::Contrast), 0.0f);
+    float hue = params.get(EffectParam::Hue);
+    float invert = std::clamp(params.get(EffectParam::Invert), 0.0f, 1.0f);
+    int levels = static_cast<int>(std::lround(params.get(EffectParam::Posterize)));
+    
+    // Hue rotation about the grey axis; contrast and brightness are folded
+    // into the same 3x4 affine matrix so they cost no extra pass
+    useColorMatrix = std::fabs(hue) > 0.01f;
+    if (useColorMatrix) {
+        float angle = hue * static_cast<float>(CV_PI) / 180.0f;
+        float c = std::cos(angle);
+        float s = std::sin(angle);
+        float third = (1.0f - c) / 3.0f;
+        // Reversing channel order (RGB -> BGR) reverses the rotation direction
+        float root = -std::sqrt(1.0f / 3.0f) * s;
+        
+        float m[3][3] = {
+            { c + third,    third - root, third + root },
+            { third + root, c + third,    third - root },
+            { third - root, third + root, c + third    }
+        };
+        
+        colorMatrix.create(3, 4, CV_32F);
+        for (int row = 0; row < 3; row++) {
+            for (int col = 0; col < 3; col++) {
+                colorMatrix.at<float>(row, col) = contrast * m[row][col];
+            }
+            colorMatrix.at<float>(row, 3) = 128.0f * (1.0f - contrast) + brightness;
+        }
+    }
+    
+    bool pointOps = !useColorMatrix && (contrast != 1.0f || brightness != 0.0f);
+    useLut = pointOps || invert > 0.0f || levels >= 2;
+    if (useLut) {
+        lut.create(1, 256, CV_8U);
+        uchar* table = lut.ptr<uchar>();
+        for (int i = 0; i < 256; i++) {
+            float v = static_cast<float>(i);
+            if (pointOps) {
+                v = contrast * (v - 128.0f) + 128.0f + brightness;
+            }
+            v = std::clamp(v, 0.0f, 255.0f);
+            if (levels >= 2 && levels < 256) {
+                float step = 255.0f / (levels - 1);
+                v = std::round(std::round(v / step) * step);
+            }
+            v += invert * (255.0f - 2.0f * v);
+            table[i] = static_cast<uchar>(std::clamp(std::lround(v), 0L, 255L));
+        }
+    }
+    
+    rgbSplit = std::max(0, static_cast<int>(std::lround(params.get(EffectParam::RgbSplit))));
+    feedback = std::clamp(params.get(EffectParam::Feedback), 0.0f, 0.98f);
+    
+    float strobe = std::clamp(params.get(EffectParam::Strobe), 0.0f, 1.0f);
+    strobePeriod = strobe > 0.0f ? 2 + static_cast<int>(std::lround((1.0f - strobe) * 14.0f)) : 0;
+    
+    if (feedback <= 0.0f) {
+        feedbackFrame.release();
+    }
+}
+
+void EffectChain::apply(cv::Mat& frame, const EffectParams& params) {
+    if (frame.empty() || frame.type() != CV_8UC3) return;
+    
+    if (!compiled || params != compiledParams) {
+        compile(params);
+    }
+    
+    uint64_t frameIndex = frameCounter++;
+    if (strobePeriod > 0 && (frameIndex % strobePeriod) >= static_cast<uint64_t>(strobePeriod / 2)) {
+        pixel::clear(frame);
+        return;
+    }
+    
+    if (useColorMatrix) {
+        cv::transform(frame, frame, colorMatrix);
+    }
+    if (useLut) {
+        cv::LUT(frame, lut, frame);
+    }
+    if (rgbSplit > 0) {
+        applyRgbSplit(frame);
+    }
+    if (feedback > 0.0f) {
+        applyFeedback(frame);
+    }
+}
+
+void EffectChain::applyRgbSplit(cv::Mat& frame) const {
+    int offset = std::min(rgbSplit, frame.cols - 1);
+    if (offset <= 0) return;
+    
+    cv::parallel_for_(cv::Range(0, frame.rows), [&](const cv::Range& range) {
+        for (int y = range.start; y < range.end; y++) {
+            uchar* row = frame.ptr<uchar>(y);
+            int width = frame.cols;
+            
+            // Red moves right: walk backwards so sources are read before being overwritten
+            for (int x = width - 1; x >= offset; x--) {
+                row[x * 3 + 2] = row[(x - offset) * 3 + 2];
+            }
+            // Blue moves left: walk forwards for the same reason
+            for (int x = 0; x < width - offset; x++) {
+                row[x * 3] = row[(x + offset) * 3];
+            }
+        }
+    });
+}
+
+void EffectChain::applyFeedback(cv::Mat& frame) {
+    if (feedbackFrame.size() != frame.size() || feedbackFrame.type() != frame.type()) {
+        frame.copyTo(feedbackFrame);
+        return;
+    }
+    
+    pixel::blend(feedbackFrame, frame, pixel::BlendOp::Alpha, feedback);
+    frame.copyTo(feedbackFrame);
+}
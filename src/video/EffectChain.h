@@ -0,0 +1,38 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include "video/EffectParams.h"
+
+// Per-layer effect processing state. The chain is recompiled only when the
+// parameters change and runs in at most four in-place passes:
+//   1. colour matrix (hue rotation with contrast/brightness folded in)
+//   2. 8-bit LUT (contrast/brightness when no matrix, posterize, invert)
+//   3. RGB split
+//   4. feedback blend
+// Strobe dark frames short-circuit everything with a single clear.
+class EffectChain {
+public:
+    EffectChain();
+    
+    void apply(cv::Mat& frame, const EffectParams& params);
+    void reset();
+    
+private:
+    EffectParams compiledParams;
+    bool compiled;
+    
+    bool useColorMatrix;
+    cv::Mat colorMatrix; // 3x4 CV_32F, BGR order
+    bool useLut;
+    cv::Mat lut;         // 1x256 CV_8U, applied to all channels
+    int rgbSplit;
+    float feedback;
+    int strobePeriod;    // frames per flash cycle, 0 = off
+    
+    cv::Mat feedbackFrame;
+    uint64_t frameCounter;
+    
+    void compile(const EffectParams& params);
+    void applyRgbSplit(cv::Mat& frame) const;
+    void applyFeedback(cv::Mat& frame);
+};
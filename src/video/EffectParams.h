@@ -0,0 +1,51 @@
+#pragma once
+#include <string>
+
+// Effect parameters, in their natural units
+enum class EffectParam {
+    Brightness = 0, // -1..1, added as a fraction of full scale
+    Contrast,       // 0..3, 1 = unchanged
+    Hue,            // degrees, -180..180
+    Invert,         // 0..1, mix towards the negative
+    Strobe,         // 0..1, 0 = off, 1 = fastest flashing
+    RgbSplit,       // pixels of red/blue channel offset
+    Posterize,      // levels per channel, 0 = off
+    Feedback,       // 0..0.98, share of the previous frame kept (trails)
+    Count
+};
+
+struct EffectParams {
+    float values[static_cast<int>(EffectParam::Count)];
+    
+    EffectParams() { reset(); }
+    
+    void reset() {
+        for (float& value : values) value = 0.0f;
+        set(EffectParam::Contrast, 1.0f);
+    }
+    
+    float get(EffectParam param) const { return values[static_cast<int>(param)]; }
+    void set(EffectParam param, float value) { values[static_cast<int>(param)] = value; }
+    
+    bool operator==(const EffectParams& other) const {
+        for (int i = 0; i < static_cast<int>(EffectParam::Count); i++) {
+            if (values[i] != other.values[i]) return false;
+        }
+        return true;
+    }
+    bool operator!=(const EffectParams& other) const { return !(*this == other); }
+    
+    // "brightness", "hue", "rgb_split", ... -> EffectParam
+    static bool paramFromName(const std::string& name, EffectParam& param) {
+        static const char* names[] = {
+            "brightness", "contrast", "hue", "invert", "strobe", "rgb_split", "posterize", "feedback"
+        };
+        for (int i = 0; i < static_cast<int>(EffectParam::Count); i++) {
+            if (name == names[i]) {
+                param = static_cast<EffectParam>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+};
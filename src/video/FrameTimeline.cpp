@@ -0,0 +1,63 @@
+#include "video/FrameTimeline.h"
+#include <algorithm>
+
+void FrameTimeline::push(const cv::Mat& frame, uint64_t ptsNs) {
+    while (!entries.empty() && entries.back().ptsNs >= ptsNs) {
+        entries.pop_back();
+    }
+    if (entries.size() >= kCapacity) {
+        entries.pop_front();
+    }
+    entries.push_back({frame, ptsNs});
+}
+
+FrameTimeline::Selection FrameTimeline::select(uint64_t outputNs, FrameRateMode mode) {
+    Selection selection;
+    if (entries.empty()) return selection;
+    selection.valid = true;
+
+    if (mode == FrameRateMode::Latest) {
+        selection.frame = entries.back().frame;
+        selection.ptsNs = entries.back().ptsNs;
+        entries.erase(entries.begin(), entries.end() - 1);
+        return selection;
+    }
+
+    // Last frame due at or before the tick; a launch shows its first frame
+    // straight away even if it is stamped for later
+    size_t current = 0;
+    while (current + 1 < entries.size() && entries[current + 1].ptsNs <= outputNs) {
+        current++;
+    }
+    entries.erase(entries.begin(), entries.begin() + current); // Never needed again: ticks only move forward
+
+    const Entry& shown = entries[0];
+    selection.frame = shown.frame;
+    selection.ptsNs = shown.ptsNs;
+    if (entries.size() < 2 || outputNs <= shown.ptsNs) return selection;
+
+    const Entry& next = entries[1];
+    double position = static_cast<double>(outputNs - shown.ptsNs) / static_cast<double>(next.ptsNs - shown.ptsNs);
+    if (mode == FrameRateMode::Nearest) {
+        // Biased off the midpoint: when the output and clip clocks are in step
+        // (30 fps on 60 Hz), ticks land exactly on it and rounding noise
+        // would alternate the choice
+        if (position > 0.5 + 1e-3) {
+            selection.frame = next.frame;
+            selection.ptsNs = next.ptsNs;
+        }
+    } else {
+        selection.next = next.frame;
+        selection.nextPtsNs = next.ptsNs;
+        selection.weight = static_cast<float>(std::clamp(position, 0.0, 1.0));
+    }
+    return selection;
+}
+
+bool parseFrameRateMode(const std::string& name, FrameRateMode& mode) {
+    if (name == "off") mode = FrameRateMode::Latest;
+    else if (name == "nearest") mode = FrameRateMode::Nearest;
+    else if (name == "blend") mode = FrameRateMode::Blend;
+    else return false;
+    return true;
+}
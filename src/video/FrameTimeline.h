@@ -0,0 +1,54 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+// How the compositor maps clip frames onto its own output clock
+enum class FrameRateMode {
+    Latest,  // Whatever frame arrived last (no conversion)
+    Nearest, // Frame whose presentation time is nearest the output tick: even 3:2-style cadence
+    Blend    // Mix of the two frames around the output tick, weighted by time
+};
+
+// Recently decoded frames of one playing clip with their presentation times
+// (monotonic ns). The decoder runs one frame ahead, so the frame after the
+// one on screen is usually already here. Not thread-safe; PlayingVideo
+// guards it with its frame mutex.
+class FrameTimeline {
+public:
+    static constexpr size_t kCapacity = 4;
+
+    struct Selection {
+        cv::Mat frame;
+        uint64_t ptsNs = 0;
+        cv::Mat next;       // Blend only: the following frame, mixed in by weight
+        uint64_t nextPtsNs = 0;
+        float weight = 0.0f;
+        bool valid = false;
+    };
+
+    // Clip frames a decoder should stamp ahead of the one it is due to
+    // show: blending needs the frame after the current one in hand too
+    static int presentationLead(FrameRateMode mode) { return mode == FrameRateMode::Blend ? 2 : 1; }
+    
+    // A frame stamped earlier than the newest one (seek, scratch, relaunch)
+    // replaces the frames after it
+    void push(const cv::Mat& frame, uint64_t ptsNs);
+    Selection select(uint64_t outputNs, FrameRateMode mode);
+    void clear() { entries.clear(); }
+    bool empty() const { return entries.empty(); }
+
+private:
+    struct Entry {
+        cv::Mat frame;
+        uint64_t ptsNs;
+    };
+    std::deque<Entry> entries;
+};
+
+bool parseFrameRateMode(const std::string& name, FrameRateMode& mode);
+
+// Simulates common clip rates against 50/60 Hz outputs and reports judder
+// and cadence error for each mode; false if converted output is not even
+bool runCadenceBench();
@@ -0,0 +1,182 @@
+#include "video/FrameTimeline.h"
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+constexpr double kSeconds = 20.0;
+constexpr uint64_t kNsPerSecond = 1000000000ULL;
+
+enum class Pipeline {
+    Before,  // sleep_for(16 ms) render loop showing whatever arrived last
+    Off,     // Paced render loop, no conversion
+    Nearest,
+    Blend
+};
+
+struct Result {
+    double judderMs;     // RMS deviation of shown clip time from a steady clock, constant latency removed
+    double cadenceError; // Fraction of frames held for a number of ticks outside the ideal pattern
+};
+
+uint64_t toNs(double seconds) {
+    return static_cast<uint64_t>(seconds * kNsPerSecond);
+}
+
+Result simulate(double clipFps, double outputHz, Pipeline pipeline) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> decodeJitter(0.001, 0.006);
+    std::uniform_real_distribution<double> renderWork(0.001, 0.005);
+    std::uniform_real_distribution<double> wakeJitter(0.0, 0.0003);
+
+    // The decoder's frames: deadline k / fps, arriving a few ms after it.
+    // Converted modes stamp them ahead (see presentationLead); the others show them on arrival.
+    const double clipInterval = 1.0 / clipFps;
+    const bool stamped = pipeline == Pipeline::Nearest || pipeline == Pipeline::Blend;
+    FrameRateMode mode = pipeline == Pipeline::Nearest ? FrameRateMode::Nearest
+                       : pipeline == Pipeline::Blend   ? FrameRateMode::Blend
+                                                       : FrameRateMode::Latest;
+    const int lead = FrameTimeline::presentationLead(mode);
+    struct Published { uint64_t arrivalNs; uint64_t ptsNs; int index; };
+    std::vector<Published> frames;
+    std::map<uint64_t, int> indexOfPts;
+    for (int k = 0; k * clipInterval < kSeconds + 1.0; k++) {
+        uint64_t arrival = toNs(0.5 + k * clipInterval + decodeJitter(rng));
+        uint64_t pts = stamped ? toNs(0.5 + (k + lead) * clipInterval) : arrival;
+        frames.push_back({arrival, pts, k});
+        indexOfPts[pts] = k;
+    }
+
+    FrameTimeline timeline;
+    size_t nextFrame = 0;
+    std::vector<double> shownTime;   // Clip time on screen per tick, in frames
+    std::vector<double> tickTime;    // Output time of each tick, in frames of the clip
+    std::vector<int> shownIndex;
+
+    double scheduled = 1.0; // Output starts half a second into the clip
+    const double outputInterval = 1.0 / outputHz;
+    while (scheduled < kSeconds) {
+        // Paced loops select for their scheduled tick; they wake slightly late,
+        // which only decides whether a frame has arrived in time
+        double now = pipeline == Pipeline::Before ? scheduled : scheduled + wakeJitter(rng);
+        while (nextFrame < frames.size() && frames[nextFrame].arrivalNs <= toNs(now)) {
+            timeline.push(cv::Mat(), frames[nextFrame].ptsNs);
+            nextFrame++;
+        }
+
+        FrameTimeline::Selection selection = timeline.select(toNs(scheduled), mode);
+        if (selection.valid) {
+            int index = indexOfPts[selection.ptsNs];
+            double shown = index;
+            if (selection.weight > 0.0f) {
+                shown += selection.weight * (indexOfPts[selection.nextPtsNs] - index);
+            }
+            shownTime.push_back(shown);
+            shownIndex.push_back(selection.weight > 0.0f ? -1 : index);
+            tickTime.push_back((scheduled - 0.5) * clipFps);
+        }
+
+        if (pipeline == Pipeline::Before) {
+            scheduled += renderWork(rng) + 0.016 + 0.001; // Work, sleep_for(16 ms), waitKey(1)
+        } else {
+            scheduled += outputInterval;
+        }
+    }
+
+    Result result{0.0, 0.0};
+    if (shownTime.size() < 2) return result;
+
+    double meanError = 0;
+    for (size_t i = 0; i < shownTime.size(); i++) {
+        meanError += shownTime[i] - tickTime[i];
+    }
+    meanError /= shownTime.size();
+    double sumSquares = 0;
+    for (size_t i = 0; i < shownTime.size(); i++) {
+        double error = shownTime[i] - tickTime[i] - meanError;
+        sumSquares += error * error;
+    }
+    result.judderMs = std::sqrt(sumSquares / shownTime.size()) * clipInterval * 1000.0;
+
+    if (pipeline == Pipeline::Blend) {
+        result.cadenceError = -1; // Every tick is a new picture; cadence does not apply
+        return result;
+    }
+
+    // Run lengths of each shown frame; the first and last runs are partial.
+    // The old loop did not tick at outputHz, so its ideal hold is measured.
+    const double ratio = pipeline == Pipeline::Before
+        ? static_cast<double>(shownIndex.size()) / (shownIndex.back() - shownIndex.front() + 1)
+        : outputHz / clipFps;
+    const int shortHold = static_cast<int>(std::floor(ratio + 1e-9));
+    const int longHold = static_cast<int>(std::ceil(ratio - 1e-9));
+    int runs = 0, badRuns = 0, hold = 1;
+    bool firstRun = true;
+    for (size_t i = 1; i < shownIndex.size(); i++) {
+        if (shownIndex[i] == shownIndex[i - 1]) {
+            hold++;
+            continue;
+        }
+        bool skipped = shownIndex[i] != shownIndex[i - 1] + 1;
+        if (!firstRun) {
+            runs++;
+            if (hold < std::max(1, shortHold) || hold > std::max(1, longHold) || skipped) badRuns++;
+        }
+        firstRun = false;
+        hold = 1;
+    }
+    result.cadenceError = runs ? static_cast<double>(badRuns) / runs : 0.0;
+    return result;
+}
+
+} // namespace
+
+bool runCadenceBench() {
+    const double clipRates[] = {23.976, 24.0, 25.0, 29.97, 30.0, 50.0};
+    const double outputRates[] = {60.0, 50.0};
+    const char* names[] = {"before", "off", "nearest", "blend"};
+    bool allPassed = true;
+
+    std::cout << "🎞️  Frame-rate conversion, " << kSeconds << " s simulated per case, decode jitter 1-6 ms" << std::endl;
+    std::cout << "   judder = RMS error of shown clip time (ms); cadence = frames held outside the ideal pattern" << std::endl;
+    std::cout << "   " << std::left << std::setw(10) << "clip" << std::setw(8) << "output";
+    for (const char* name : names) {
+        std::cout << std::right << std::setw(20) << name;
+    }
+    std::cout << std::endl;
+
+    for (double outputHz : outputRates) {
+        for (double clipFps : clipRates) {
+            if (clipFps > outputHz) continue;
+
+            std::cout << "   " << std::left << std::setw(10) << clipFps << std::setw(8)
+                      << (std::to_string(static_cast<int>(outputHz)) + " Hz");
+            Result results[4];
+            for (int p = 0; p < 4; p++) {
+                results[p] = simulate(clipFps, outputHz, static_cast<Pipeline>(p));
+                std::ostringstream cell;
+                cell << std::fixed << std::setprecision(2) << results[p].judderMs << " ms";
+                if (results[p].cadenceError >= 0) {
+                    cell << " " << std::setprecision(1) << results[p].cadenceError * 100 << "%";
+                }
+                std::cout << std::right << std::setw(20) << cell.str();
+            }
+            std::cout << std::endl;
+
+            // Conversion must hold an even cadence, and blending must not add judder
+            const Result& nearest = results[static_cast<int>(Pipeline::Nearest)];
+            const Result& blend = results[static_cast<int>(Pipeline::Blend)];
+            if (nearest.cadenceError > 0 || blend.judderMs > nearest.judderMs + 0.05) {
+                allPassed = false;
+            }
+        }
+    }
+
+    std::cout << "   " << (allPassed ? "PASS" : "FAIL") << std::endl;
+    return allPassed;
+}
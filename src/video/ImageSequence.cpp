@@ -0,0 +1,271 @@
+#include "video/ImageSequence.h"
+#include "utils/Log.h"
+#include "utils/Realtime.h"
+#include "utils/Trace.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+bool hasImageExtension(const std::filesystem::path& path) {
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".bmp" ||
+           ext == ".tif" || ext == ".tiff" || ext == ".webp";
+}
+
+// Frame number = last run of digits in the file name ("shot_0042.png" -> 42), -1 if none
+long long frameNumber(const std::string& stem) {
+    size_t end = stem.size();
+    while (end > 0 && !std::isdigit(static_cast<unsigned char>(stem[end - 1]))) end--;
+    size_t begin = end;
+    while (begin > 0 && std::isdigit(static_cast<unsigned char>(stem[begin - 1]))) begin--;
+    if (begin == end) return -1;
+    return std::stoll(stem.substr(begin, std::min<size_t>(end - begin, 18)));
+}
+
+// Straight alpha over black: c * a / 255, rounded
+void flattenAlpha(const cv::Mat& bgra, cv::Mat& bgr) {
+    bgr.create(bgra.size(), CV_8UC3);
+    for (int y = 0; y < bgra.rows; y++) {
+        const uchar* s = bgra.ptr<uchar>(y);
+        uchar* d = bgr.ptr<uchar>(y);
+        for (int x = 0; x < bgra.cols; x++, s += 4, d += 3) {
+            int a = s[3];
+            for (int c = 0; c < 3; c++) {
+                int t = s[c] * a + 128;
+                d[c] = static_cast<uchar>((t + (t >> 8)) >> 8);
+            }
+        }
+    }
+}
+
+} // namespace
+
+bool ImageSequence::isImageSource(const std::string& path) {
+    std::error_code error;
+    if (std::filesystem::is_directory(path, error)) return true;
+    return hasImageExtension(path);
+}
+
+std::vector<std::string> ImageSequence::listFrames(const std::string& path) {
+    std::vector<std::string> files;
+    std::error_code error;
+    if (!std::filesystem::is_directory(path, error)) {
+        if (std::filesystem::is_regular_file(path, error)) files.push_back(path); // Single still
+        return files;
+    }
+
+    std::vector<std::pair<long long, std::string>> numbered;
+    for (const auto& entry : std::filesystem::directory_iterator(path, error)) {
+        if (!entry.is_regular_file() || !hasImageExtension(entry.path())) continue;
+        numbered.emplace_back(frameNumber(entry.path().stem().string()), entry.path().string());
+    }
+    std::sort(numbered.begin(), numbered.end()); // By number, then by name
+
+    for (auto& item : numbered) {
+        files.push_back(std::move(item.second));
+    }
+    return files;
+}
+
+bool ImageSequence::decodeFile(const std::string& file, cv::Mat& frame) {
+    int fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    // The decoder reads straight from the page cache: no read() copy
+    size_t size = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) return false;
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    cv::Mat decoded;
+    try {
+        decoded = cv::imdecode(cv::Mat(1, static_cast<int>(size), CV_8U, data), cv::IMREAD_UNCHANGED);
+    } catch (const cv::Exception&) {
+        decoded.release();
+    }
+    munmap(data, size);
+    if (decoded.empty()) return false;
+
+    // The compositor works in 8-bit BGR
+    if (decoded.depth() != CV_8U) {
+        decoded.convertTo(decoded, CV_8U, decoded.depth() == CV_16U ? 1.0 / 257.0 : 255.0);
+    }
+    switch (decoded.channels()) {
+        case 1:
+            cv::cvtColor(decoded, frame, cv::COLOR_GRAY2BGR);
+            break;
+        case 4:
+            flattenAlpha(decoded, frame);
+            break;
+        default:
+            frame = decoded;
+            break;
+    }
+    return true;
+}
+
+int ImageSequence::workersFor(double decodeMs, double fps) {
+    // Never more than the cores: past that workers only queue for them
+    int cores = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+    int needed = static_cast<int>(std::ceil(decodeMs * fps * 1.5 / 1000.0));
+    return std::clamp(needed, 2, cores);
+}
+
+ImageSequence::ImageSequence(const std::string& path, double framesPerSecond, size_t budget)
+    : files(listFrames(path)), fps(framesPerSecond > 0 ? framesPerSecond : kDefaultFps),
+      cacheBudgetBytes(budget), cacheBytes(0), decodeMs(0.0), workerCount(0), useCounter(0),
+      reportedFailure(false), stopping(false) {
+    if (files.empty()) {
+        throw std::runtime_error("No images found for: " + path);
+    }
+
+    // Time the first frame (it is needed first anyway) and start enough
+    // workers to decode at the playback rate with half as much again spare
+    auto start = std::chrono::steady_clock::now();
+    cv::Mat first;
+    decodeFile(files.front(), first);
+    decodeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    Entry& entry = cache[0];
+    entry.frame = first;
+    entry.lastUsed = ++useCounter;
+    cacheBytes += first.total() * first.elemSize();
+
+    workerCount = files.size() == 1 ? 1 : workersFor(decodeMs, fps);
+    readAhead = std::min(static_cast<int>(files.size()) - 1, workerCount * 3);
+
+    std::string name = std::filesystem::path(path).filename().string();
+    VJ_LOG_INFO("🖼️  {}: {} ms per image, {} decode workers (about {} fps)", name,
+                static_cast<int>(decodeMs + 0.5), workerCount,
+                static_cast<int>(workerCount * 1000.0 / std::max(decodeMs, 0.001)));
+    for (int i = 0; i < workerCount; i++) {
+        workers.emplace_back([this, name]() {
+            VJ_TRACE_THREAD_NAME("images " + name);
+            Realtime::applyToCurrentThread(ThreadRole::Decode); // Not the creator's priority
+            workerLoop();
+        });
+    }
+}
+
+ImageSequence::~ImageSequence() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    requestCondition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+bool ImageSequence::isQueued(int frameIndex) const {
+    // Caller holds mutex
+    return cache.count(frameIndex) || inFlight.count(frameIndex) ||
+           std::find(requests.begin(), requests.end(), frameIndex) != requests.end();
+}
+
+bool ImageSequence::getFrame(int frameIndex, cv::Mat& frame, int64_t waitUs) {
+    if (frameIndex < 0 || frameIndex >= getFrameCount()) return false;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it = cache.find(frameIndex);
+    if (it == cache.end()) {
+        if (!isQueued(frameIndex)) {
+            requests.push_front(frameIndex); // Needed now: ahead of any read-ahead
+            requestCondition.notify_one();
+        }
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(waitUs);
+        readyCondition.wait_until(lock, deadline, [&]() {
+            return stopping || cache.find(frameIndex) != cache.end();
+        });
+        it = cache.find(frameIndex);
+        if (it == cache.end()) return false;
+    }
+
+    it->second.lastUsed = ++useCounter;
+    frame = it->second.frame;
+    return !frame.empty();
+}
+
+void ImageSequence::prefetch(int frameIndex, int step) {
+    int frameCount = getFrameCount();
+    if (frameCount <= 1 || step == 0) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    requests.clear(); // Anything not started yet belongs to an older playhead
+    for (int i = 1; i <= readAhead; i++) {
+        int target = (((frameIndex + i * step) % frameCount) + frameCount) % frameCount;
+        if (!isQueued(target)) {
+            requests.push_back(target);
+        }
+    }
+    requestCondition.notify_all();
+}
+
+void ImageSequence::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        requestCondition.wait(lock, [this]() { return stopping || !requests.empty(); });
+        if (stopping) return;
+
+        int frameIndex = requests.front();
+        requests.pop_front();
+        if (cache.count(frameIndex) || inFlight.count(frameIndex)) continue;
+        inFlight.insert(frameIndex);
+        const std::string& file = files[frameIndex];
+
+        lock.unlock();
+        cv::Mat frame;
+        bool decoded;
+        {
+            VJ_TRACE_SCOPE("decode image");
+            decoded = decodeFile(file, frame);
+        }
+        lock.lock();
+
+        inFlight.erase(frameIndex);
+        if (!decoded && !reportedFailure) {
+            reportedFailure = true;
+            VJ_LOG_WARN("⚠ Cannot decode image: {}", file);
+        }
+
+        // Failed frames are cached empty so they are not retried every pass
+        Entry& entry = cache[frameIndex];
+        entry.frame = frame;
+        entry.lastUsed = ++useCounter;
+        cacheBytes += frame.total() * frame.elemSize();
+        evict();
+        readyCondition.notify_all();
+    }
+}
+
+void ImageSequence::evict() {
+    // Caller holds mutex. A frame still on screen stays alive through the
+    // reader's Mat reference after it leaves the cache.
+    while (cacheBytes > cacheBudgetBytes && cache.size() > 1) {
+        auto oldest = cache.begin();
+        for (auto it = cache.begin(); it != cache.end(); ++it) {
+            if (it->second.lastUsed < oldest->second.lastUsed) {
+                oldest = it;
+            }
+        }
+        cacheBytes -= oldest->second.frame.total() * oldest->second.frame.elemSize();
+        cache.erase(oldest);
+    }
+}
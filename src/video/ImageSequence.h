@@ -0,0 +1,77 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Clip source for a directory of numbered images (PNG, JPEG, ...) or a
+// single still. Every frame is independently decodable, so the same source
+// serves forward play, reverse, varispeed and scratch. Files are read
+// through mmap and decoded ahead of the playhead by a pool of workers into
+// an LRU cache held under a byte budget, like ClipDecoder's blocks.
+class ImageSequence {
+public:
+    static constexpr double kDefaultFps = 30.0;
+
+    static bool isImageSource(const std::string& path);
+    static std::vector<std::string> listFrames(const std::string& path); // Sorted by frame number
+
+    // Decodes one file to 8-bit BGR; alpha is flattened over black
+    static bool decodeFile(const std::string& file, cv::Mat& frame);
+
+    // Lists the files and decodes the first one to size the worker pool:
+    // tens of ms for large images, so never call it on the MIDI thread
+    ImageSequence(const std::string& path, double fps, size_t cacheBudgetBytes = 512u << 20);
+    ~ImageSequence();
+
+    int getFrameCount() const { return static_cast<int>(files.size()); }
+    double getFps() const { return fps; }
+    double getDecodeMs() const { return decodeMs; } // First frame, single-threaded
+    int getWorkerCount() const { return workerCount; }
+
+    // Pool size that sustains fps given one image's decode time
+    static int workersFor(double decodeMs, double fps);
+
+    // Returns the frame if cached; otherwise queues it first and waits up to
+    // waitUs. The frame shares the cached buffer.
+    bool getFrame(int frameIndex, cv::Mat& frame, int64_t waitUs);
+
+    // Queues the frames after frameIndex, `step` apart (negative = reverse),
+    // replacing any older read-ahead that has not started yet
+    void prefetch(int frameIndex, int step);
+
+private:
+    struct Entry {
+        cv::Mat frame; // Empty if the file failed to decode
+        uint64_t lastUsed;
+    };
+
+    std::vector<std::string> files;
+    double fps;
+    size_t cacheBudgetBytes;
+    size_t cacheBytes;
+    double decodeMs;
+    int workerCount;
+    int readAhead;
+
+    std::map<int, Entry> cache;
+    std::deque<int> requests;
+    std::set<int> inFlight;
+    uint64_t useCounter;
+    bool reportedFailure;
+    std::mutex mutex;
+    std::condition_variable requestCondition;
+    std::condition_variable readyCondition;
+    std::vector<std::thread> workers;
+    bool stopping;
+
+    bool isQueued(int frameIndex) const;
+    void workerLoop();
+    void evict();
+};
@@ -0,0 +1,153 @@
+#include "video/KeyframeIndex.h"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+
+// Estimated GOP when the backend cannot report keyframes. OpenCV's frame
+// seek is still exact in that case, just slower.
+static const int kFallbackGop = 32;
+
+std::shared_ptr<KeyframeIndex> KeyframeIndex::loadOrBuild(const std::string& videoPath) {
+    std::shared_ptr<KeyframeIndex> index(new KeyframeIndex());
+    
+    std::error_code error;
+    auto size = std::filesystem::file_size(videoPath, error);
+    auto mtime = std::filesystem::last_write_time(videoPath, error);
+    if (error) return nullptr;
+    
+    // The cache entry is only valid for the exact file it was built from
+    std::ostringstream stamp;
+    stamp << size << " " << mtime.time_since_epoch().count();
+    std::string cachePath = cachePathFor(videoPath);
+    
+    if (index->loadCache(cachePath, stamp.str())) {
+        return index;
+    }
+    
+    if (!index->build(videoPath)) {
+        return nullptr;
+    }
+    index->saveCache(cachePath, stamp.str());
+    return index;
+}
+
+std::string KeyframeIndex::cachePathFor(const std::string& videoPath) {
+    std::filesystem::path base;
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME")) {
+        base = xdg;
+    } else if (const char* home = std::getenv("HOME")) {
+        base = std::filesystem::path(home) / ".cache";
+    } else {
+        base = std::filesystem::temp_directory_path();
+    }
+    
+    std::error_code error;
+    std::string absolute = std::filesystem::absolute(videoPath, error).string();
+    std::ostringstream name;
+    name << std::hex << std::hash<std::string>{}(absolute) << ".vjidx";
+    return (base / "vj-app" / name.str()).string();
+}
+
+bool KeyframeIndex::build(const std::string& videoPath) {
+    cv::VideoCapture probe(videoPath);
+    if (!probe.isOpened()) return false;
+    
+    fps = probe.get(cv::CAP_PROP_FPS);
+    if (fps <= 0) fps = 30;
+    frameCount = static_cast<int>(probe.get(cv::CAP_PROP_FRAME_COUNT));
+    probe.release();
+    
+    keyframes.clear();
+    exact = false;
+    
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 6)
+    // Raw stream mode hands back demuxed packets without decoding them,
+    // along with each packet's keyframe flag
+    cv::VideoCapture packets;
+    if (packets.open(videoPath, cv::CAP_FFMPEG, {cv::CAP_PROP_FORMAT, -1})) {
+        int frame = 0;
+        while (packets.grab()) {
+            if (packets.get(cv::CAP_PROP_LRF_HAS_KEY_FRAME) != 0) {
+                keyframes.push_back(frame);
+            }
+            frame++;
+        }
+        if (!keyframes.empty() && keyframes[0] == 0) {
+            exact = true;
+            frameCount = frame;
+        } else {
+            keyframes.clear();
+        }
+    }
+#endif
+    
+    if (!exact) {
+        for (int frame = 0; frame < std::max(frameCount, 1); frame += kFallbackGop) {
+            keyframes.push_back(frame);
+        }
+    }
+    
+    std::cout << "  🔑 Indexed " << videoPath << ": " << frameCount << " frames, "
+              << keyframes.size() << " keyframes" << (exact ? "" : " (estimated)")
+              << ", longest GOP " << getLongestGop() << std::endl;
+    return frameCount > 0;
+}
+
+bool KeyframeIndex::loadCache(const std::string& cachePath, const std::string& stamp) {
+    std::ifstream in(cachePath);
+    if (!in.is_open()) return false;
+    
+    std::string magic, cachedStamp;
+    int version = 0;
+    in >> magic >> version;
+    in.ignore();
+    std::getline(in, cachedStamp);
+    if (magic != "vjidx" || version != 1 || cachedStamp != stamp) return false;
+    
+    size_t count = 0;
+    in >> fps >> frameCount >> exact >> count;
+    keyframes.resize(count);
+    for (auto& keyframe : keyframes) {
+        in >> keyframe;
+    }
+    
+    return in.good() && frameCount > 0 && !keyframes.empty();
+}
+
+void KeyframeIndex::saveCache(const std::string& cachePath, const std::string& stamp) const {
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+    
+    std::ofstream out(cachePath);
+    if (!out.is_open()) return; // Caching is an optimisation only
+    
+    out << "vjidx 1\n" << stamp << "\n";
+    out << fps << " " << frameCount << " " << exact << " " << keyframes.size() << "\n";
+    for (int keyframe : keyframes) {
+        out << keyframe << "\n";
+    }
+}
+
+int KeyframeIndex::keyframeAtOrBefore(int frame) const {
+    auto it = std::upper_bound(keyframes.begin(), keyframes.end(), frame);
+    return it == keyframes.begin() ? 0 : *(it - 1);
+}
+
+int KeyframeIndex::nextKeyframeAfter(int frame) const {
+    auto it = std::upper_bound(keyframes.begin(), keyframes.end(), frame);
+    return it == keyframes.end() ? frameCount : *it;
+}
+
+int KeyframeIndex::getLongestGop() const {
+    int longest = 0;
+    for (size_t i = 0; i < keyframes.size(); i++) {
+        int end = (i + 1 < keyframes.size()) ? keyframes[i + 1] : frameCount;
+        longest = std::max(longest, end - keyframes[i]);
+    }
+    return longest;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+
+// Keyframe (GOP) positions of one clip. Built at load time by scanning the
+// container's packets, which needs no decoding, and cached under
+// ~/.cache/vj-app so later launches read it back instantly.
+class KeyframeIndex {
+public:
+    static std::shared_ptr<KeyframeIndex> loadOrBuild(const std::string& videoPath);
+    
+    int getFrameCount() const { return frameCount; }
+    double getFps() const { return fps; }
+    bool isExact() const { return exact; } // false = packet scan unsupported, keyframes estimated
+    
+    int keyframeAtOrBefore(int frame) const;
+    int nextKeyframeAfter(int frame) const; // frameCount if none
+    int getLongestGop() const;
+    
+private:
+    std::vector<int> keyframes;
+    int frameCount;
+    double fps;
+    bool exact;
+    
+    KeyframeIndex() : frameCount(0), fps(30.0), exact(false) {}
+    
+    bool build(const std::string& videoPath);
+    bool loadCache(const std::string& cachePath, const std::string& stamp);
+    void saveCache(const std::string& cachePath, const std::string& stamp) const;
+    static std::string cachePathFor(const std::string& videoPath);
+};
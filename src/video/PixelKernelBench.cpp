@@ -0,0 +1,206 @@
+#include "video/PixelKernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace pixel {
+
+namespace {
+
+struct Image {
+    int width, height, channels;
+    size_t stride;
+    std::vector<uint8_t> bytes;
+
+    Image(int w, int h, int cn, uint32_t seed) : width(w), height(h), channels(cn) {
+        stride = static_cast<size_t>(w) * cn + 13; // Odd padding catches stride mistakes
+        bytes.resize(stride * h + 64);
+        std::mt19937 rng(seed);
+        for (auto& b : bytes) b = static_cast<uint8_t>(rng());
+    }
+
+    uint8_t* data() { return bytes.data(); }
+    const uint8_t* data() const { return bytes.data(); }
+
+    bool samePixels(const Image& other) const {
+        for (int y = 0; y < height; y++) {
+            if (std::memcmp(&bytes[y * stride], &other.bytes[y * other.stride], width * channels) != 0) return false;
+        }
+        return true;
+    }
+
+    // Bytes between and after rows must never be written
+    bool samePadding(const Image& other) const {
+        for (int y = 0; y < height; y++) {
+            size_t rowEnd = y * stride + width * channels;
+            size_t next = (y + 1 < height) ? (y + 1) * stride : bytes.size();
+            if (std::memcmp(&bytes[rowEnd], &other.bytes[rowEnd], next - rowEnd) != 0) return false;
+        }
+        return true;
+    }
+};
+
+// One kernel invocation on a given table, writing into `out`
+typedef std::function<void(const KernelTable&, Image& out)> KernelRun;
+
+struct KernelCase {
+    std::string name;
+    int outChannels;
+    KernelRun run;
+};
+
+std::vector<KernelCase> makeCases(int width, int height) {
+    std::vector<KernelCase> cases;
+    const char* formatNames[] = {"bgr", "bgra"};
+    const char* opNames[] = {"alpha", "add", "multiply", "screen"};
+
+    for (int f = 0; f < kFormats; f++) {
+        int cn = channels(static_cast<Format>(f));
+        auto src = std::make_shared<Image>(width, height, cn, 1);
+        auto scaleSrc = std::make_shared<Image>(width * 2 / 3 + 1, height * 3 / 2 + 1, cn, 2);
+
+        for (int op = 0; op < kBlendOps; op++) {
+            cases.push_back({std::string("blend ") + opNames[op] + " " + formatNames[f], cn,
+                [=](const KernelTable& table, Image& out) {
+                    table.blend[f][op](src->data(), src->stride, out.data(), out.stride, width, height, 77);
+                }});
+        }
+        cases.push_back({std::string("fade ") + formatNames[f], cn,
+            [=](const KernelTable& table, Image& out) {
+                table.fade[f](out.data(), out.stride, width, height, 181);
+            }});
+        cases.push_back({std::string("clear ") + formatNames[f], cn,
+            [=](const KernelTable& table, Image& out) {
+                const uint8_t color[4] = {12, 34, 56, 78};
+                table.clear[f](out.data(), out.stride, width, height, color);
+            }});
+        cases.push_back({std::string("scale ") + formatNames[f], cn,
+            [=](const KernelTable& table, Image& out) {
+                std::vector<uint8_t> scratch(scaleScratchBytes(width, static_cast<Format>(f)));
+                table.scale[f](scaleSrc->data(), scaleSrc->stride, scaleSrc->width, scaleSrc->height,
+                               out.data(), out.stride, width, height, 0, height, scratch.data());
+            }});
+    }
+
+    auto bgr = std::make_shared<Image>(width, height, 3, 3);
+    auto bgra = std::make_shared<Image>(width, height, 4, 4);
+    cases.push_back({"bgr->bgra", 4, [=](const KernelTable& table, Image& out) {
+        table.convert[static_cast<int>(Conversion::BgrToBgra)](bgr->data(), bgr->stride, out.data(), out.stride, width, height);
+    }});
+    cases.push_back({"bgra->bgr", 3, [=](const KernelTable& table, Image& out) {
+        table.convert[static_cast<int>(Conversion::BgraToBgr)](bgra->data(), bgra->stride, out.data(), out.stride, width, height);
+    }});
+    cases.push_back({"bgr->yuv", 3, [=](const KernelTable& table, Image& out) {
+        table.convert[static_cast<int>(Conversion::BgrToYuv)](bgr->data(), bgr->stride, out.data(), out.stride, width, height);
+    }});
+
+    return cases;
+}
+
+// Matching the scalar bgr->yuv says nothing about its coefficients; this
+// checks the colour matrix itself against the BT.601 full-range equations
+bool checkYuvReference(const KernelTable& table) {
+    const uint8_t colors[][3] = {{0, 0, 255}, {0, 255, 0}, {255, 0, 0}, {255, 255, 0},
+                                 {255, 0, 255}, {0, 255, 255}, {255, 255, 255}, {0, 0, 0}, {40, 90, 200}};
+    const int count = sizeof(colors) / sizeof(colors[0]);
+    uint8_t bgr[count * 3], yuv[count * 3];
+    std::memcpy(bgr, colors, sizeof(bgr));
+    table.convert[static_cast<int>(Conversion::BgrToYuv)](bgr, sizeof(bgr), yuv, sizeof(yuv), count, 1);
+
+    bool passed = true;
+    for (int i = 0; i < count; i++) {
+        double b = colors[i][0], g = colors[i][1], r = colors[i][2];
+        double y = 0.299 * r + 0.587 * g + 0.114 * b;
+        double expected[3] = {y, 128 + 0.564 * (b - y), 128 + 0.713 * (r - y)};
+        for (int c = 0; c < 3; c++) {
+            double want = std::min(255.0, std::max(0.0, expected[c]));
+            if (std::abs(yuv[i * 3 + c] - want) > 1.5) {
+                std::cout << "   ❌ bgr->yuv (" << table.isa << ") BGR " << int(b) << "," << int(g) << ","
+                          << int(r) << " channel " << c << ": " << int(yuv[i * 3 + c]) << ", expected "
+                          << std::fixed << std::setprecision(1) << want << std::endl;
+                passed = false;
+            }
+        }
+    }
+    return passed;
+}
+
+std::vector<const KernelTable*> availableTables() {
+    std::vector<const KernelTable*> tables = {scalarKernels()};
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.1") && sse41Kernels()) tables.push_back(sse41Kernels());
+    if (__builtin_cpu_supports("avx2") && avx2Kernels()) tables.push_back(avx2Kernels());
+#endif
+    return tables;
+}
+
+} // namespace
+
+bool runKernelBench() {
+    std::vector<const KernelTable*> tables = availableTables();
+    bool allPassed = true;
+
+    // Correctness: odd sizes exercise every vector tail, against the scalar reference
+    std::cout << "🧮 Checking pixel kernels against the scalar reference" << std::endl;
+    const int sizes[][2] = {{1, 1}, {5, 3}, {17, 2}, {31, 7}, {97, 5}, {333, 11}, {1921, 9}};
+    for (const auto& size : sizes) {
+        for (const auto& kernelCase : makeCases(size[0], size[1])) {
+            Image reference(size[0], size[1], kernelCase.outChannels, 9);
+            kernelCase.run(*tables[0], reference);
+
+            for (size_t t = 1; t < tables.size(); t++) {
+                Image out(size[0], size[1], kernelCase.outChannels, 9);
+                kernelCase.run(*tables[t], out);
+                if (!out.samePixels(reference) || !out.samePadding(reference)) {
+                    std::cout << "   ❌ " << kernelCase.name << " (" << tables[t]->isa << ") differs at "
+                              << size[0] << "x" << size[1] << std::endl;
+                    allPassed = false;
+                }
+            }
+        }
+    }
+    for (const auto* table : tables) {
+        allPassed &= checkYuvReference(*table);
+    }
+    std::cout << "   " << (allPassed ? "PASS" : "FAIL") << " (" << tables.size() << " variants)" << std::endl;
+
+    // Throughput at 1080p
+    const int width = 1920, height = 1080, iterations = 50;
+    std::cout << "🧮 Microbenchmark, " << width << "x" << height << ", ms per call (single thread)" << std::endl;
+    std::cout << "   " << std::left << std::setw(20) << "kernel";
+    for (const auto* table : tables) {
+        std::cout << std::right << std::setw(10) << table->isa;
+    }
+    std::cout << std::endl;
+
+    for (const auto& kernelCase : makeCases(width, height)) {
+        std::cout << "   " << std::left << std::setw(20) << kernelCase.name;
+        for (const auto* table : tables) {
+            Image out(width, height, kernelCase.outChannels, 9);
+            kernelCase.run(*table, out); // Warm caches and pages
+
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; i++) {
+                kernelCase.run(*table, out);
+            }
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+            std::cout << std::right << std::setw(10) << std::fixed << std::setprecision(3) << ms;
+        }
+        std::cout << std::endl;
+    }
+
+    const char* selected = kernels().isa;
+    std::cout << "   Selected at startup: " << selected << std::endl;
+    return allPassed;
+}
+
+} // namespace pixel
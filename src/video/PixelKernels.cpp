@@ -0,0 +1,143 @@
+#include "video/PixelKernels.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace pixel {
+
+namespace {
+
+bool cpuHas(const char* feature) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (std::strcmp(feature, "avx2") == 0) return __builtin_cpu_supports("avx2");
+    if (std::strcmp(feature, "sse4.1") == 0) return __builtin_cpu_supports("sse4.1");
+#endif
+    (void)feature;
+    return false;
+}
+
+const KernelTable& selectKernels() {
+    // The ISA variants may only be touched once the CPU is known to run them
+    const KernelTable* avx2 = cpuHas("avx2") ? avx2Kernels() : nullptr;
+    const KernelTable* sse41 = cpuHas("sse4.1") ? sse41Kernels() : nullptr;
+    const KernelTable* chosen = avx2 ? avx2 : (sse41 ? sse41 : scalarKernels());
+    
+    if (const char* forced = std::getenv("VJ_KERNEL_ISA")) {
+        std::string isa = forced;
+        if (isa == "scalar") chosen = scalarKernels();
+        else if (isa == "sse41" && sse41) chosen = sse41;
+        else if (isa == "avx2" && avx2) chosen = avx2;
+    }
+    
+    std::cout << "🧮 Pixel kernels: " << chosen->isa << std::endl;
+    return *chosen;
+}
+
+bool formatOf(const cv::Mat& mat, Format& format) {
+    if (mat.type() == CV_8UC3) {
+        format = Format::BGR;
+        return true;
+    }
+    if (mat.type() == CV_8UC4) {
+        format = Format::BGRA;
+        return true;
+    }
+    return false;
+}
+
+// Splits rows into stripes on OpenCV's pool once a frame is big enough to pay for it
+template <typename Body>
+void forRows(int rows, size_t bytesPerRow, const Body& body) {
+    const size_t kParallelBytes = 1u << 20;
+    if (rows < 64 || rows * bytesPerRow < kParallelBytes) {
+        body(0, rows);
+        return;
+    }
+    int stripes = std::min(rows / 32, std::max(1, cv::getNumThreads()) * 2);
+    cv::parallel_for_(cv::Range(0, stripes), [&](const cv::Range& range) {
+        for (int i = range.start; i < range.end; i++) {
+            body(rows * i / stripes, rows * (i + 1) / stripes);
+        }
+    });
+}
+
+} // namespace
+
+const KernelTable& kernels() {
+    static const KernelTable& table = selectKernels();
+    return table;
+}
+
+size_t scaleScratchBytes(int dstWidth, Format format) {
+    return static_cast<size_t>(dstWidth) * (3 * sizeof(int) + 2 * channels(format)) + 2 * kScaleRowSlack;
+}
+
+void blend(const cv::Mat& src, cv::Mat& dst, BlendOp op, float alpha) {
+    Format format;
+    if (src.size() != dst.size() || src.type() != dst.type() || !formatOf(dst, format)) return;
+    
+    int a = std::clamp(static_cast<int>(alpha * 256.0f + 0.5f), 0, 256);
+    BlendFn fn = kernels().blend[static_cast<int>(format)][static_cast<int>(op)];
+    forRows(dst.rows, dst.cols * dst.elemSize(), [&](int begin, int end) {
+        fn(src.ptr(begin), src.step, dst.ptr(begin), dst.step, dst.cols, end - begin, a);
+    });
+}
+
+void fade(cv::Mat& frame, float gain) {
+    Format format;
+    if (frame.empty() || !formatOf(frame, format)) return;
+    
+    int g = std::clamp(static_cast<int>(gain * 256.0f + 0.5f), 0, 256);
+    FadeFn fn = kernels().fade[static_cast<int>(format)];
+    forRows(frame.rows, frame.cols * frame.elemSize(), [&](int begin, int end) {
+        fn(frame.ptr(begin), frame.step, frame.cols, end - begin, g);
+    });
+}
+
+void clear(cv::Mat& frame, const cv::Scalar& color) {
+    Format format;
+    if (frame.empty() || !formatOf(frame, format)) return;
+    
+    uint8_t bytes[4];
+    for (int c = 0; c < 4; c++) {
+        bytes[c] = cv::saturate_cast<uchar>(color[c]);
+    }
+    ClearFn fn = kernels().clear[static_cast<int>(format)];
+    forRows(frame.rows, frame.cols * frame.elemSize(), [&](int begin, int end) {
+        fn(frame.ptr(begin), frame.step, frame.cols, end - begin, bytes);
+    });
+}
+
+void scaleInto(const cv::Mat& src, cv::Mat& dst, const cv::Rect& roi) {
+    Format format;
+    cv::Rect area = roi & cv::Rect(0, 0, dst.cols, dst.rows);
+    if (src.empty() || area.empty() || src.type() != dst.type() || !formatOf(dst, format)) return;
+    
+    cv::Mat target = dst(area);
+    ScaleFn fn = kernels().scale[static_cast<int>(format)];
+    size_t scratchBytes = scaleScratchBytes(area.width, format);
+    forRows(area.height, area.width * dst.elemSize(), [&](int begin, int end) {
+        thread_local std::vector<uint8_t> scratch;
+        if (scratch.size() < scratchBytes) scratch.resize(scratchBytes);
+        fn(src.data, src.step, src.cols, src.rows, target.data, target.step,
+           area.width, area.height, begin, end, scratch.data());
+    });
+}
+
+void convert(const cv::Mat& src, cv::Mat& dst, Conversion conversion) {
+    int from = (conversion == Conversion::BgraToBgr) ? CV_8UC4 : CV_8UC3;
+    int to = (conversion == Conversion::BgrToBgra) ? CV_8UC4 : CV_8UC3;
+    if (src.empty() || src.type() != from) return;
+    
+    dst.create(src.size(), to);
+    ConvertFn fn = kernels().convert[static_cast<int>(conversion)];
+    forRows(src.rows, src.cols * src.elemSize(), [&](int begin, int end) {
+        fn(src.ptr(begin), src.step, dst.ptr(begin), dst.step, src.cols, end - begin);
+    });
+}
+
+} // namespace pixel
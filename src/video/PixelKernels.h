@@ -0,0 +1,68 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+#include <cstdint>
+
+// Small library of 8-bit pixel kernels used by the compositor and effects.
+// Each kernel is a template specialised at compile time on pixel format
+// and blend op (PixelKernelsImpl.h), built once per instruction set
+// (scalar, SSE4.1, AVX2) and picked once at startup by CPU detection.
+// Every variant produces the same bytes as the scalar one; --bench-kernels
+// checks that and times them.
+namespace pixel {
+
+enum class Format { BGR, BGRA };
+enum class BlendOp { Alpha, Add, Multiply, Screen };
+enum class Conversion { BgrToBgra, BgraToBgr, BgrToYuv };
+
+constexpr int kFormats = 2;
+constexpr int kBlendOps = 4;
+
+constexpr int channels(Format format) { return format == Format::BGRA ? 4 : 3; }
+
+// Raw kernels work on strided rows of `width` pixels. alpha/gain are 0-256.
+typedef void (*BlendFn)(const uint8_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                        int width, int height, int alpha);
+typedef void (*FadeFn)(uint8_t* dst, size_t dstStride, int width, int height, int gain);
+typedef void (*ClearFn)(uint8_t* dst, size_t dstStride, int width, int height, const uint8_t* color);
+// Bilinear scale of the whole source into dst rows [rowBegin, rowEnd);
+// scratch must hold scaleScratchBytes(dstWidth, format)
+typedef void (*ScaleFn)(const uint8_t* src, size_t srcStride, int srcWidth, int srcHeight,
+                        uint8_t* dst, size_t dstStride, int dstWidth, int dstHeight,
+                        int rowBegin, int rowEnd, uint8_t* scratch);
+typedef void (*ConvertFn)(const uint8_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                          int width, int height);
+
+struct KernelTable {
+    const char* isa;
+    BlendFn blend[kFormats][kBlendOps];
+    FadeFn fade[kFormats];
+    ClearFn clear[kFormats];
+    ScaleFn scale[kFormats];
+    ConvertFn convert[3];
+};
+
+constexpr int kScaleRowSlack = 64;
+size_t scaleScratchBytes(int dstWidth, Format format);
+
+// Per-ISA tables; null when that variant isn't compiled in
+const KernelTable* scalarKernels();
+const KernelTable* sse41Kernels();
+const KernelTable* avx2Kernels();
+
+// Best table this CPU supports (VJ_KERNEL_ISA=scalar|sse41|avx2 overrides)
+const KernelTable& kernels();
+
+// cv::Mat front ends for CV_8UC3 / CV_8UC4; large frames are split into
+// row stripes across OpenCV's thread pool
+void blend(const cv::Mat& src, cv::Mat& dst, BlendOp op, float alpha); // dst = mix(dst, op(src, dst), alpha)
+void fade(cv::Mat& frame, float gain);
+void clear(cv::Mat& frame, const cv::Scalar& color = cv::Scalar::all(0));
+void scaleInto(const cv::Mat& src, cv::Mat& dst, const cv::Rect& roi); // dst must already be allocated
+void convert(const cv::Mat& src, cv::Mat& dst, Conversion conversion);
+
+// Checks every variant against the scalar reference and benchmarks it
+// (--bench-kernels). Returns false if any variant disagrees.
+bool runKernelBench();
+
+} // namespace pixel
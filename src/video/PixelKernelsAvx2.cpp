@@ -0,0 +1,17 @@
+// Built with -mavx2 (see CMakeLists.txt); only called when the CPU has it
+#if defined(__AVX2__)
+#define VJ_KERNEL_NAMESPACE avx2
+#define VJ_KERNEL_AVX2 1
+#include "video/PixelKernelsImpl.h"
+
+const pixel::KernelTable* pixel::avx2Kernels() {
+    static const KernelTable table = avx2::makeTable("avx2");
+    return &table;
+}
+#else
+#include "video/PixelKernels.h"
+
+const pixel::KernelTable* pixel::avx2Kernels() {
+    return nullptr;
+}
+#endif
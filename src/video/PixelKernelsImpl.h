@@ -0,0 +1,513 @@
+// Kernel templates, compiled once per instruction set. Each including file
+// defines VJ_KERNEL_NAMESPACE (and VJ_KERNEL_SSE41 or VJ_KERNEL_AVX2) and is
+// built with the matching compiler flags. Everything here lives in that
+// namespace, so no inline function compiled for one ISA can be merged into
+// another by the linker; for the same reason nothing here calls into std::.
+#include "video/PixelKernels.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#if defined(VJ_KERNEL_SSE41) || defined(VJ_KERNEL_AVX2)
+#include <immintrin.h>
+#endif
+
+namespace pixel {
+namespace VJ_KERNEL_NAMESPACE {
+
+// Scalar formulas; the vector paths below reproduce them exactly
+inline int lerpByte(int d, int r, int alpha) { return (r * alpha + d * (256 - alpha) + 128) >> 8; }
+inline int mul255(int a, int b) { int t = a * b + 128; return (t + (t >> 8)) >> 8; }
+inline int clampByte(int v) { return v < 0 ? 0 : (v > 255 ? 255 : v); }
+inline int minInt(int a, int b) { return a < b ? a : b; }
+
+template <BlendOp Op> inline int blendByte(int s, int d) {
+    switch (Op) {
+        case BlendOp::Alpha:    return s;
+        case BlendOp::Add:      return minInt(s + d, 255);
+        case BlendOp::Multiply: return mul255(s, d);
+        case BlendOp::Screen:   return 255 - mul255(255 - s, 255 - d);
+    }
+    return s;
+}
+
+#if defined(VJ_KERNEL_AVX2) || defined(VJ_KERNEL_SSE41)
+#define VJ_KERNEL_VECTOR 1
+
+// Byte-lane register operations. 8-bit lanes are widened to 16 bits for
+// arithmetic; unpack and pack work per 128-bit lane, so lane order survives.
+struct Vec {
+#if defined(VJ_KERNEL_AVX2)
+    typedef __m256i Reg;
+    static const int kBytes = 32;
+    static Reg load(const uint8_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(uint8_t* p, Reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static Reg zero() { return _mm256_setzero_si256(); }
+    static Reg set16(int v) { return _mm256_set1_epi16(static_cast<short>(v)); }
+    static Reg ones() { return _mm256_set1_epi8(static_cast<char>(0xFF)); }
+    static Reg lo16(Reg v) { return _mm256_unpacklo_epi8(v, zero()); }
+    static Reg hi16(Reg v) { return _mm256_unpackhi_epi8(v, zero()); }
+    static Reg pack(Reg lo, Reg hi) { return _mm256_packus_epi16(lo, hi); }
+    static Reg mul16(Reg a, Reg b) { return _mm256_mullo_epi16(a, b); }
+    static Reg add16(Reg a, Reg b) { return _mm256_add_epi16(a, b); }
+    static Reg shr8(Reg a) { return _mm256_srli_epi16(a, 8); }
+    static Reg addSat(Reg a, Reg b) { return _mm256_adds_epu8(a, b); }
+    static Reg invert(Reg a) { return _mm256_xor_si256(a, ones()); }
+    static Reg sub16(Reg a, Reg b) { return _mm256_sub_epi16(a, b); }
+    static Reg mulRound15(Reg a, Reg b) { return _mm256_mulhrs_epi16(a, b); }
+    static Reg bitOr(Reg a, Reg b) { return _mm256_or_si256(a, b); }
+    // Same 16-byte pattern in every 128-bit lane
+    static Reg shuffle(Reg v, const int8_t* mask) {
+        return _mm256_shuffle_epi8(v, _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(mask))));
+    }
+#else
+    typedef __m128i Reg;
+    static const int kBytes = 16;
+    static Reg load(const uint8_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(uint8_t* p, Reg v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static Reg zero() { return _mm_setzero_si128(); }
+    static Reg set16(int v) { return _mm_set1_epi16(static_cast<short>(v)); }
+    static Reg ones() { return _mm_set1_epi8(static_cast<char>(0xFF)); }
+    static Reg lo16(Reg v) { return _mm_unpacklo_epi8(v, zero()); }
+    static Reg hi16(Reg v) { return _mm_unpackhi_epi8(v, zero()); }
+    static Reg pack(Reg lo, Reg hi) { return _mm_packus_epi16(lo, hi); }
+    static Reg mul16(Reg a, Reg b) { return _mm_mullo_epi16(a, b); }
+    static Reg add16(Reg a, Reg b) { return _mm_add_epi16(a, b); }
+    static Reg shr8(Reg a) { return _mm_srli_epi16(a, 8); }
+    static Reg addSat(Reg a, Reg b) { return _mm_adds_epu8(a, b); }
+    static Reg invert(Reg a) { return _mm_xor_si128(a, ones()); }
+    static Reg sub16(Reg a, Reg b) { return _mm_sub_epi16(a, b); }
+    static Reg mulRound15(Reg a, Reg b) { return _mm_mulhrs_epi16(a, b); }
+    static Reg bitOr(Reg a, Reg b) { return _mm_or_si128(a, b); }
+    static Reg shuffle(Reg v, const int8_t* mask) {
+        return _mm_shuffle_epi8(v, _mm_load_si128(reinterpret_cast<const __m128i*>(mask)));
+    }
+#endif
+
+    // (r * alpha + d * (256 - alpha) + 128) >> 8; all terms fit in 16 bits
+    static Reg lerp(Reg d, Reg r, Reg alpha, Reg inverse, Reg round) {
+        Reg lo = shr8(add16(add16(mul16(lo16(r), alpha), mul16(lo16(d), inverse)), round));
+        Reg hi = shr8(add16(add16(mul16(hi16(r), alpha), mul16(hi16(d), inverse)), round));
+        return pack(lo, hi);
+    }
+
+    // Rounded a * b / 255
+    static Reg mul255(Reg a, Reg b, Reg round) {
+        Reg lo = add16(mul16(lo16(a), lo16(b)), round);
+        Reg hi = add16(mul16(hi16(a), hi16(b)), round);
+        return pack(shr8(add16(lo, shr8(lo))), shr8(add16(hi, shr8(hi))));
+    }
+
+    template <BlendOp Op> static Reg blend(Reg s, Reg d, Reg round) {
+        switch (Op) {
+            case BlendOp::Alpha:    return s;
+            case BlendOp::Add:      return addSat(s, d);
+            case BlendOp::Multiply: return mul255(s, d, round);
+            case BlendOp::Screen:   return invert(mul255(invert(s), invert(d), round));
+        }
+        return s;
+    }
+};
+#else
+#define VJ_KERNEL_VECTOR 0
+#endif
+
+template <Format F, BlendOp Op>
+void blendKernel(const uint8_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                 int width, int height, int alpha) {
+    const int bytes = width * channels(F);
+
+    for (int y = 0; y < height; y++) {
+        const uint8_t* s = src + y * srcStride;
+        uint8_t* d = dst + y * dstStride;
+        int x = 0;
+#if VJ_KERNEL_VECTOR
+        const Vec::Reg a = Vec::set16(alpha), inverse = Vec::set16(256 - alpha), round = Vec::set16(128);
+        for (; x + Vec::kBytes <= bytes; x += Vec::kBytes) {
+            Vec::Reg dv = Vec::load(d + x);
+            Vec::Reg rv = Vec::blend<Op>(Vec::load(s + x), dv, round);
+            Vec::store(d + x, Vec::lerp(dv, rv, a, inverse, round));
+        }
+#endif
+        for (; x < bytes; x++) {
+            d[x] = static_cast<uint8_t>(lerpByte(d[x], blendByte<Op>(s[x], d[x]), alpha));
+        }
+    }
+}
+
+template <Format F>
+void fadeKernel(uint8_t* dst, size_t dstStride, int width, int height, int gain) {
+    const int bytes = width * channels(F);
+
+    for (int y = 0; y < height; y++) {
+        uint8_t* d = dst + y * dstStride;
+        int x = 0;
+#if VJ_KERNEL_VECTOR
+        const Vec::Reg g = Vec::set16(gain), round = Vec::set16(128);
+        for (; x + Vec::kBytes <= bytes; x += Vec::kBytes) {
+            Vec::Reg v = Vec::load(d + x);
+            Vec::Reg lo = Vec::shr8(Vec::add16(Vec::mul16(Vec::lo16(v), g), round));
+            Vec::Reg hi = Vec::shr8(Vec::add16(Vec::mul16(Vec::hi16(v), g), round));
+            Vec::store(d + x, Vec::pack(lo, hi));
+        }
+#endif
+        for (; x < bytes; x++) {
+            d[x] = static_cast<uint8_t>((d[x] * gain + 128) >> 8);
+        }
+    }
+}
+
+template <Format F>
+void clearKernel(uint8_t* dst, size_t dstStride, int width, int height, const uint8_t* color) {
+    const int cn = channels(F);
+    const int bytes = width * cn;
+
+#if VJ_KERNEL_VECTOR
+    // Three registers hold a whole number of pixels in either format
+    alignas(32) uint8_t pattern[3 * Vec::kBytes];
+    for (int i = 0; i < 3 * Vec::kBytes; i++) {
+        pattern[i] = color[i % cn];
+    }
+    const Vec::Reg p0 = Vec::load(pattern);
+    const Vec::Reg p1 = Vec::load(pattern + Vec::kBytes);
+    const Vec::Reg p2 = Vec::load(pattern + 2 * Vec::kBytes);
+#endif
+
+    for (int y = 0; y < height; y++) {
+        uint8_t* d = dst + y * dstStride;
+        int x = 0;
+#if VJ_KERNEL_VECTOR
+        for (; x + 3 * Vec::kBytes <= bytes; x += 3 * Vec::kBytes) {
+            Vec::store(d + x, p0);
+            Vec::store(d + x + Vec::kBytes, p1);
+            Vec::store(d + x + 2 * Vec::kBytes, p2);
+        }
+#endif
+        for (; x < bytes; x++) {
+            d[x] = color[x % cn];
+        }
+    }
+}
+
+inline uint32_t load32(const uint8_t* p) { uint32_t v; memcpy(&v, p, 4); return v; }
+
+// Horizontal pass of the bilinear scale: one source row to dstWidth pixels.
+// The vector path fetches whole 4-byte words per pixel, which for BGR reads
+// one byte past the pixel; the caller disables it where that byte may not exist.
+template <Format F>
+void scaleRow(const uint8_t* src, uint8_t* out, int dstWidth, const int* firsts, const int* seconds,
+              const int* weights, bool vectorOk) {
+    const int cn = channels(F);
+    int x = 0;
+#if VJ_KERNEL_VECTOR
+    if (vectorOk) {
+#if defined(VJ_KERNEL_AVX2)
+        const int kPixels = 8;
+        const __m256i packBgr = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                                 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+        const __m256i closeGap = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+#else
+        const int kPixels = 4;
+        const __m128i packBgr = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+#endif
+        const Vec::Reg round = Vec::set16(128), full = Vec::set16(256);
+        for (; x + kPixels <= dstWidth; x += kPixels) {
+#if defined(VJ_KERNEL_AVX2)
+            const int* base = reinterpret_cast<const int*>(src);
+            Vec::Reg p = _mm256_i32gather_epi32(base, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(firsts + x)), 1);
+            Vec::Reg q = _mm256_i32gather_epi32(base, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(seconds + x)), 1);
+            Vec::Reg w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + x));
+            w = _mm256_or_si256(w, _mm256_slli_epi32(w, 16)); // Weight in both 16-bit halves
+            Vec::Reg wLo = _mm256_unpacklo_epi32(w, w), wHi = _mm256_unpackhi_epi32(w, w);
+            Vec::Reg lo = Vec::shr8(Vec::add16(Vec::add16(Vec::mul16(Vec::lo16(q), wLo),
+                                   Vec::mul16(Vec::lo16(p), _mm256_sub_epi16(full, wLo))), round));
+            Vec::Reg hi = Vec::shr8(Vec::add16(Vec::add16(Vec::mul16(Vec::hi16(q), wHi),
+                                   Vec::mul16(Vec::hi16(p), _mm256_sub_epi16(full, wHi))), round));
+            Vec::Reg r = Vec::pack(lo, hi);
+            if (F == Format::BGR) {
+                r = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(r, packBgr), closeGap);
+            }
+#else
+            Vec::Reg p = _mm_setr_epi32(load32(src + firsts[x]), load32(src + firsts[x + 1]),
+                                        load32(src + firsts[x + 2]), load32(src + firsts[x + 3]));
+            Vec::Reg q = _mm_setr_epi32(load32(src + seconds[x]), load32(src + seconds[x + 1]),
+                                        load32(src + seconds[x + 2]), load32(src + seconds[x + 3]));
+            Vec::Reg w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + x));
+            w = _mm_or_si128(w, _mm_slli_epi32(w, 16));
+            Vec::Reg wLo = _mm_unpacklo_epi32(w, w), wHi = _mm_unpackhi_epi32(w, w);
+            Vec::Reg lo = Vec::shr8(Vec::add16(Vec::add16(Vec::mul16(Vec::lo16(q), wLo),
+                                   Vec::mul16(Vec::lo16(p), _mm_sub_epi16(full, wLo))), round));
+            Vec::Reg hi = Vec::shr8(Vec::add16(Vec::add16(Vec::mul16(Vec::hi16(q), wHi),
+                                   Vec::mul16(Vec::hi16(p), _mm_sub_epi16(full, wHi))), round));
+            Vec::Reg r = Vec::pack(lo, hi);
+            if (F == Format::BGR) {
+                r = _mm_shuffle_epi8(r, packBgr);
+            }
+#endif
+            Vec::store(out + x * cn, r); // BGR spills into the row's slack; the tail overwrites it
+        }
+    }
+#else
+    (void)vectorOk;
+#endif
+    for (; x < dstWidth; x++) {
+        const uint8_t* p = src + firsts[x];
+        const uint8_t* q = src + seconds[x];
+        int w = weights[x];
+        for (int c = 0; c < cn; c++) {
+            out[x * cn + c] = static_cast<uint8_t>(lerpByte(p[c], q[c], w));
+        }
+    }
+}
+
+// Fixed-point source coordinate for a destination pixel centre
+inline void sourceSpan(int dst, int dstSize, int srcSize, int& first, int& second, int& weight) {
+    int64_t step = (static_cast<int64_t>(srcSize) << 16) / dstSize;
+    int64_t pos = dst * step + step / 2 - 32768;
+    if (pos < 0) pos = 0;
+    first = static_cast<int>(pos >> 16);
+    weight = static_cast<int>((pos & 0xFFFF) >> 8);
+    if (first >= srcSize - 1) {
+        first = srcSize - 1;
+        weight = 0;
+    }
+    second = first + 1 < srcSize ? first + 1 : first;
+}
+
+template <Format F>
+void scaleKernel(const uint8_t* src, size_t srcStride, int srcWidth, int srcHeight,
+                 uint8_t* dst, size_t dstStride, int dstWidth, int dstHeight,
+                 int rowBegin, int rowEnd, uint8_t* scratch) {
+    const int cn = channels(F);
+    const int rowBytes = dstWidth * cn;
+
+    // Scratch layout: first/second column offsets, weights, two scaled rows
+    // each followed by kScaleRowSlack bytes for vector spill
+    int* firsts = reinterpret_cast<int*>(scratch);
+    int* seconds = firsts + dstWidth;
+    int* weights = seconds + dstWidth;
+    uint8_t* rows[2] = { reinterpret_cast<uint8_t*>(weights + dstWidth), nullptr };
+    rows[1] = rows[0] + rowBytes + kScaleRowSlack;
+    int cached[2] = { -1, -1 };
+
+    for (int x = 0; x < dstWidth; x++) {
+        int first, second;
+        sourceSpan(x, dstWidth, srcWidth, first, second, weights[x]);
+        firsts[x] = first * cn;
+        seconds[x] = second * cn;
+    }
+
+    // BGR word fetches read a byte past the last pixel, which only the final source row may not have
+    auto vectorOk = [&](int row) { return F == Format::BGRA || row + 1 < srcHeight; };
+
+    for (int y = rowBegin; y < rowEnd; y++) {
+        int top, bottom, weight;
+        sourceSpan(y, dstHeight, srcHeight, top, bottom, weight);
+
+        // Consecutive output rows mostly share source rows; reuse them
+        if (cached[0] != top) {
+            if (cached[1] == top) {
+                uint8_t* swap = rows[0]; rows[0] = rows[1]; rows[1] = swap;
+                cached[0] = top;
+                cached[1] = -1;
+            } else {
+                scaleRow<F>(src + top * srcStride, rows[0], dstWidth, firsts, seconds, weights, vectorOk(top));
+                cached[0] = top;
+            }
+        }
+        if (cached[1] != bottom) {
+            scaleRow<F>(src + bottom * srcStride, rows[1], dstWidth, firsts, seconds, weights, vectorOk(bottom));
+            cached[1] = bottom;
+        }
+
+        uint8_t* d = dst + y * dstStride;
+        const uint8_t* r0 = rows[0];
+        const uint8_t* r1 = rows[1];
+        int x = 0;
+#if VJ_KERNEL_VECTOR
+        const Vec::Reg a = Vec::set16(weight), inverse = Vec::set16(256 - weight), round = Vec::set16(128);
+        for (; x + Vec::kBytes <= rowBytes; x += Vec::kBytes) {
+            Vec::store(d + x, Vec::lerp(Vec::load(r0 + x), Vec::load(r1 + x), a, inverse, round));
+        }
+#endif
+        for (; x < rowBytes; x++) {
+            d[x] = static_cast<uint8_t>(lerpByte(r0[x], r1[x], weight));
+        }
+    }
+}
+
+inline void bgrToBgraKernel(const uint8_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                            int width, int height) {
+    for (int y = 0; y < height; y++) {
+        const uint8_t* s = src + y * srcStride;
+        uint8_t* d = dst + y * dstStride;
+        int x = 0;
+#if defined(VJ_KERNEL_AVX2)
+        // Spread 24 source bytes so each 128-bit lane holds 4 pixels, then
+        // widen in-lane; loads read 8 bytes past the pixels they use
+        const __m256i spread = _mm256_setr_epi32(0, 1, 2, 3, 3, 4, 5, 6);
+        const __m256i shuffle = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                                                 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+        for (; (x + 8) * 3 + 8 <= width * 3; x += 8) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + x * 3));
+            v = _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(v, spread), shuffle);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + x * 4), _mm256_or_si256(v, alpha));
+        }
+#elif defined(VJ_KERNEL_SSE41)
+        const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+        for (; (x + 4) * 3 + 4 <= width * 3; x += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + x * 3));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + x * 4), _mm_or_si128(_mm_shuffle_epi8(v, shuffle), alpha));
+        }
+#endif
+        for (; x < width; x++) {
+            d[x * 4] = s[x * 3];
+            d[x * 4 + 1] = s[x * 3 + 1];
+            d[x * 4 + 2] = s[x * 3 + 2];
+            d[x * 4 + 3] = 255;
+        }
+    }
+}
+
+inline void bgraToBgrKernel(const uint8_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                            int width, int height) {
+    for (int y = 0; y < height; y++) {
+        const uint8_t* s = src + y * srcStride;
+        uint8_t* d = dst + y * dstStride;
+        int x = 0;
+#if defined(VJ_KERNEL_AVX2)
+        // Pack each lane to 12 bytes, then close the gap between lanes; the
+        // store spills 8 bytes that the next iteration overwrites
+        const __m256i shuffle = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                                 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+        const __m256i gather = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+        for (; x * 3 + 32 <= width * 3; x += 8) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + x * 4));
+            v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, shuffle), gather);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + x * 3), v);
+        }
+#elif defined(VJ_KERNEL_SSE41)
+        const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+        for (; x * 3 + 16 <= width * 3; x += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + x * 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + x * 3), _mm_shuffle_epi8(v, shuffle));
+        }
+#endif
+        for (; x < width; x++) {
+            d[x * 3] = s[x * 4];
+            d[x * 3 + 1] = s[x * 4 + 1];
+            d[x * 3 + 2] = s[x * 4 + 2];
+        }
+    }
+}
+
+#if VJ_KERNEL_VECTOR
+// bgr->yuv works on groups of 8 pixels (24 bytes), one group per 128-bit
+// lane, read as two overlapping 16-byte loads at bytes 0 and 8
+alignas(16) static const int8_t kYuvGather[6][16] = {
+    {0, -1, 3, -1, 6, -1, 9, -1, 12, -1, 15, -1, -1, -1, -1, -1},    // B, pixels 0-5 from the first load
+    {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 10, -1, 13, -1}, // B, pixels 6-7 from the second
+    {1, -1, 4, -1, 7, -1, 10, -1, 13, -1, -1, -1, -1, -1, -1, -1},    // G, 0-4
+    {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 8, -1, 11, -1, 14, -1},  // G, 5-7
+    {2, -1, 5, -1, 8, -1, 11, -1, 14, -1, -1, -1, -1, -1, -1, -1},    // R, 0-4
+    {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 9, -1, 12, -1, 15, -1},  // R, 5-7
+};
+// From Y|Cb (bytes 0-7|8-15) and Cr (0-7) back to Y Cb Cr triples: bytes
+// 0-15 of the group, then 16-23
+alignas(16) static const int8_t kYuvScatter[4][16] = {
+    {0, 8, -1, 1, 9, -1, 2, 10, -1, 3, 11, -1, 4, 12, -1, 5},
+    {-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1},
+    {13, -1, 6, 14, -1, 7, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, -1, -1, -1, -1, -1, -1},
+};
+#endif
+
+// BT.601 full-range YCbCr 4:4:4 in 8.8 fixed point: Cb = 0.564 (B - Y),
+// Cr = 0.713 (R - Y), offset by 128. The vector path widens to 16 bits;
+// its rounded multiply-high, (d * 144 * 128 + 2^14) >> 15, equals the
+// scalar (d * 144 + 128) >> 8, so both produce the same bytes.
+inline void bgrToYuvKernel(const uint8_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                           int width, int height) {
+    for (int y = 0; y < height; y++) {
+        const uint8_t* s = src + y * srcStride;
+        uint8_t* d = dst + y * dstStride;
+        int x = 0;
+#if VJ_KERNEL_VECTOR
+        const int groups = Vec::kBytes / 16;
+        const Vec::Reg kB = Vec::set16(29), kG = Vec::set16(150), kR = Vec::set16(77);
+        const Vec::Reg kCb = Vec::set16(144 * 128), kCr = Vec::set16(183 * 128);
+        const Vec::Reg round = Vec::set16(128), offset = Vec::set16(128);
+        for (; x + 8 * groups <= width; x += 8 * groups) {
+            const uint8_t* p = s + x * 3;
+#if defined(VJ_KERNEL_AVX2)
+            auto loadGroups = [](const uint8_t* q) {
+                __m256i v = _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(q)));
+                return _mm256_inserti128_si256(v, _mm_loadu_si128(reinterpret_cast<const __m128i*>(q + 24)), 1);
+            };
+            Vec::Reg first = loadGroups(p), second = loadGroups(p + 8);
+#else
+            Vec::Reg first = Vec::load(p), second = Vec::load(p + 8);
+#endif
+            Vec::Reg b = Vec::bitOr(Vec::shuffle(first, kYuvGather[0]), Vec::shuffle(second, kYuvGather[1]));
+            Vec::Reg g = Vec::bitOr(Vec::shuffle(first, kYuvGather[2]), Vec::shuffle(second, kYuvGather[3]));
+            Vec::Reg r = Vec::bitOr(Vec::shuffle(first, kYuvGather[4]), Vec::shuffle(second, kYuvGather[5]));
+
+            // Luma sums reach 65408: wraps as signed, exact as unsigned
+            Vec::Reg luma = Vec::shr8(Vec::add16(Vec::add16(Vec::add16(Vec::mul16(b, kB), Vec::mul16(g, kG)),
+                                                            Vec::mul16(r, kR)), round));
+            Vec::Reg cb = Vec::add16(Vec::mulRound15(Vec::sub16(b, luma), kCb), offset);
+            Vec::Reg cr = Vec::add16(Vec::mulRound15(Vec::sub16(r, luma), kCr), offset);
+
+            Vec::Reg lumaCb = Vec::pack(luma, cb); // Saturation clamps Cb and Cr
+            Vec::Reg crCr = Vec::pack(cr, cr);
+            Vec::Reg head = Vec::bitOr(Vec::shuffle(lumaCb, kYuvScatter[0]), Vec::shuffle(crCr, kYuvScatter[1]));
+            Vec::Reg tail = Vec::bitOr(Vec::shuffle(lumaCb, kYuvScatter[2]), Vec::shuffle(crCr, kYuvScatter[3]));
+            uint8_t* q = d + x * 3;
+#if defined(VJ_KERNEL_AVX2)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(q), _mm256_castsi256_si128(head));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(q + 16), _mm256_castsi256_si128(tail));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(q + 24), _mm256_extracti128_si256(head, 1));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(q + 40), _mm256_extracti128_si256(tail, 1));
+#else
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(q), head);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(q + 16), tail);
+#endif
+        }
+#endif
+        for (; x < width; x++) {
+            int b = s[x * 3], g = s[x * 3 + 1], r = s[x * 3 + 2];
+            int luma = (29 * b + 150 * g + 77 * r + 128) >> 8;
+            d[x * 3] = static_cast<uint8_t>(luma);
+            d[x * 3 + 1] = static_cast<uint8_t>(clampByte(((b - luma) * 144 + 32896) >> 8));
+            d[x * 3 + 2] = static_cast<uint8_t>(clampByte(((r - luma) * 183 + 32896) >> 8));
+        }
+    }
+}
+
+template <Format F> void fillFormat(KernelTable& table) {
+    const int f = static_cast<int>(F);
+    table.blend[f][static_cast<int>(BlendOp::Alpha)] = blendKernel<F, BlendOp::Alpha>;
+    table.blend[f][static_cast<int>(BlendOp::Add)] = blendKernel<F, BlendOp::Add>;
+    table.blend[f][static_cast<int>(BlendOp::Multiply)] = blendKernel<F, BlendOp::Multiply>;
+    table.blend[f][static_cast<int>(BlendOp::Screen)] = blendKernel<F, BlendOp::Screen>;
+    table.fade[f] = fadeKernel<F>;
+    table.clear[f] = clearKernel<F>;
+    table.scale[f] = scaleKernel<F>;
+}
+
+inline KernelTable makeTable(const char* isa) {
+    KernelTable table;
+    table.isa = isa;
+    fillFormat<Format::BGR>(table);
+    fillFormat<Format::BGRA>(table);
+    table.convert[static_cast<int>(Conversion::BgrToBgra)] = bgrToBgraKernel;
+    table.convert[static_cast<int>(Conversion::BgraToBgr)] = bgraToBgrKernel;
+    table.convert[static_cast<int>(Conversion::BgrToYuv)] = bgrToYuvKernel;
+    return table;
+}
+
+} // namespace VJ_KERNEL_NAMESPACE
+} // namespace pixel
+
+#undef VJ_KERNEL_VECTOR
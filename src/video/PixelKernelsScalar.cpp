@@ -0,0 +1,8 @@
+// Portable reference variant; every other variant must match it byte for byte
+#define VJ_KERNEL_NAMESPACE scalar
+#include "video/PixelKernelsImpl.h"
+
+const pixel::KernelTable* pixel::scalarKernels() {
+    static const KernelTable table = scalar::makeTable("scalar");
+    return &table;
+}
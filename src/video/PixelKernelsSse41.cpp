@@ -0,0 +1,17 @@
+// Built with -msse4.1 (see CMakeLists.txt); only called when the CPU has it
+#if defined(__SSE4_1__)
+#define VJ_KERNEL_NAMESPACE sse41
+#define VJ_KERNEL_SSE41 1
+#include "video/PixelKernelsImpl.h"
+
+const pixel::KernelTable* pixel::sse41Kernels() {
+    static const KernelTable table = sse41::makeTable("sse4.1");
+    return &table;
+}
+#else
+#include "video/PixelKernels.h"
+
+const pixel::KernelTable* pixel::sse41Kernels() {
+    return nullptr;
+}
+#endif
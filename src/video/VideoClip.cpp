@@ -1,5 +1,33 @@
 #include "video/VideoClip.h"
+#include <algorithm>
 
 VideoClip::VideoClip(const std::string& path, int startNote, int stopNote) 
-    : videoPath(path), startNote(startNote), stopNote(stopNote), playing(false) {
-}
\ No newline at end of file
+    : videoPath(path), startNote(startNote), stopNote(stopNote), playing(false), frameRate(0.0) {
+}
+
+bool VideoClip::isOnOutput(int outputIndex) const {
+    return outputs.empty() || std::find(outputs.begin(), outputs.end(), outputIndex) != outputs.end();
+}
+
+bool VideoClip::sharesOutputWith(const VideoClip& other) const {
+    if (outputs.empty() || other.outputs.empty()) return true;
+    
+    for (int output : outputs) {
+        if (other.isOnOutput(output)) return true;
+    }
+    return false;
+}
+void VideoClip::addCue(int note, double seconds) {
+    CuePoint cue;
+    cue.note = note;
+    cue.seconds = seconds;
+    cue.frame = 0;
+    cues.push_back(cue);
+}
+
+int VideoClip::findCue(int note) const {
+    for (size_t i = 0; i < cues.size(); i++) {
+        if (cues[i].note == note) return static_cast<int>(i);
+    }
+    return -1;
+}
@@ -1,5 +1,67 @@
 #pragma once
+#include <opencv2/opencv.hpp>
 #include <string>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <cmath>
+#include <memory>
+#include "video/EffectParams.h"
+
+class KeyframeIndex;
+
+// Decoder counters for one clip, updated lock-free by its playback thread
+struct ClipStats {
+    std::atomic<uint64_t> framesDecoded{0};
+    std::atomic<uint64_t> lateFrames{0};  // Frames decoded after their display deadline
+    std::atomic<uint32_t> decodeUs{0};    // Time of the last capture read
+    std::atomic<int32_t> lagUs{0};        // How far behind schedule the last frame was
+    std::atomic<uint32_t> seekUs{0};      // Wait for the last random-access frame
+    std::atomic<uint64_t> seekMisses{0};  // Random-access frames not ready in time
+    std::atomic<uint64_t> seekCacheHits{0};   // Random-access frames found already decoded
+    std::atomic<uint64_t> seekCacheMisses{0}; // ...and ones whose block had to be decoded
+    std::atomic<uint64_t> decoderStalls{0}; // Decoders the watchdog replaced
+    std::atomic<uint32_t> recoveryUs{0};  // Stall detected to replacement playing, last time
+    std::atomic<uint64_t> ioBytes{0};     // Read ahead of the decoder (or pinned) by ClipReadahead
+    std::atomic<uint64_t> ioWaitUs{0};    // Time those reads spent waiting on the drive
+    std::atomic<uint64_t> readaheadMisses{0}; // Times the decoder got past the readahead
+    std::atomic<int32_t> avOffsetUs{0};   // Audio minus video at the last audio buffer
+    std::atomic<uint64_t> audioUnderruns{0}; // Audio buffers the decoder could not fill
+};
+
+// Transport controls, set by the render thread from MIDI mappings and read
+// by the clip's playback thread
+struct PlaybackControl {
+    static constexpr uint64_t kScratchHoldNs = 300000000; // Scratch releases after 300 ms idle
+    static constexpr float kSpeedDetent = 0.04f; // About one CC step on a -4..4 knob
+    
+    std::atomic<float> speed{1.0f};      // -4..+4, 1 = native forward
+    std::atomic<float> scratch{0.0f};    // Position 0..1 while scratching
+    std::atomic<uint64_t> scratchNs{0};  // Last scratch update
+    
+    // A knob cannot land exactly on 1 or 0, so values near them snap there:
+    // 1x keeps the sequential decode path (and audio), 0 is a real stop
+    void setSpeed(float value) {
+        if (std::abs(value - 1.0f) < kSpeedDetent) value = 1.0f;
+        if (std::abs(value) < kSpeedDetent) value = 0.0f;
+        speed.store(value, std::memory_order_relaxed);
+    }
+    
+    bool isScratching(uint64_t nowNs) const {
+        uint64_t last = scratchNs.load(std::memory_order_relaxed);
+        return last && nowNs - last < kScratchHoldNs;
+    }
+};
+
+// An extra start note that launches the clip part-way in. The first frames
+// at the cue are decoded at load and stay resident, so a launch shows them
+// at once while the decoder opens and seeks behind them.
+struct CuePoint {
+    int note;
+    double seconds;
+    int frame;                     // Set when the cue is pre-rolled
+    std::vector<cv::Mat> preroll;
+};
 
 class VideoClip {
 public:
@@ -9,12 +71,46 @@ public:
     int getStartNote() const { return startNote; }
     int getStopNote() const { return stopNote; }
     
+    // Outputs this clip is shown on; empty = every output
+    const std::vector<int>& getOutputs() const { return outputs; }
+    void setOutputs(const std::vector<int>& outputList) { outputs = outputList; }
+    bool isOnOutput(int outputIndex) const;
+    bool sharesOutputWith(const VideoClip& other) const;
+    
+    // Cue points; the list is fixed once clips are loaded
+    const std::vector<CuePoint>& getCues() const { return cues; }
+    std::vector<CuePoint>& getCues() { return cues; }
+    void addCue(int note, double seconds);
+    int findCue(int note) const; // Index into getCues(), or -1
+    
+    ClipStats& getStats() const { return stats; }
+    PlaybackControl& getPlayback() const { return playback; }
+    
+    // Keyframe index built at load; null if the file could not be indexed
+    std::shared_ptr<const KeyframeIndex> getKeyframeIndex() const { return keyframeIndex; }
+    void setKeyframeIndex(std::shared_ptr<const KeyframeIndex> index) { keyframeIndex = std::move(index); }
+    
+    // Playback rate for image sequences (videos carry their own), 0 = default
+    double getFrameRate() const { return frameRate; }
+    void setFrameRate(double fps) { frameRate = fps; }
+    
     bool isPlaying() const { return playing; }
     void setPlaying(bool state) { playing = state; }
     
+    // Layer effect parameters (owned by the render thread)
+    EffectParams& getEffects() { return effects; }
+    const EffectParams& getEffects() const { return effects; }
+    
 private:
     std::string videoPath;
     int startNote;
     int stopNote;
-    bool playing;
+    std::atomic<bool> playing;
+    std::vector<int> outputs;
+    std::vector<CuePoint> cues;
+    mutable ClipStats stats;
+    mutable PlaybackControl playback;
+    std::shared_ptr<const KeyframeIndex> keyframeIndex;
+    double frameRate;
+    EffectParams effects;
 };
\ No newline at end of file
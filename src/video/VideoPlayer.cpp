@@ -1,17 +1,49 @@
 #include "video/VideoPlayer.h"
 #include "video/VideoClip.h"
+#include "video/ClipDecoder.h"
+#include "video/ImageSequence.h"
+#include "video/KeyframeIndex.h"
+#include "core/PerfCounters.h"
+#include "utils/Clock.h"
+#include "utils/Trace.h"
+#include "utils/Log.h"
+#include "utils/Realtime.h"
+#include "utils/FrameArena.h"
+#include "video/PixelKernels.h"
+#include "audio/AudioOutput.h"
 #include <iostream>
 #include <filesystem>
+#include <algorithm>
+#include <cmath>
 
-PlayingVideo::PlayingVideo(const std::string& path) 
-    : clipPath(path), shouldStop(false) {
+PlayingVideo::PlayingVideo(const std::string& path, bool openNow, double sequenceFps) 
+    : shouldStop(false), clipPath(path), startSequence(0), stats(nullptr), control(nullptr), audioOutput(nullptr),
+      frameRate(sequenceFps), cue(nullptr), triggerNs(0), firstFrameShown(false), heartbeatNs(0), heartbeatFrame(-1),
+      frameIntervalNs(0), failed(false), loopExited(false), startFrame(0), recoveries(0) {
+    PerfCounters::instance().liveDecoders.fetch_add(1, std::memory_order_relaxed);
     
-    if (!capture.open(path)) {
+    if (openNow && !open()) {
+        PerfCounters::instance().liveDecoders.fetch_sub(1, std::memory_order_relaxed);
         throw std::runtime_error("Cannot open video file: " + path);
     }
+}
+
+bool PlayingVideo::open() {
+    if (ImageSequence::isImageSource(clipPath)) {
+        try {
+            sequence = std::make_unique<ImageSequence>(clipPath, frameRate);
+        } catch (const std::exception& e) {
+            VJ_LOG_ERROR("❌ {}", e.what());
+            return false;
+        }
+        return true;
+    }
+    
+    if (!capture.open(clipPath)) return false;
     
     // Set some properties for better performance
     capture.set(cv::CAP_PROP_BUFFERSIZE, 1);
+    return true;
 }
 
 PlayingVideo::~PlayingVideo() {
@@ -19,11 +51,33 @@ PlayingVideo::~PlayingVideo() {
     if (playbackThread.joinable()) {
         playbackThread.join();
     }
+    if (audio) {
+        if (audioOutput) audioOutput->remove(audio.get());
+        audio.reset();
+    }
+    seekDecoder.reset();
+    sequence.reset();
     capture.release();
+    readahead.reset();
+    PerfCounters::instance().liveDecoders.fetch_sub(1, std::memory_order_relaxed);
+}
+
+FrameTimeline::Selection PlayingVideo::selectFrame(uint64_t outputNs, FrameRateMode mode) {
+    std::lock_guard<std::mutex> lock(frameMutex);
+    return timeline.select(outputNs, mode); // Shares the buffers, no pixel copy
 }
 
-VideoPlayer::VideoPlayer() 
-    : windowWidth(1920), windowHeight(1080), windowName("VJ Output") {
+void PlayingVideo::publishFrame(const cv::Mat& frame, uint64_t ptsNs) {
+    uint64_t pts = ptsNs ? ptsNs : monotonicNs();
+    std::lock_guard<std::mutex> lock(frameMutex);
+    timeline.push(frame, pts);
+}
+
+VideoPlayer::VideoPlayer()
+    : nextStartSequence(0), reaperStop(false), watchdogStop(false), stallBudgetMs(400),
+      frameRateMode(FrameRateMode::Nearest), audioOutput(nullptr) {
+    reaperThread = std::thread(&VideoPlayer::reaperLoop, this);
+    watchdogThread = std::thread(&VideoPlayer::watchdogLoop, this);
 }
 
 VideoPlayer::~VideoPlayer() {
@@ -31,166 +85,808 @@ VideoPlayer::~VideoPlayer() {
 }
 
 bool VideoPlayer::initialize() {
+    return initialize(std::vector<cv::Size>{cv::Size(1920, 1080)});
+}
+
+bool VideoPlayer::initialize(const std::vector<cv::Size>& outputSizes) {
     std::cout << "Initializing video player..." << std::endl;
     
-    // Create the output window
-    cv::namedWindow(windowName, cv::WINDOW_NORMAL);
-    cv::resizeWindow(windowName, windowWidth, windowHeight);
-    
-    // Try to move window to second display (rough approach)
-    cv::moveWindow(windowName, 1920, 0); // Assumes primary display is 1920px wide
-    
-    // Create black composite frame
-    compositeFrame = cv::Mat::zeros(windowHeight, windowWidth, CV_8UC3);
+    outputs.clear();
+    outputs.resize(outputSizes.size());
+    for (size_t i = 0; i < outputSizes.size(); i++) {
+        auto& output = outputs[i];
+        output.index = static_cast<int>(i);
+        output.size = outputSizes[i];
+        output.lastLayerClip = nullptr;
+        output.firstFrameTriggerNs = 0;
+        output.firstFrameIsCue = false;
+        
+        // Slab space at this resolution for the composite, effect buffers
+        // and the display copy, mapped before the show starts
+        FrameArena::instance().reserve(output.size, CV_8UC3, 4);
+        
+        // Create black composite frame
+        output.frame = cv::Mat::zeros(output.size.height, output.size.width, CV_8UC3);
+    }
     
-    std::cout << "Video player initialized" << std::endl;
+    std::cout << "Video player initialized (" << outputs.size() << " outputs)" << std::endl;
     return true;
 }
 
 void VideoPlayer::shutdown() {
     std::cout << "Shutting down video player..." << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(watchdogMutex);
+        watchdogStop = true; // First, so nothing is swapped in behind stopAllClips
+    }
+    watchdogCondition.notify_one();
+    if (watchdogThread.joinable()) {
+        watchdogThread.join();
+    }
+    
     stopAllClips();
-    cv::destroyWindow(windowName);
+    
+    {
+        std::lock_guard<std::mutex> lock(reaperMutex);
+        reaperStop = true;
+    }
+    reaperCondition.notify_one();
+    if (reaperThread.joinable()) {
+        reaperThread.join();
+    }
+    
+    // A decoder still blocked in a read cannot be joined; leave it to the OS.
+    // If the read ever returns, playbackLoop exits touching only its own
+    // (leaked) PlayingVideo.
+    for (auto& video : stalledVideos) {
+        if (!video->loopExited && video->playbackThread.joinable()) {
+            VJ_LOG_WARN("⚠ Abandoning blocked decoder: {}", video->clipPath);
+            video->playbackThread.detach();
+            video.release();
+        }
+    }
+    stalledVideos.clear();
 }
 
-bool VideoPlayer::startClip(VideoClip* clip) {
-    if (!clip) return false;
+void VideoPlayer::attachAudio(PlayingVideo& video) {
+    if (!audioOutput || !audioOutput->isOpen() || ImageSequence::isImageSource(video.clipPath)) return;
+    video.audio = std::make_unique<ClipAudio>(video.clipPath, audioOutput->getSampleRate(), video.stats);
+    video.audioOutput = audioOutput;
+}
+
+void VideoPlayer::retire(std::unique_ptr<PlayingVideo> video) {
+    video->shouldStop = true;
+    if (video->audio) {
+        video->audio->mute(); // Silent now, not when the reaper gets to it
+    }
+    {
+        std::lock_guard<std::mutex> lock(reaperMutex);
+        if (!reaperStop) {
+            retiredVideos.push_back(std::move(video));
+        }
+    }
+    reaperCondition.notify_one();
     
-    std::lock_guard<std::mutex> lock(videosMutex);
+    video.reset(); // Reaper already gone (shutting down): join here
+}
+
+void VideoPlayer::reaperLoop() {
+    VJ_TRACE_THREAD_NAME("reaper");
+    std::unique_lock<std::mutex> lock(reaperMutex);
     
-    // Check if already playing
-    if (playingVideos.find(clip) != playingVideos.end()) {
-        std::cout << "Clip already playing: " << clip->getPath() << std::endl;
-        return true;
+    while (true) {
+        reaperCondition.wait(lock, [this] { return reaperStop || !retiredVideos.empty(); });
+        
+        std::vector<std::unique_ptr<PlayingVideo>> batch;
+        batch.swap(retiredVideos);
+        
+        lock.unlock();
+        batch.clear(); // Joins the playback threads and releases the decoders
+        lock.lock();
+        
+        if (reaperStop && retiredVideos.empty()) break;
+    }
+}
+
+bool VideoPlayer::startClip(VideoClip* clip, uint64_t triggerNs, int cueIndex) {
+    if (!clip) return false;
+    VJ_TRACE_SCOPE("startClip");
+    
+    {
+        std::lock_guard<std::mutex> lock(videosMutex);
+        
+        // Check if already playing
+        if (playingVideos.find(clip) != playingVideos.end()) {
+            VJ_LOG_INFO("Clip already playing: {}", clip->getPath());
+            return true;
+        }
     }
     
     try {
         // Check if file exists
         if (!std::filesystem::exists(clip->getPath())) {
-            std::cerr << "Video file not found: " << clip->getPath() << std::endl;
+            VJ_LOG_ERROR("Video file not found: {}", clip->getPath());
             return false;
         }
         
-        auto video = std::make_unique<PlayingVideo>(clip->getPath());
+        const CuePoint* cue = nullptr;
+        if (cueIndex >= 0 && cueIndex < static_cast<int>(clip->getCues().size()) &&
+            !clip->getCues()[cueIndex].preroll.empty()) {
+            cue = &clip->getCues()[cueIndex];
+        }
         
-        // Start playback thread
-        video->playbackThread = std::thread(&VideoPlayer::playbackLoop, this, video.get());
+        // Opening the decoder is the slow part; keep it outside videosMutex
+        // so rendering carries on while it happens. A cue launch defers it to
+        // the playback thread and shows the resident cue frame right away.
+        // So does an image sequence, whose open lists the directory and
+        // decodes a whole image: too long for the MIDI thread.
+        bool openNow = cue == nullptr && !ImageSequence::isImageSource(clip->getPath());
+        auto video = std::make_unique<PlayingVideo>(clip->getPath(), openNow, clip->getFrameRate());
+        video->cue = cue;
+        if (cue) {
+            video->publishFrame(cue->preroll.front());
+        }
+        video->stats = &clip->getStats();
+        video->control = &clip->getPlayback();
+        video->keyframeIndex = clip->getKeyframeIndex();
+        video->triggerNs = triggerNs ? triggerNs : monotonicNs();
+        attachAudio(*video);
         
-        playingVideos[clip] = std::move(video);
+        {
+            std::lock_guard<std::mutex> lock(videosMutex);
+            if (playingVideos.find(clip) != playingVideos.end()) {
+                return true; // Another input source started it meanwhile
+            }
+            
+            video->startSequence = nextStartSequence++;
+            
+            // Start playback thread
+            PlayingVideo* playing = video.get();
+            video->playbackThread = std::thread([this, playing]() {
+                playbackLoop(playing);
+                playing->loopExited = true;
+            });
+            
+            playingVideos[clip] = std::move(video);
+            PerfCounters::instance().activeVideos.store(static_cast<int>(playingVideos.size()), std::memory_order_relaxed);
+        }
         
-        std::cout << "Started playing: " << clip->getPath() << std::endl;
+        VJ_LOG_INFO("Started playing: {}", clip->getPath());
         return true;
         
     } catch (const std::exception& e) {
-        std::cerr << "Error starting clip: " << e.what() << std::endl;
+        VJ_LOG_ERROR("Error starting clip: {}", e.what());
         return false;
     }
 }
 
 void VideoPlayer::stopClip(VideoClip* clip) {
     if (!clip) return;
+    VJ_TRACE_SCOPE("stopClip");
     
-    std::lock_guard<std::mutex> lock(videosMutex);
-    
-    auto it = playingVideos.find(clip);
-    if (it != playingVideos.end()) {
-        std::cout << "Stopping clip: " << clip->getPath() << std::endl;
-        it->second->shouldStop = true;
+    std::unique_ptr<PlayingVideo> stopped;
+    {
+        std::lock_guard<std::mutex> lock(videosMutex);
+        
+        auto it = playingVideos.find(clip);
+        if (it == playingVideos.end()) return;
+        
+        VJ_LOG_INFO("Stopping clip: {}", clip->getPath());
+        stopped = std::move(it->second);
         playingVideos.erase(it);
+        PerfCounters::instance().activeVideos.store(static_cast<int>(playingVideos.size()), std::memory_order_relaxed);
     }
+    
+    retire(std::move(stopped));
 }
 
 void VideoPlayer::stopAllClips() {
-    std::lock_guard<std::mutex> lock(videosMutex);
-    
-    std::cout << "Stopping all clips (" << playingVideos.size() << ")" << std::endl;
-    
-    for (auto& pair : playingVideos) {
-        pair.second->shouldStop = true;
+    std::map<VideoClip*, std::unique_ptr<PlayingVideo>> stopped;
+    {
+        std::lock_guard<std::mutex> lock(videosMutex);
+        
+        VJ_LOG_INFO("Stopping all clips ({})", playingVideos.size());
+        
+        stopped.swap(playingVideos);
+        PerfCounters::instance().activeVideos.store(0, std::memory_order_relaxed);
     }
     
-    playingVideos.clear();
-}
-
-void VideoPlayer::render() {
-    createCompositeFrame();
-
-    if (!compositeFrame.empty()) {
-        cv::imshow("VJ Preview", compositeFrame);  // Separate preview window for debugging
+    for (auto& pair : stopped) {
+        retire(std::move(pair.second));
     }
 }
 
 void VideoPlayer::playbackLoop(PlayingVideo* video) {
     if (!video) return;
+    VJ_TRACE_THREAD_NAME("decode " + std::filesystem::path(video->clipPath).filename().string());
+    Realtime::applyToCurrentThread(ThreadRole::Decode);
     
-    cv::Mat frame;
-    double fps = video->capture.get(cv::CAP_PROP_FPS);
+    double fps = 0;
+    if (video->sequence) {
+        fps = video->sequence->getFps();
+    } else if (video->capture.isOpened()) {
+        fps = video->capture.get(cv::CAP_PROP_FPS);
+    } else if (video->keyframeIndex) {
+        fps = video->keyframeIndex->getFps(); // Cue launch: capture not open yet
+    } else if (ImageSequence::isImageSource(video->clipPath)) {
+        fps = video->frameRate > 0 ? video->frameRate : ImageSequence::kDefaultFps;
+    }
     if (fps <= 0) fps = 30;
     
-    int frameDelay = static_cast<int>(1000.0 / fps);
+    auto frameInterval = std::chrono::nanoseconds(static_cast<int64_t>(1e9 / fps));
+    video->frameIntervalNs.store(frameInterval.count(), std::memory_order_relaxed);
+    
+    // With frame-rate conversion, frames are stamped with the time they are
+    // due and decoded that far ahead, so the compositor can place them on
+    // its own clock. The first frame of a launch still shows immediately.
+    const FrameRateMode mode = frameRateMode;
+    const auto lead = frameInterval * FrameTimeline::presentationLead(mode);
+    auto presentationNs = [&](std::chrono::steady_clock::time_point due) -> uint64_t {
+        if (mode == FrameRateMode::Latest) return 0;
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            (due + lead).time_since_epoch()).count());
+    };
     
     // Only show essential startup info
-    std::cout << "🎬 Playing: " << video->clipPath << " (" << fps << " FPS)" << std::endl;
+    VJ_LOG_INFO("🎬 Playing: {} ({} FPS)", video->clipPath, fps);
+    
+    // Start reading the file ahead before the first capture read needs it;
+    // a cue launch starts at the cue
+    int fileFrames = video->keyframeIndex ? video->keyframeIndex->getFrameCount() : 0;
+    if (!video->sequence && !ImageSequence::isImageSource(video->clipPath)) {
+        video->readahead = ClipReadahead::instance().open(video->clipPath, video->stats);
+    }
+    if (video->readahead && fileFrames > 0) {
+        int first = video->cue ? video->cue->frame : video->startFrame;
+        video->readahead->position.store(static_cast<double>(first) / fileFrames, std::memory_order_relaxed);
+    }
+    
+    // Audio starts where the picture does, and follows the media time of
+    // each frame as it is published. Forward wraps are counted so that time
+    // runs on through loops.
+    const double loopSeconds = fileFrames > 0 ? fileFrames / fps : 0.0;
+    int loops = 0;
+    if (video->audio) {
+        int first = video->cue ? video->cue->frame : video->startFrame;
+        video->audio->start(first / fps, loopSeconds);
+        video->audioOutput->add(video->audio.get());
+    }
+    auto postAudioClock = [&](int frame, uint64_t ptsNs, bool running) {
+        if (!video->audio) return;
+        video->audio->setVideoClock(loops * loopSeconds + frame / fps, ptsNs ? ptsNs : monotonicNs(), running);
+    };
+    
+    // Small ring of decode buffers: a buffer is reused only once no output
+    // or the timeline still holds a reference to it, so published frames are
+    // never overwritten
+    std::vector<cv::Mat> buffers(FrameTimeline::kCapacity + 2);
+    size_t nextBuffer = 0;
+    
+    // Playhead. Forward play at 1x reads straight from the capture; reverse,
+    // varispeed and scratch go through the GOP-caching seek decoder.
+    int frameCount = video->keyframeIndex ? video->keyframeIndex->getFrameCount() : 0;
+    double position = 0;
+    int nextSequentialFrame = 0;
+    int shownFrame = -1;
+    bool sequential = true;
+    auto seekWait = std::chrono::duration_cast<std::chrono::microseconds>(frameInterval / 2).count();
+    
+    // Frames are paced against absolute deadlines so decode time doesn't
+    // accumulate into drift, and lateness is measurable
+    auto deadline = std::chrono::steady_clock::now();
+    
+    if (video->cue) {
+        // Play out the resident cue frames while the capture opens and seeks
+        // to the frame after them on a helper thread
+        const CuePoint* cue = video->cue;
+        int resumeFrame = cue->frame + static_cast<int>(cue->preroll.size());
+        bool opened = false;
+        postAudioClock(cue->frame, 0, true);
+        std::thread catchUp([video, resumeFrame, &opened]() {
+            VJ_TRACE_SCOPE("cue catch-up");
+            opened = video->open();
+            if (opened && !video->sequence && resumeFrame > 0) {
+                video->capture.set(cv::CAP_PROP_POS_FRAMES, resumeFrame);
+            }
+        });
+        
+        for (size_t i = 1; i < cue->preroll.size() && !video->shouldStop; i++) {
+            deadline += frameInterval;
+            std::this_thread::sleep_until(deadline);
+            video->publishFrame(cue->preroll[i], presentationNs(deadline));
+            postAudioClock(cue->frame + static_cast<int>(i), presentationNs(deadline), true);
+        }
+        catchUp.join();
+        if (video->shouldStop) return; // As after a capture read, below
+        
+        if (!opened) {
+            VJ_LOG_ERROR("❌ Cannot open: {}", video->clipPath);
+            return;
+        }
+        nextSequentialFrame = resumeFrame;
+        shownFrame = resumeFrame - 1;
+        position = shownFrame;
+        deadline += frameInterval;
+    }
     
-    if (!video->capture.isOpened()) {
-        std::cerr << "❌ Cannot open: " << video->clipPath << std::endl;
+    if (!video->isOpen() && (video->cue || !video->open())) {
+        VJ_LOG_ERROR("❌ Cannot open: {}", video->clipPath);
         return;
     }
+    if (video->sequence) {
+        frameCount = video->sequence->getFrameCount(); // Every frame is random access
+    }
+    if (fileFrames <= 0 && video->capture.isOpened()) {
+        fileFrames = static_cast<int>(video->capture.get(cv::CAP_PROP_FRAME_COUNT));
+    }
+    if (video->capture.isOpened()) {
+        // Decoded frames at the clip's size come from the arena too
+        cv::Size clipSize(static_cast<int>(video->capture.get(cv::CAP_PROP_FRAME_WIDTH)),
+                          static_cast<int>(video->capture.get(cv::CAP_PROP_FRAME_HEIGHT)));
+        if (!clipSize.empty()) {
+            FrameArena::instance().reserve(clipSize, CV_8UC3, static_cast<int>(buffers.size()));
+        }
+    }
+    if (video->startFrame > 0) {
+        // Replacing a stalled decoder: the watchdog has already seeked the capture
+        nextSequentialFrame = video->startFrame;
+        shownFrame = video->startFrame - 1;
+        position = shownFrame;
+    }
     
     while (!video->shouldStop) {
-        if (!video->capture.read(frame)) {
-            // Loop back to start silently
-            video->capture.set(cv::CAP_PROP_POS_FRAMES, 0);
-            if (!video->capture.read(frame)) {
-                std::cerr << "❌ Playback error: " << video->clipPath << std::endl;
-                break;
+        float speed = video->control ? video->control->speed.load(std::memory_order_relaxed) : 1.0f;
+        bool scratching = video->control && video->control->isScratching(monotonicNs());
+        bool linear = !video->sequence && (frameCount <= 0 || (!scratching && speed == 1.0f));
+        bool published = false;
+        bool waited = false; // A seek read timed out: no progress this pass
+        
+        auto readStart = std::chrono::steady_clock::now();
+        if (linear) {
+            if (!sequential) {
+                // Rejoin the fast path where the playhead left off
+                nextSequentialFrame = frameCount > 0 ? (shownFrame + 1) % frameCount : 0;
+                video->capture.set(cv::CAP_PROP_POS_FRAMES, nextSequentialFrame);
+                sequential = true;
+            }
+            
+            cv::Mat* frame = &buffers[nextBuffer];
+            if (frame->u && frame->u->refcount > 1) {
+                *frame = cv::Mat(); // Still on screen somewhere; let the readers keep it
+            }
+            nextBuffer = (nextBuffer + 1) % buffers.size();
+            
+            {
+                VJ_TRACE_SCOPE("capture read");
+                if (!video->capture.read(*frame) && !video->shouldStop) {
+                    // Loop back to start silently
+                    video->capture.set(cv::CAP_PROP_POS_FRAMES, 0);
+                    nextSequentialFrame = 0;
+                    loops++;
+                    if (!video->capture.read(*frame) && !video->shouldStop) {
+                        VJ_LOG_ERROR("❌ Playback error: {}", video->clipPath);
+                        video->failed = true; // The watchdog swaps in a fresh decoder
+                        break;
+                    }
+                }
+            }
+            
+            // A decoder abandoned as stalled can come back from its read
+            // after shutdown, when the clip, its stats and the logger are
+            // gone: leave without touching anything outside `video`
+            if (video->shouldStop) return;
+            
+            if (!frame->empty()) {
+                // Publish at native resolution; each output scales it exactly once
+                video->publishFrame(*frame, presentationNs(deadline));
+                published = true;
+                shownFrame = nextSequentialFrame++;
+                position = shownFrame;
+                postAudioClock(shownFrame, presentationNs(deadline), true);
+            }
+        } else {
+            sequential = false;
+            postAudioClock(std::max(shownFrame, 0), 0, false); // Silent off the 1x forward path
+            
+            if (!video->sequence && !video->seekDecoder) {
+                try {
+                    video->seekDecoder = std::make_unique<ClipDecoder>(video->clipPath, video->keyframeIndex);
+                } catch (const std::exception& e) {
+                    VJ_LOG_ERROR("❌ Random access unavailable: {}", e.what());
+                    frameCount = 0; // Forward play only from here on
+                    continue;
+                }
+            }
+            
+            if (scratching) {
+                position = video->control->scratch.load(std::memory_order_relaxed) * (frameCount - 1);
+            } else if (shownFrame >= 0) { // Nothing shown yet: start on the current position
+                position = std::fmod(position + speed, static_cast<double>(frameCount));
+                if (position < 0) position += frameCount;
+            }
+            
+            int target = std::min(static_cast<int>(position), frameCount - 1);
+            if (target != shownFrame) {
+                VJ_TRACE_SCOPE("seek read");
+                cv::Mat frame;
+                uint64_t cacheMisses = video->seekDecoder ? video->seekDecoder->getCacheMisses() : 0;
+                bool ready = video->sequence ? video->sequence->getFrame(target, frame, seekWait)
+                                             : video->seekDecoder->getFrame(target, frame, seekWait);
+                if (video->seekDecoder && video->stats) {
+                    bool hit = video->seekDecoder->getCacheMisses() == cacheMisses;
+                    (hit ? video->stats->seekCacheHits : video->stats->seekCacheMisses).fetch_add(1, std::memory_order_relaxed);
+                }
+                if (ready) {
+                    video->publishFrame(frame, scratching ? 0 : presentationNs(deadline)); // Scratch: now
+                    published = true;
+                    shownFrame = target;
+                } else {
+                    waited = true;
+                    if (video->stats) video->stats->seekMisses.fetch_add(1, std::memory_order_relaxed);
+                }
+                if (video->stats) {
+                    video->stats->seekUs.store(static_cast<uint32_t>(
+                        std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - readStart).count()),
+                        std::memory_order_relaxed);
+                }
             }
+            
+            // Keep the next block in the direction of travel decoded ahead
+            if (video->sequence) {
+                if (!scratching && speed != 0.0f) {
+                    int step = std::max(1, static_cast<int>(std::ceil(std::fabs(speed))));
+                    video->sequence->prefetch(target, speed < 0 ? -step : step);
+                }
+            } else if (!scratching && speed != 0.0f) {
+                int step = static_cast<int>(std::ceil(std::fabs(speed))) * ClipDecoder::kBlockFrames;
+                video->seekDecoder->prefetch(target + (speed < 0 ? -step : step));
+            }
+        }
+        auto readEnd = std::chrono::steady_clock::now();
+        // Only a shown frame, or a playhead held still on purpose, counts as
+        // alive: a seek or sequence worker stuck in a read times out every
+        // pass and must let the heartbeat run out
+        if (!waited) {
+            video->heartbeatFrame.store(shownFrame, std::memory_order_relaxed);
+            video->heartbeatNs.store(monotonicNs(), std::memory_order_release);
+        }
+        if (video->readahead && fileFrames > 0 && shownFrame >= 0) {
+            video->readahead->position.store(static_cast<double>(shownFrame) / fileFrames, std::memory_order_relaxed);
         }
         
-        if (frame.empty()) continue;
+        auto lag = std::chrono::duration_cast<std::chrono::microseconds>(readEnd - deadline).count();
+        if (video->stats && published) {
+            video->stats->framesDecoded.fetch_add(1, std::memory_order_relaxed);
+            video->stats->decodeUs.store(static_cast<uint32_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(readEnd - readStart).count()),
+                std::memory_order_relaxed);
+            video->stats->lagUs.store(static_cast<int32_t>(std::max<int64_t>(lag, 0)), std::memory_order_relaxed);
+            if (readEnd > deadline + frameInterval) {
+                video->stats->lateFrames.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
         
-        try {
-            cv::resize(frame, video->currentFrame, cv::Size(windowWidth, windowHeight));
-        } catch (const cv::Exception& e) {
-            std::cerr << "❌ Frame resize error: " << e.what() << std::endl;
-            continue;
+        deadline += frameInterval;
+        if (readEnd > deadline + 4 * frameInterval) {
+            deadline = readEnd; // Hopelessly behind (e.g. after a stall): resync instead of racing
+        }
+        std::this_thread::sleep_until(deadline);
+    }
+    
+    VJ_LOG_INFO("⏹️  Stopped: {}", video->clipPath);
+}
+
+void VideoPlayer::watchdogLoop() {
+    VJ_TRACE_THREAD_NAME("watchdog");
+    std::unique_lock<std::mutex> lock(watchdogMutex);
+    
+    while (true) {
+        watchdogCondition.wait_for(lock, std::chrono::milliseconds(50), [this] { return watchdogStop; });
+        if (watchdogStop) break;
+        lock.unlock();
+        
+        // Replaced decoders whose read has finally returned can be joined now
+        for (auto it = stalledVideos.begin(); it != stalledVideos.end();) {
+            if ((*it)->loopExited) {
+                retire(std::move(*it));
+                it = stalledVideos.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        
+        std::vector<std::pair<VideoClip*, PlayingVideo*>> stalled;
+        uint64_t now = monotonicNs();
+        if (stallBudgetMs > 0) {
+            std::lock_guard<std::mutex> videosLock(videosMutex);
+            for (auto& pair : playingVideos) {
+                PlayingVideo* video = pair.second.get();
+                uint64_t beat = video->heartbeatNs.load(std::memory_order_acquire);
+                if (!beat || video->recoveries >= kMaxRecoveries) continue; // Not running yet, or given up
+                
+                uint64_t budgetNs = std::max<uint64_t>(stallBudgetMs * 1000000ULL,
+                                                       4 * video->frameIntervalNs.load(std::memory_order_relaxed));
+                if (video->failed || now > beat + budgetNs) {
+                    stalled.emplace_back(pair.first, video);
+                }
+            }
+        }
+        for (auto& pair : stalled) {
+            replaceStalled(pair.first, pair.second, now);
+        }
+        
+        lock.lock();
+    }
+}
+
+void VideoPlayer::replaceStalled(VideoClip* clip, PlayingVideo* stalled, uint64_t detectedNs) {
+    VJ_TRACE_SCOPE("replace decoder");
+    
+    // Copy what the replacement needs while the stalled video is known to be alive
+    uint64_t beat;
+    int lastFrame;
+    int64_t intervalNs;
+    int recoveries;
+    bool readFailed;
+    {
+        std::lock_guard<std::mutex> lock(videosMutex);
+        auto it = playingVideos.find(clip);
+        if (it == playingVideos.end() || it->second.get() != stalled) return; // Stopped meanwhile
+        beat = stalled->heartbeatNs.load(std::memory_order_acquire);
+        lastFrame = stalled->heartbeatFrame.load(std::memory_order_relaxed);
+        intervalNs = std::max<int64_t>(1, stalled->frameIntervalNs.load(std::memory_order_relaxed));
+        recoveries = ++stalled->recoveries;
+        readFailed = stalled->failed;
+    }
+    VJ_LOG_WARN("⚠ Decoder stalled: {} ({}, {} ms without a frame)", clip->getPath(),
+                readFailed ? "read failed" : "read blocked", (detectedNs - beat) / 1000000);
+    
+    // Open and seek here, off the render and MIDI threads; the stalled clip
+    // keeps showing its last frame meanwhile
+    std::unique_ptr<PlayingVideo> replacement;
+    try {
+        replacement = std::make_unique<PlayingVideo>(clip->getPath(), true, clip->getFrameRate());
+    } catch (const std::exception& e) {
+        // The source itself is gone; keep the last frame up until a retrigger
+        VJ_LOG_ERROR("❌ Cannot replace stalled decoder: {}", e.what());
+        std::lock_guard<std::mutex> lock(videosMutex);
+        auto it = playingVideos.find(clip);
+        if (it != playingVideos.end() && it->second.get() == stalled) {
+            stalled->recoveries = kMaxRecoveries;
         }
+        return;
+    }
+    
+    int frameCount = 0;
+    if (replacement->sequence) {
+        frameCount = replacement->sequence->getFrameCount();
+    } else if (clip->getKeyframeIndex()) {
+        frameCount = clip->getKeyframeIndex()->getFrameCount();
+    } else {
+        frameCount = static_cast<int>(replacement->capture.get(cv::CAP_PROP_FRAME_COUNT));
+    }
+    
+    // Where the clip would be now had it not stalled
+    float speed = clip->getPlayback().speed.load(std::memory_order_relaxed);
+    double elapsedFrames = static_cast<double>(monotonicNs() - beat) / intervalNs;
+    double expected = std::max(lastFrame, 0) + elapsedFrames * speed;
+    if (frameCount > 0) {
+        expected = std::fmod(expected, static_cast<double>(frameCount));
+        if (expected < 0) expected += frameCount;
+    }
+    replacement->startFrame = std::max(0, static_cast<int>(expected));
+    if (!replacement->sequence && replacement->startFrame > 0) {
+        replacement->capture.set(cv::CAP_PROP_POS_FRAMES, replacement->startFrame);
+    }
+    
+    replacement->stats = &clip->getStats();
+    replacement->control = &clip->getPlayback();
+    replacement->keyframeIndex = clip->getKeyframeIndex();
+    replacement->recoveries = recoveries;
+    attachAudio(*replacement);
+    
+    std::unique_ptr<PlayingVideo> old;
+    {
+        std::lock_guard<std::mutex> lock(videosMutex);
+        auto it = playingVideos.find(clip);
+        if (it == playingVideos.end() || it->second.get() != stalled) return; // Stopped while opening
         
-        std::this_thread::sleep_for(std::chrono::milliseconds(frameDelay));
+        // Carry the frame on screen over so the swap shows no black frame
+        // and is not counted as a new launch
+        cv::Mat lastShown = stalled->selectFrame(monotonicNs(), FrameRateMode::Latest).frame;
+        if (!lastShown.empty()) {
+            replacement->publishFrame(lastShown);
+        }
+        replacement->triggerNs = stalled->triggerNs;
+        replacement->firstFrameShown = stalled->firstFrameShown.load();
+        replacement->startSequence = stalled->startSequence;
+        
+        PlayingVideo* playing = replacement.get();
+        replacement->playbackThread = std::thread([this, playing]() {
+            playbackLoop(playing);
+            playing->loopExited = true;
+        });
+        old = std::move(it->second);
+        it->second = std::move(replacement);
+    }
+    
+    old->shouldStop = true;
+    if (old->audio) {
+        old->audio->mute(); // The replacement brings its own
+    }
+    if (old->loopExited) {
+        retire(std::move(old));
+    } else {
+        stalledVideos.push_back(std::move(old)); // Joined once its read returns
+    }
+    
+    uint64_t recoveryNs = monotonicNs() - detectedNs;
+    clip->getStats().decoderStalls.fetch_add(1, std::memory_order_relaxed);
+    clip->getStats().recoveryUs.store(static_cast<uint32_t>(recoveryNs / 1000), std::memory_order_relaxed);
+    VJ_LOG_INFO("🔁 Decoder replaced: {} at frame {} ({} ms after detection, replacement {} of {})", clip->getPath(),
+                static_cast<int>(expected), recoveryNs / 1000000, recoveries, kMaxRecoveries);
+}
+
+void VideoPlayer::renderOutputs(uint64_t outputNs) {
+    if (!outputNs) outputNs = monotonicNs();
+    if (outputs.size() == 1) {
+        renderOutput(outputs[0], outputNs);
+        return;
     }
     
-    std::cout << "⏹️  Stopped: " << video->clipPath << std::endl;
+    cv::parallel_for_(cv::Range(0, static_cast<int>(outputs.size())), [this, outputNs](const cv::Range& range) {
+        for (int i = range.start; i < range.end; i++) {
+            renderOutput(outputs[i], outputNs);
+        }
+    });
+}
+
+void VideoPlayer::scaleToOutput(const cv::Mat& frame, cv::Mat& target, const cv::Size& size) {
+    if (frame.size() == size) {
+        frame.copyTo(target);
+    } else if (frame.type() == CV_8UC3) {
+        target.create(size, CV_8UC3);
+        pixel::scaleInto(frame, target, cv::Rect(0, 0, size.width, size.height));
+    } else {
+        cv::resize(frame, target, size);
+    }
 }
 
-void VideoPlayer::createCompositeFrame() {
-    std::lock_guard<std::mutex> lock(videosMutex);
+void VideoPlayer::renderOutput(OutputSurface& output, uint64_t outputNs) {
+    VJ_TRACE_SCOPE("composite");
+    VideoClip* layerClip = nullptr;
+    cv::Mat layerFrame;
+    cv::Mat nextFrame;
+    float blendWeight = 0.0f;
     
-    // Start with black frame
-    compositeFrame = cv::Mat::zeros(windowHeight, windowWidth, CV_8UC3);
+    {
+        std::lock_guard<std::mutex> lock(videosMutex);
+        
+        // Show the most recently started video assigned to this output
+        PlayingVideo* topVideo = nullptr;
+        for (auto& pair : playingVideos) {
+            if (!pair.first->isOnOutput(output.index)) continue;
+            if (!topVideo || pair.second->startSequence > topVideo->startSequence) {
+                topVideo = pair.second.get();
+                layerClip = pair.first;
+            }
+        }
+        
+        if (topVideo) {
+            FrameTimeline::Selection selection = topVideo->selectFrame(outputNs, frameRateMode);
+            layerFrame = selection.frame;
+            nextFrame = selection.next;
+            blendWeight = selection.weight;
+            if (!layerFrame.empty() && !topVideo->firstFrameShown.exchange(true)) {
+                output.firstFrameTriggerNs = topVideo->triggerNs;
+                output.firstFrameIsCue = topVideo->cue != nullptr;
+            }
+        }
+    }
     
-    if (playingVideos.empty()) {
+    if (layerFrame.empty()) {
+        // Start with black frame
+        pixel::clear(output.frame);
+        output.lastLayerClip = nullptr;
+        output.firstFrameTriggerNs = 0;
+        output.masterChain.apply(output.frame, masterEffects);
         return;
     }
     
-    // Show the last playing video
-    auto& lastVideo = playingVideos.rbegin()->second;
-    if (!lastVideo->currentFrame.empty()) {
-        try {
-            lastVideo->currentFrame.copyTo(compositeFrame);
-        } catch (const cv::Exception& e) {
-            std::cerr << "❌ Frame copy error: " << e.what() << std::endl;
+    // The single scale (or copy) from decode resolution to this output
+    try {
+        VJ_TRACE_SCOPE("resize");
+        scaleToOutput(layerFrame, output.frame, output.size);
+        
+        // Frame-rate blend: mix in the following frame by its share of this tick
+        if (!nextFrame.empty() && blendWeight >= 1.0f / 256.0f) {
+            VJ_TRACE_SCOPE("frame blend");
+            if (nextFrame.size() == output.size && nextFrame.type() == output.frame.type()) {
+                pixel::blend(nextFrame, output.frame, pixel::BlendOp::Alpha, blendWeight);
+            } else {
+                scaleToOutput(nextFrame, output.blendFrame, output.size);
+                pixel::blend(output.blendFrame, output.frame, pixel::BlendOp::Alpha, blendWeight);
+            }
         }
+    } catch (const cv::Exception& e) {
+        VJ_LOG_ERROR("❌ Frame resize error: {}", e.what());
+        return;
+    }
+    
+    // Effects run outside videosMutex so MIDI triggers never wait on them
+    VJ_TRACE_SCOPE("effects");
+    EffectChain& chain = output.layerChains[layerClip];
+    if (layerClip != output.lastLayerClip) {
+        chain.reset(); // Don't carry old trails into a fresh launch
+    }
+    chain.apply(output.frame, layerClip->getEffects());
+    output.lastLayerClip = layerClip;
+    
+    output.masterChain.apply(output.frame, masterEffects);
+}
+
+uint64_t VideoPlayer::takeFirstFrameTrigger(int outputIndex, bool* wasCue) {
+    if (outputIndex < 0 || outputIndex >= static_cast<int>(outputs.size())) return 0;
+    
+    uint64_t triggerNs = outputs[outputIndex].firstFrameTriggerNs;
+    outputs[outputIndex].firstFrameTriggerNs = 0;
+    if (wasCue) {
+        *wasCue = outputs[outputIndex].firstFrameIsCue;
     }
+    return triggerNs;
 }
 
-void VideoPlayer::getCompositeFrame(cv::Mat& frame) {
-    createCompositeFrame();
+void VideoPlayer::prerollCues(VideoClip& clip) {
+    if (clip.getCues().empty()) return;
     
-    std::lock_guard<std::mutex> lock(videosMutex);
+    if (ImageSequence::isImageSource(clip.getPath())) {
+        std::vector<std::string> files = ImageSequence::listFrames(clip.getPath());
+        double fps = clip.getFrameRate() > 0 ? clip.getFrameRate() : ImageSequence::kDefaultFps;
+        
+        for (auto& cue : clip.getCues()) {
+            cue.frame = static_cast<int>(cue.seconds * fps + 0.5);
+            cue.preroll.clear();
+            for (int i = 0; i < kCuePrerollFrames && cue.frame + i < static_cast<int>(files.size()); i++) {
+                cv::Mat frame;
+                if (!ImageSequence::decodeFile(files[cue.frame + i], frame)) break;
+                cue.preroll.push_back(frame);
+            }
+            std::cout << "  🎯 Cue note " << cue.note << " @ " << cue.seconds << "s (frame " << cue.frame
+                      << "): " << cue.preroll.size() << " frames resident" << std::endl;
+        }
+        return;
+    }
     
-    if (compositeFrame.empty()) {
-        frame = cv::Mat::zeros(windowHeight, windowWidth, CV_8UC3);
-    } else {
-        compositeFrame.copyTo(frame);
+    cv::VideoCapture capture(clip.getPath());
+    if (!capture.isOpened()) {
+        std::cerr << "  ❌ Cannot pre-roll cues for: " << clip.getPath() << std::endl;
+        return;
     }
-}
\ No newline at end of file
+    
+    double fps = capture.get(cv::CAP_PROP_FPS);
+    if (fps <= 0) fps = 30;
+    
+    for (auto& cue : clip.getCues()) {
+        cue.frame = static_cast<int>(cue.seconds * fps + 0.5);
+        cue.preroll.clear();
+        capture.set(cv::CAP_PROP_POS_FRAMES, cue.frame);
+        
+        for (int i = 0; i < kCuePrerollFrames; i++) {
+            cv::Mat frame;
+            if (!capture.read(frame) || frame.empty()) break;
+            cue.preroll.push_back(frame);
+        }
+        
+        std::cout << "  🎯 Cue note " << cue.note << " @ " << cue.seconds << "s (frame " << cue.frame
+                  << "): " << cue.preroll.size() << " frames resident" << std::endl;
+    }
+}
+
+void VideoPlayer::getCompositeFrame(cv::Mat& frame, int outputIndex) {
+    if (outputIndex < 0 || outputIndex >= static_cast<int>(outputs.size())) {
+        frame = cv::Mat::zeros(1080, 1920, CV_8UC3);
+        return;
+    }
+    frame = outputs[outputIndex].frame;
+}
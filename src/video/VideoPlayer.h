@@ -3,21 +3,84 @@
 #include <memory>
 #include <string>
 #include <map>
+#include <vector>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <atomic>
+#include "video/EffectChain.h"
+#include "video/FrameTimeline.h"
+#include "video/ClipReadahead.h"
+#include "audio/ClipAudio.h"
 
 class VideoClip;
+class KeyframeIndex;
+class AudioOutput;
+class ClipDecoder;
+class ImageSequence;
+struct ClipStats;
+struct PlaybackControl;
+struct CuePoint;
 
 struct PlayingVideo {
     cv::VideoCapture capture;
-    cv::Mat currentFrame;
     std::thread playbackThread;
     std::atomic<bool> shouldStop;
     std::string clipPath;
+    uint64_t startSequence; // Higher = started later, drawn on top
+    ClipStats* stats;
+    PlaybackControl* control;
     
-    PlayingVideo(const std::string& path);
+    // Random access for reverse/varispeed/scratch, opened on first use
+    std::shared_ptr<const KeyframeIndex> keyframeIndex;
+    std::unique_ptr<ClipDecoder> seekDecoder;
+    
+    // Keeps the file ahead of the capture in the page cache while playing
+    std::shared_ptr<ClipReadahead::Stream> readahead;
+    
+    // The clip's audio track, when audio output is on; started by the
+    // playback loop, which keeps it posted on the video's position
+    std::unique_ptr<ClipAudio> audio;
+    AudioOutput* audioOutput;
+    
+    // Image-sequence and still clips replace the capture with this source
+    std::unique_ptr<ImageSequence> sequence;
+    double frameRate; // For sequences, 0 = default
+    
+    // Set for cue launches: playback starts on the cue's resident frames and
+    // the capture is opened by the playback thread behind them
+    const CuePoint* cue;
+    
+    // Note-to-photon tracking: when the trigger arrived, and whether any
+    // output has shown a frame of this launch yet
+    uint64_t triggerNs;
+    std::atomic<bool> firstFrameShown;
+    
+    // Watchdog heartbeat: once it is running, the playback loop stamps each
+    // pass that shows a frame or holds still. A replacement decoder starts
+    // at startFrame.
+    std::atomic<uint64_t> heartbeatNs;
+    std::atomic<int> heartbeatFrame;   // Frame on show at the last heartbeat
+    std::atomic<int64_t> frameIntervalNs;
+    std::atomic<bool> failed;          // Reads stopped working; the loop has given up
+    std::atomic<bool> loopExited;
+    int startFrame;
+    int recoveries;                    // Replacements so far in this launch
+    
+    // Recently decoded frames at native resolution with presentation times.
+    // Outputs take references under frameMutex, so every output showing
+    // this clip shares one decode.
+    std::mutex frameMutex;
+    FrameTimeline timeline;
+    
+    PlayingVideo(const std::string& path, bool openNow = true, double sequenceFps = 0.0);
     ~PlayingVideo();
+    
+    bool open();
+    bool isOpen() const { return sequence || capture.isOpened(); }
+    
+    FrameTimeline::Selection selectFrame(uint64_t outputNs, FrameRateMode mode);
+    void publishFrame(const cv::Mat& frame, uint64_t ptsNs = 0); // 0 = due now
 };
 
 class VideoPlayer {
@@ -25,26 +88,97 @@ public:
     VideoPlayer();
     ~VideoPlayer();
     
-    bool initialize();
+    bool initialize(); // Single 1920x1080 output
+    bool initialize(const std::vector<cv::Size>& outputSizes);
     void shutdown();
     
-    bool startClip(VideoClip* clip);
+    // cueIndex >= 0 launches at one of the clip's cue points
+    bool startClip(VideoClip* clip, uint64_t triggerNs = 0, int cueIndex = -1);
     void stopClip(VideoClip* clip);
     void stopAllClips();
     
-    void render(); // Called from main loop to display current frame
-
-    // Add this method to the public section of VideoPlayer class
-    void getCompositeFrame(cv::Mat& frame);
+    // Composites every output for the output tick at outputNs (0 = now);
+    // outputs render in parallel on OpenCV's thread pool
+    void renderOutputs(uint64_t outputNs = 0);
+    
+    // How clip frames are mapped onto the output rate (set before playback)
+    void setFrameRateMode(FrameRateMode mode) { frameRateMode = mode; }
+    
+    // A decoder that goes this long without completing a read is replaced
+    // by a fresh one at the position it should have reached (0 = off)
+    void setStallBudget(uint32_t ms) { stallBudgetMs = ms; }
+    static constexpr int kMaxRecoveries = 5;
+    
+    // Clips with an audio track play it through this output (null = silent)
+    void setAudioOutput(AudioOutput* output) { audioOutput = output; }
+    
+    // Returns the last rendered frame for an output (no copy)
+    void getCompositeFrame(cv::Mat& frame, int outputIndex = 0);
+    int getOutputCount() const { return static_cast<int>(outputs.size()); }
+    
+    // Trigger time of a clip whose first frame was rendered into this output
+    // by the last renderOutputs(), or 0. Cleared by the call.
+    uint64_t takeFirstFrameTrigger(int outputIndex, bool* wasCue = nullptr);
+    
+    // Decodes each cue's first frames so cue launches need no seek (load time)
+    static void prerollCues(VideoClip& clip);
+    static constexpr int kCuePrerollFrames = 6;
+    
+    // Master effect parameters applied to the whole composite (render thread only)
+    EffectParams& getMasterEffects() { return masterEffects; }
     
 private:
+    // Per-output render target and effect state. Effect state lives with
+    // the render side, so none of it needs videosMutex.
+    struct OutputSurface {
+        int index;
+        cv::Size size;
+        cv::Mat frame;
+        cv::Mat blendFrame; // Second frame of a frame-rate blend, at output size
+        std::map<VideoClip*, EffectChain> layerChains;
+        VideoClip* lastLayerClip;
+        EffectChain masterChain;
+        uint64_t firstFrameTriggerNs;
+        bool firstFrameIsCue;
+    };
+    
     std::map<VideoClip*, std::unique_ptr<PlayingVideo>> playingVideos;
     std::mutex videosMutex;
+    uint64_t nextStartSequence;
+    
+    // Stopped videos are joined and released here, off the MIDI thread and
+    // outside videosMutex, so a stop never waits for a decoder to wind down
+    std::thread reaperThread;
+    std::mutex reaperMutex;
+    std::condition_variable reaperCondition;
+    std::vector<std::unique_ptr<PlayingVideo>> retiredVideos;
+    bool reaperStop;
+    
+    // Stall watchdog. Replaced decoders wait in stalledVideos until their
+    // blocked read returns and the reaper can join them.
+    std::thread watchdogThread;
+    std::mutex watchdogMutex;
+    std::condition_variable watchdogCondition;
+    bool watchdogStop;
+    uint32_t stallBudgetMs;
+    std::vector<std::unique_ptr<PlayingVideo>> stalledVideos;
     
-    cv::Mat compositeFrame;
-    int windowWidth, windowHeight;
-    std::string windowName;
+    std::vector<OutputSurface> outputs;
+    EffectParams masterEffects;
+    FrameRateMode frameRateMode;
+    AudioOutput* audioOutput;
     
+    void attachAudio(PlayingVideo& video);
+    void retire(std::unique_ptr<PlayingVideo> video);
+    void reaperLoop();
+    void watchdogLoop();
+    void replaceStalled(VideoClip* clip, PlayingVideo* stalled, uint64_t detectedNs);
     void playbackLoop(PlayingVideo* video);
-    void createCompositeFrame();
-};
\ No newline at end of file
+    void renderOutput(OutputSurface& output, uint64_t outputNs);
+    static void scaleToOutput(const cv::Mat& frame, cv::Mat& target, const cv::Size& size);
+};
+
+// Plays `path` forward, then reverses it with the seek decoder's reads held,
+// and checks that the watchdog replaces the clip and playback resumes once
+// reads return; false on any failed step
+bool runStallCheck(const std::string& path);
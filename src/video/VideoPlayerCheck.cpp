@@ -0,0 +1,73 @@
+#include "video/VideoPlayer.h"
+#include "video/VideoClip.h"
+#include "video/ClipDecoder.h"
+#include "video/KeyframeIndex.h"
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+constexpr uint32_t kBudgetMs = 200;
+constexpr double kStepSeconds = 5.0; // Longest wait for each step
+constexpr uint64_t kFrames = 10;     // Frames that count as playing
+
+} // namespace
+
+bool runStallCheck(const std::string& path) {
+    std::cout << "🩺 Stall check: " << path << " (budget " << kBudgetMs << " ms)" << std::endl;
+    
+    VideoClip clip(path, 0, 0);
+    clip.setKeyframeIndex(KeyframeIndex::loadOrBuild(path));
+    if (!clip.getKeyframeIndex() || clip.getKeyframeIndex()->getFrameCount() <= 0) {
+        std::cerr << "❌ No keyframe index for " << path << " (a video file is needed)" << std::endl;
+        return false;
+    }
+    
+    VideoPlayer player;
+    player.initialize(std::vector<cv::Size>{cv::Size(640, 360)});
+    player.setStallBudget(kBudgetMs);
+    if (!player.startClip(&clip)) {
+        std::cerr << "❌ Cannot start " << path << std::endl;
+        return false;
+    }
+    
+    // Renders like the show loop while waiting, so outputs release frames
+    ClipStats& stats = clip.getStats();
+    auto waitFor = [&](const std::function<bool()>& done) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(kStepSeconds);
+        while (!done()) {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            player.renderOutputs();
+            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        }
+        return true;
+    };
+    
+    bool forward = waitFor([&]() { return stats.framesDecoded.load() >= kFrames; });
+    
+    // Reverse goes through the seek decoder, whose worker now hangs
+    ClipDecoder::holdReads(true);
+    clip.getPlayback().setSpeed(-1.0f);
+    auto heldAt = std::chrono::steady_clock::now();
+    bool replaced = forward && waitFor([&]() { return stats.decoderStalls.load() >= 1; });
+    auto detectMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - heldAt).count();
+    
+    ClipDecoder::holdReads(false);
+    uint64_t before = stats.framesDecoded.load();
+    bool resumed = replaced && waitFor([&]() { return stats.framesDecoded.load() >= before + kFrames; });
+    
+    player.stopAllClips();
+    player.shutdown();
+    
+    auto mark = [](bool ok) { return ok ? "✓" : "❌"; };
+    std::cout << "  " << mark(forward) << " Forward playback" << std::endl;
+    std::cout << "  " << mark(replaced) << " Held seek decoder replaced";
+    if (replaced) std::cout << " after " << detectMs << " ms";
+    std::cout << std::endl;
+    std::cout << "  " << mark(resumed) << " Reverse playback resumed" << std::endl;
+    bool passed = forward && replaced && resumed;
+    std::cout << "  Result: " << (passed ? "PASS" : "FAIL") << std::endl;
+    return passed;
+}
@@ -0,0 +1,201 @@
+// Test client for the vj-app control socket.
+//
+// Sends single trigger, release, stop, CC or tempo messages, or measures
+// round-trip trigger latency: each probe note is sent and timed until
+// vj-app reports it dispatched. With --midi-port the same probe goes out
+// through a MIDI output port instead (e.g. "Midi Through", with vj-app
+// listening on its input), so both paths are measured with the same
+// return leg.
+//
+// Usage: vj-control [--socket PATH] trigger NOTE [VELOCITY] | release NOTE | stop
+//                   | cc CONTROLLER VALUE | tempo BPM
+//        vj-control [--socket PATH] --bench N [--note NOTE] [--midi-port P]
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <memory>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <RtMidi.h>
+#include "control/ControlProtocol.h"
+
+static uint64_t monotonicNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static bool fillAddress(const std::string& path, sockaddr_un& address) {
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) return false;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    return true;
+}
+
+static bool sendMessage(int fd, const sockaddr_un& server, uint8_t type, int number, int value, uint32_t tempoMilliBpm = 0) {
+    static uint32_t sequence = 0;
+    vjctl::Message message{};
+    message.magic = vjctl::kMagic;
+    message.type = type;
+    message.number = static_cast<uint8_t>(number);
+    message.value = static_cast<uint8_t>(value);
+    message.sequence = ++sequence;
+    message.tempoMilliBpm = tempoMilliBpm;
+    message.sentNs = monotonicNs();
+    return sendto(fd, &message, sizeof(message), 0, reinterpret_cast<const sockaddr*>(&server), sizeof(server)) ==
+           static_cast<ssize_t>(sizeof(message));
+}
+
+// Waits for vj-app to report a message with this status and data byte
+static bool waitDispatched(int fd, uint8_t status, int number, int timeoutMs) {
+    uint64_t deadline = monotonicNs() + static_cast<uint64_t>(timeoutMs) * 1000000ULL;
+    while (true) {
+        uint64_t now = monotonicNs();
+        if (now >= deadline) return false;
+        pollfd entry{fd, POLLIN, 0};
+        if (poll(&entry, 1, static_cast<int>((deadline - now) / 1000000ULL) + 1) <= 0) continue;
+
+        vjctl::Message reply;
+        if (recv(fd, &reply, sizeof(reply), 0) != static_cast<ssize_t>(sizeof(reply))) continue;
+        if (reply.magic == vjctl::kMagic && reply.type == vjctl::kDispatched &&
+            reply.channel == status && reply.number == number) {
+            return true;
+        }
+    }
+}
+
+static void printLatencies(const std::string& label, std::vector<double>& micros, int lost) {
+    if (micros.empty()) {
+        std::cout << label << ": no replies (" << lost << " lost)" << std::endl;
+        return;
+    }
+    std::sort(micros.begin(), micros.end());
+    auto percentile = [&](double p) { return micros[std::min(micros.size() - 1, static_cast<size_t>(p * micros.size()))]; };
+    std::cout << label << ": " << micros.size() << " round trips, p50 " << percentile(0.50) << " µs, p99 "
+              << percentile(0.99) << " µs, max " << micros.back() << " µs";
+    if (lost) std::cout << ", " << lost << " lost";
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string socketPath = "/tmp/vj-control.sock";
+    std::vector<std::string> command;
+    int benchCount = 0;
+    int note = 127; // Pick a note with no clip so probing does not change the picture
+    int midiPort = -1;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (arg == "--bench" && i + 1 < argc) {
+            benchCount = std::atoi(argv[++i]);
+        } else if (arg == "--note" && i + 1 < argc) {
+            note = std::atoi(argv[++i]) & 0x7F;
+        } else if (arg == "--midi-port" && i + 1 < argc) {
+            midiPort = std::atoi(argv[++i]);
+        } else if (arg == "-h" || arg == "--help") {
+            std::cout << "Usage: " << argv[0] << " [--socket PATH] trigger NOTE [VELOCITY] | release NOTE | stop"
+                      << " | cc CONTROLLER VALUE | tempo BPM" << std::endl;
+            std::cout << "       " << argv[0] << " [--socket PATH] --bench N [--note NOTE] [--midi-port P]" << std::endl;
+            return 0;
+        } else {
+            command.push_back(arg);
+        }
+    }
+
+    sockaddr_un server;
+    if (!fillAddress(socketPath, server)) {
+        std::cerr << "Socket path too long: " << socketPath << std::endl;
+        return 1;
+    }
+    int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        std::cerr << "Cannot create socket: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    if (benchCount <= 0) {
+        auto arg = [&](size_t index, int fallback) { return index < command.size() ? std::atoi(command[index].c_str()) : fallback; };
+        std::string name = command.empty() ? "" : command[0];
+        bool sent;
+        if (name == "trigger" && command.size() >= 2) sent = sendMessage(fd, server, vjctl::kTrigger, arg(1, 0), arg(2, 127));
+        else if (name == "release" && command.size() >= 2) sent = sendMessage(fd, server, vjctl::kRelease, arg(1, 0), 0);
+        else if (name == "stop") sent = sendMessage(fd, server, vjctl::kStop, 0, 0);
+        else if (name == "cc" && command.size() >= 3) sent = sendMessage(fd, server, vjctl::kControl, arg(1, 0), arg(2, 0));
+        else if (name == "tempo" && command.size() >= 2) {
+            sent = sendMessage(fd, server, vjctl::kTempo, 0, 0, static_cast<uint32_t>(std::atof(command[1].c_str()) * 1000.0));
+        } else {
+            std::cerr << "Unknown command (see --help)" << std::endl;
+            return 1;
+        }
+        if (!sent) {
+            std::cerr << "Cannot send to " << socketPath << ": " << std::strerror(errno) << " (is vj-app running with --control-socket?)" << std::endl;
+            return 1;
+        }
+        close(fd);
+        return 0;
+    }
+
+    // Replies need an address to come back to
+    std::string replyPath = "/tmp/vj-control-" + std::to_string(getpid()) + ".sock";
+    sockaddr_un local;
+    fillAddress(replyPath, local);
+    unlink(replyPath.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0 ||
+        !sendMessage(fd, server, vjctl::kSubscribe, 0, 0)) {
+        std::cerr << "Cannot subscribe at " << socketPath << ": " << std::strerror(errno) << std::endl;
+        unlink(replyPath.c_str());
+        return 1;
+    }
+
+    std::unique_ptr<RtMidiOut> midiOut;
+    if (midiPort >= 0) {
+        try {
+            midiOut = std::make_unique<RtMidiOut>();
+            midiOut->openPort(static_cast<unsigned>(midiPort));
+        } catch (RtMidiError& error) {
+            std::cerr << "MIDI Error: " << error.getMessage() << std::endl;
+            unlink(replyPath.c_str());
+            return 1;
+        }
+    }
+
+    std::vector<double> socketMicros, midiMicros;
+    int socketLost = 0, midiLost = 0;
+    for (int i = 0; i < benchCount; i++) {
+        uint64_t start = monotonicNs();
+        sendMessage(fd, server, vjctl::kTrigger, note, 1);
+        if (waitDispatched(fd, 0x90, note, 1000)) socketMicros.push_back((monotonicNs() - start) / 1000.0);
+        else socketLost++;
+        sendMessage(fd, server, vjctl::kRelease, note, 0);
+        waitDispatched(fd, 0x80, note, 1000);
+
+        if (midiOut) {
+            std::vector<unsigned char> on = {0x90, static_cast<unsigned char>(note), 1};
+            std::vector<unsigned char> off = {0x80, static_cast<unsigned char>(note), 0};
+            start = monotonicNs();
+            midiOut->sendMessage(&on);
+            if (waitDispatched(fd, 0x90, note, 1000)) midiMicros.push_back((monotonicNs() - start) / 1000.0);
+            else midiLost++;
+            midiOut->sendMessage(&off);
+            waitDispatched(fd, 0x80, note, 1000);
+        }
+        usleep(2000); // Keep probes apart so each one sees an idle path
+    }
+
+    printLatencies("control socket", socketMicros, socketLost);
+    if (midiOut) {
+        printLatencies("MIDI port " + std::to_string(midiPort), midiMicros, midiLost);
+    }
+    close(fd);
+    unlink(replyPath.c_str());
+    return 0;
+}
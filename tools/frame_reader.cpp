@@ -0,0 +1,156 @@
+// Reference reader for the vj-app shared-memory frame ring.
+//
+// Attaches read-only, follows the newest frame, and reports frame rate,
+// frames missed and publish-to-read latency. Optionally saves one frame as
+// a PPM so the pixels can be checked by eye.
+//
+// Usage: vj-frame-reader [name] [--frames N] [--save frame.ppm]
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <cerrno>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "output/SharedFrameFormat.h"
+
+static uint64_t monotonicNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static void savePpm(const std::string& path, const uint8_t* bgr, uint32_t width, uint32_t height, uint32_t stride) {
+    std::ofstream out(path, std::ios::binary);
+    out << "P6\n" << width << " " << height << "\n255\n";
+    std::vector<uint8_t> row(width * 3);
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t* src = bgr + static_cast<size_t>(stride) * y;
+        for (uint32_t x = 0; x < width; x++) {
+            row[x * 3 + 0] = src[x * 3 + 2];
+            row[x * 3 + 1] = src[x * 3 + 1];
+            row[x * 3 + 2] = src[x * 3 + 0];
+        }
+        out.write(reinterpret_cast<const char*>(row.data()), row.size());
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string name = "/vj-output";
+    std::string savePath;
+    long maxFrames = -1;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--frames" && i + 1 < argc) {
+            maxFrames = std::atol(argv[++i]);
+        } else if (arg == "--save" && i + 1 < argc) {
+            savePath = argv[++i];
+        } else if (arg == "-h" || arg == "--help") {
+            std::cout << "Usage: " << argv[0] << " [name] [--frames N] [--save frame.ppm]" << std::endl;
+            return 0;
+        } else {
+            name = (arg[0] == '/') ? arg : "/" + arg;
+        }
+    }
+    
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        std::cerr << "Cannot open " << name << ": " << std::strerror(errno) << " (is vj-app running with --shm?)" << std::endl;
+        return 1;
+    }
+    
+    struct stat info;
+    fstat(fd, &info);
+    size_t size = static_cast<size_t>(info.st_size);
+    void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED || size < sizeof(vjshm::RingHeader)) {
+        std::cerr << "Cannot map " << name << std::endl;
+        return 1;
+    }
+    
+    const uint8_t* mapping = static_cast<const uint8_t*>(address);
+    auto* header = reinterpret_cast<const vjshm::RingHeader*>(mapping);
+    
+    while (header->magic.load(std::memory_order_acquire) != vjshm::kMagic) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (header->version != vjshm::kVersion || header->format != vjshm::kFormatBGR24) {
+        std::cerr << "Unsupported ring version/format" << std::endl;
+        return 1;
+    }
+    
+    std::cout << "Attached to " << name << ": " << header->width << "x" << header->height
+              << " BGR, " << header->slotCount << " slots" << std::endl;
+    
+    uint64_t lastFrame = 0;
+    uint64_t framesRead = 0, framesMissed = 0, tornReads = 0;
+    uint64_t latencyTotalNs = 0, latencyMaxNs = 0;
+    uint64_t windowStart = monotonicNs();
+    uint64_t windowFrames = 0;
+    
+    while (maxFrames < 0 || static_cast<long>(framesRead) < maxFrames) {
+        uint64_t latest = header->latestFrame.load(std::memory_order_acquire);
+        if (latest == 0 || latest == lastFrame) {
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+            continue;
+        }
+        
+        const uint8_t* slotBase = mapping + header->dataOffset + header->slotSize * (latest % header->slotCount);
+        auto* slot = reinterpret_cast<const vjshm::SlotHeader*>(slotBase);
+        const uint8_t* pixels = slotBase + vjshm::slotPixelOffset();
+        
+        uint64_t before = slot->sequence.load(std::memory_order_acquire);
+        if (before & 1) continue; // Writer is mid-copy; try again
+        
+        // Zero-copy consumers would process `pixels` in place here
+        uint64_t timestampNs = slot->timestampNs;
+        bool saveThis = !savePath.empty() && framesRead == 0;
+        std::vector<uint8_t> copy;
+        if (saveThis) {
+            copy.assign(pixels, pixels + static_cast<size_t>(header->stride) * header->height);
+        }
+        
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->sequence.load(std::memory_order_relaxed) != before) {
+            tornReads++; // Overwritten while reading; the frame is discarded
+            continue;
+        }
+        
+        uint64_t latencyNs = monotonicNs() - timestampNs;
+        latencyTotalNs += latencyNs;
+        if (latencyNs > latencyMaxNs) latencyMaxNs = latencyNs;
+        
+        if (lastFrame != 0 && latest > lastFrame + 1) {
+            framesMissed += latest - lastFrame - 1;
+        }
+        lastFrame = latest;
+        framesRead++;
+        windowFrames++;
+        
+        if (saveThis) {
+            savePpm(savePath, copy.data(), header->width, header->height, header->stride);
+            std::cout << "Saved frame " << latest << " to " << savePath << std::endl;
+        }
+        
+        uint64_t now = monotonicNs();
+        if (now - windowStart >= 1000000000ULL) {
+            double seconds = (now - windowStart) / 1e9;
+            std::cout << "frame " << latest << "  " << windowFrames / seconds << " fps"
+                      << "  missed " << framesMissed << "  torn " << tornReads
+                      << "  latency avg " << (latencyTotalNs / framesRead) / 1000.0 << " µs"
+                      << " max " << latencyMaxNs / 1000.0 << " µs" << std::endl;
+            windowStart = now;
+            windowFrames = 0;
+        }
+    }
+    
+    munmap(address, size);
+    return 0;
+}